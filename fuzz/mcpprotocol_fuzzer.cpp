@@ -0,0 +1,131 @@
+// libFuzzer target for the JSON-RPC framing, decoding and dispatch path of MCPServer.
+//
+// The input is treated as raw bytes arriving on a client socket. It is cut
+// into reads of varying size so message reassembly across reads is covered,
+// and handed to a real MCPServer through receive(). Requests go through the
+// real scheduler, single-flight sharing, job registry and executeMethod();
+// only the IDE-facing components behind them are mocks (mockbackend.cpp).
+//
+// Every input gets a new server, and with it new mocks, so jobs, timers,
+// queues and single-flight entries never carry over: a crash reproduces
+// from the one input that caused it.
+
+#include "mcpserver.h"
+
+#include <QCoreApplication>
+#include <QJsonDocument>
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+
+using namespace Qt_MCP_Plugin::Internal;
+
+namespace {
+
+// A connected client socket that keeps what the server writes to it
+class FuzzSocket : public QTcpSocket
+{
+public:
+    FuzzSocket()
+    {
+        setSocketState(QAbstractSocket::ConnectedState);
+        setOpenMode(QIODevice::ReadWrite);
+    }
+
+    // Reports the client as gone; the server then deletes the socket
+    void hangUp()
+    {
+        setSocketState(QAbstractSocket::UnconnectedState);
+        emit disconnected();
+    }
+
+    QByteArray written;
+
+protected:
+    qint64 writeData(const char *data, qint64 size) override
+    {
+        written.append(data, size);
+        return size;
+    }
+};
+
+// The application lives for the whole run, servers only for one input
+void ensureApplication()
+{
+    static int argc = 1;
+    static char name[] = "mcpprotocol_fuzzer";
+    static char *argv[] = {name, nullptr};
+    static QCoreApplication app(argc, argv);
+}
+
+// Queued responses, deferred jobs and mock completions all run from the event loop
+void settle()
+{
+    for (int pass = 0; pass < 4; ++pass) {
+        QCoreApplication::processEvents();
+    }
+}
+
+// Every response and notification must be a single well-formed line
+void checkOutput(const QByteArray &written)
+{
+    if (!written.isEmpty() && !written.endsWith('\n')) {
+        abort();
+    }
+
+    for (const QByteArray &line : written.split('\n')) {
+        if (line.isEmpty()) {
+            continue;
+        }
+        QJsonParseError error;
+        const QJsonDocument doc = QJsonDocument::fromJson(line, &error);
+        if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+            abort();
+        }
+
+        // Single-flight responses must match the regular encoding exactly
+        const QJsonObject message = doc.object();
+        if (message.contains("result")) {
+            const QJsonValue result = message.value("result");
+            const QJsonValue id = message.value("id");
+            if (MCPProtocol::withId(MCPProtocol::encodeSharedResult(result), id)
+                != MCPProtocol::encodeMessage(MCPProtocol::successResponse(result, id))) {
+                abort();
+            }
+        }
+    }
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    if (size == 0) {
+        return 0;
+    }
+
+    ensureApplication();
+    auto mcpServer = std::make_unique<MCPServer>();
+    FuzzSocket *socket = new FuzzSocket;
+    mcpServer->attachClient(socket);
+
+    // The first byte also picks the size of each simulated socket read, so
+    // corpus entries stay plain newline-delimited requests
+    const qsizetype chunkSize = 1 + data[0];
+    const QByteArray input = QByteArray::fromRawData(reinterpret_cast<const char *>(data), qsizetype(size));
+    for (qsizetype offset = 0; offset < input.size(); offset += chunkSize) {
+        mcpServer->receive(socket, input.mid(offset, chunkSize));
+        settle();
+    }
+    settle();
+
+    checkOutput(socket->written);
+
+    // Hang up first: with no client left, stop() in the destructor has no
+    // socket to wait for. Deleting the server drops its pending events.
+    socket->hangUp();
+    mcpServer.reset();
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    return 0;
+}
@@ -0,0 +1,826 @@
+// Stand-ins for the IDE-facing components of MCPServer, for the fuzz target.
+//
+// The fuzz target links the real mcpserver.cpp, mcpscheduler.cpp, mcpjobs.cpp
+// and mcpprotocol.cpp. Everything MCPServer talks to that needs a running
+// Qt Creator is defined here instead, against the real headers, so the
+// dispatcher, scheduler, single-flight and job registry code runs unchanged.
+// The mocks answer with canned values shaped like the real ones and finish
+// asynchronous work from the event loop, the way the real components do.
+
+#include "mcpactions.h"
+#include "mcpbreakpoints.h"
+#include "mcpbuildhistory.h"
+#include "mcpbuildmatrix.h"
+#include "mcpcommands.h"
+#include "mcpdebugger.h"
+#include "mcpdiagnostics.h"
+#include "mcpdocuments.h"
+#include "mcpfileindex.h"
+#include "mcpkits.h"
+#include "mcpparsetracker.h"
+#include "mcpprotocol.h"
+#include "mcpruns.h"
+#include "mcpsymbols.h"
+#include "mcptextsearch.h"
+
+#include <QTimer>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+namespace {
+
+const QString MockProject = "MockProject";
+const QString MockFile = "/mock/project/main.cpp";
+
+QJsonObject mockMatch(const QString &text)
+{
+    QJsonObject match;
+    match["file"] = MockFile;
+    match["line"] = 1;
+    match["column"] = 0;
+    match["text"] = text;
+    return match;
+}
+
+QJsonObject countReport(int count)
+{
+    QJsonObject report;
+    report["count"] = count;
+    report["truncated"] = false;
+    return report;
+}
+
+} // namespace
+
+// MCPCommands
+
+MCPCommands::MCPCommands(QObject *parent)
+    : QObject(parent)
+    , m_sessionLoadResult(false)
+    , m_issuesManager(nullptr)
+{
+}
+
+bool MCPCommands::build()
+{
+    if (m_buildRunning) {
+        return false;
+    }
+    m_buildRunning = true;
+    emit buildStarted(MockProject);
+    QTimer::singleShot(0, this, [this] {
+        if (m_buildRunning) {
+            m_buildRunning = false;
+            emit buildFinished(true);
+        }
+    });
+    return true;
+}
+
+QString MCPCommands::debug()
+{
+    return "Debugging started";
+}
+
+QString MCPCommands::stopDebug()
+{
+    return "Debugging stopped";
+}
+
+bool MCPCommands::openFile(const QString &path)
+{
+    return !path.isEmpty();
+}
+
+QJsonArray MCPCommands::openFiles(const QJsonArray &files, bool activateLast)
+{
+    Q_UNUSED(activateLast)
+    QJsonArray result;
+    for (const QJsonValue &file : files) {
+        QJsonObject entry;
+        entry["path"] = file.toObject().value("path").toString();
+        entry["opened"] = !entry.value("path").toString().isEmpty();
+        result.append(entry);
+    }
+    return result;
+}
+
+QStringList MCPCommands::listProjects()
+{
+    return {MockProject};
+}
+
+QStringList MCPCommands::listBuildConfigs()
+{
+    return {"Debug", "Release"};
+}
+
+bool MCPCommands::switchToBuildConfig(const QString &name)
+{
+    return listBuildConfigs().contains(name);
+}
+
+bool MCPCommands::quit()
+{
+    return true;
+}
+
+QString MCPCommands::getVersion()
+{
+    return "mock";
+}
+
+QString MCPCommands::getCurrentProject()
+{
+    return MockProject;
+}
+
+QString MCPCommands::getCurrentBuildConfig()
+{
+    return "Debug";
+}
+
+bool MCPCommands::runProject()
+{
+    return true;
+}
+
+bool MCPCommands::cleanProject()
+{
+    return build();
+}
+
+void MCPCommands::cancelBuild()
+{
+    if (m_buildRunning) {
+        m_buildRunning = false;
+        QTimer::singleShot(0, this, [this] { emit buildFinished(false); });
+    }
+}
+
+bool MCPCommands::compileFile(const QString &path, QString &errorMessage)
+{
+    if (path.isEmpty()) {
+        errorMessage = "No file given";
+        return false;
+    }
+    if (!build()) {
+        errorMessage = "A build is already running";
+        return false;
+    }
+    return true;
+}
+
+bool MCPCommands::buildTarget(const QString &name, QString &errorMessage)
+{
+    return compileFile(name, errorMessage);
+}
+
+QStringList MCPCommands::listOpenFiles()
+{
+    return {MockFile};
+}
+
+QStringList MCPCommands::listSessions()
+{
+    return {"default"};
+}
+
+QString MCPCommands::getCurrentSession()
+{
+    return "default";
+}
+
+bool MCPCommands::loadSession(const QString &sessionName)
+{
+    if (sessionName.isEmpty()) {
+        return false;
+    }
+    m_sessionLoadPending = true;
+    QMetaObject::invokeMethod(this, [this, sessionName] { handleSessionLoadRequest(sessionName); },
+                              Qt::QueuedConnection);
+    return true;
+}
+
+void MCPCommands::handleSessionLoadRequest(const QString &sessionName)
+{
+    m_sessionLoadPending = false;
+    emit sessionLoaded(sessionName);
+    emit sessionLoadFinished(true);
+}
+
+bool MCPCommands::saveSession()
+{
+    return true;
+}
+
+bool MCPCommands::isSessionLoadPending() const
+{
+    return m_sessionLoadPending;
+}
+
+QStringList MCPCommands::listIssues()
+{
+    return {"main.cpp:1: warning: unused variable"};
+}
+
+QString MCPCommands::getMethodMetadata()
+{
+    return "=== METHOD METADATA ===";
+}
+
+QString MCPCommands::setMethodMetadata(const QString &method, int timeoutSeconds)
+{
+    if (method.isEmpty() || timeoutSeconds < 0) {
+        return "ERROR: invalid metadata";
+    }
+    m_methodTimeouts.insert(method, timeoutSeconds);
+    m_timeoutOverrides.insert(method);
+    return "OK";
+}
+
+int MCPCommands::getMethodTimeout(const QString &method) const
+{
+    return m_methodTimeouts.value(method, -1);
+}
+
+QJsonObject MCPCommands::getDurationPrediction(const QString &method, const QString &project,
+                                               const QString &buildConfig) const
+{
+    Q_UNUSED(method)
+    QJsonObject result;
+    result["samples"] = 0;
+    result["project"] = project.isEmpty() ? MockProject : project;
+    result["buildConfig"] = buildConfig;
+    return result;
+}
+
+// MCPBuildHistory
+
+MCPBuildHistory::MCPBuildHistory(QObject *parent)
+    : QObject(parent)
+{
+}
+
+MCPBuildHistory::~MCPBuildHistory() = default;
+
+QJsonArray MCPBuildHistory::history(const QString &project, const QString &buildConfig, int limit) const
+{
+    Q_UNUSED(buildConfig)
+    QJsonArray result;
+    if (limit > 0) {
+        QJsonObject build;
+        build["id"] = 1;
+        build["project"] = project.isEmpty() ? MockProject : project;
+        build["success"] = true;
+        build["durationMs"] = 1000;
+        result.append(build);
+    }
+    return result;
+}
+
+QJsonObject MCPBuildHistory::compare(const QJsonObject &params, QString &errorMessage) const
+{
+    if (!params.contains("buildId")) {
+        errorMessage = "No builds recorded";
+        return QJsonObject();
+    }
+    QJsonObject result;
+    result["buildId"] = params.value("buildId");
+    result["steps"] = QJsonArray();
+    return result;
+}
+
+// MCPBuildMatrix
+
+MCPBuildMatrix::MCPBuildMatrix(MCPParseTracker *parseTracker, QObject *parent)
+    : QObject(parent)
+    , m_parseTracker(parseTracker)
+{
+}
+
+bool MCPBuildMatrix::start(const QStringList &configs, QString &errorMessage)
+{
+    if (m_running) {
+        errorMessage = "A build matrix is already running";
+        return false;
+    }
+    if (configs.isEmpty()) {
+        errorMessage = "No build configurations given";
+        return false;
+    }
+    m_running = true;
+    m_cancelled = false;
+    QTimer::singleShot(0, this, [this, configs] {
+        if (!m_running) {
+            return;
+        }
+        for (const QString &config : configs) {
+            QJsonObject entry;
+            entry["config"] = config;
+            entry["state"] = m_cancelled ? "cancelled" : "succeeded";
+            emit progress(entry);
+        }
+        m_running = false;
+        emit finished(!m_cancelled, report());
+    });
+    return true;
+}
+
+void MCPBuildMatrix::cancel()
+{
+    m_cancelled = true;
+}
+
+bool MCPBuildMatrix::isRunning() const
+{
+    return m_running;
+}
+
+QJsonObject MCPBuildMatrix::report() const
+{
+    QJsonObject report;
+    report["cancelled"] = m_cancelled;
+    return report;
+}
+
+// MCPParseTracker
+
+MCPParseTracker::MCPParseTracker(QObject *parent)
+    : QObject(parent)
+{
+}
+
+bool MCPParseTracker::isParsing() const
+{
+    return false;
+}
+
+quint64 MCPParseTracker::generation() const
+{
+    return m_generation;
+}
+
+QJsonObject MCPParseTracker::state() const
+{
+    QJsonObject state;
+    state["parsing"] = false;
+    state["generation"] = qint64(m_generation);
+    return state;
+}
+
+// MCPRunRegistry
+
+MCPRunRegistry::MCPRunRegistry(QObject *parent)
+    : QObject(parent)
+{
+}
+
+int MCPRunRegistry::start(const std::optional<QStringList> &arguments, const QJsonObject &environment,
+                          const QString &workingDirectory, QString &errorMessage)
+{
+    Q_UNUSED(arguments)
+    Q_UNUSED(environment)
+    if (workingDirectory.contains('\n')) {
+        errorMessage = "Invalid working directory";
+        return -1;
+    }
+
+    Run run;
+    run.id = m_nextRunId++;
+    run.name = MockProject;
+    run.mode = "run";
+    run.elapsed.start();
+    m_runs.insert(run.id, run);
+
+    // Like the real registry, only finished runs are dropped
+    for (auto it = m_runs.begin(); m_runs.size() > MaxFinishedRuns && it != m_runs.end();) {
+        it = it->running ? std::next(it) : m_runs.erase(it);
+    }
+
+    const int runId = run.id;
+    QTimer::singleShot(0, this, [this, runId] {
+        QString ignored;
+        emit runStarted(runId, status(runId, ignored));
+        auto it = m_runs.find(runId);
+        if (it != m_runs.end() && it->running) {
+            it->running = false;
+            it->exitCode = 0;
+            it->durationMs = it->elapsed.elapsed();
+            emit runExited(runId, status(runId, ignored));
+        }
+    });
+    return runId;
+}
+
+bool MCPRunRegistry::stop(int runId)
+{
+    auto it = m_runs.find(runId);
+    if (it == m_runs.end() || !it->running) {
+        return false;
+    }
+    it->running = false;
+    it->exitCode = -1;
+    QTimer::singleShot(0, this, [this, runId] {
+        QString ignored;
+        emit runExited(runId, status(runId, ignored));
+    });
+    return true;
+}
+
+QString MCPRunRegistry::collectOutput(int runId, bool &truncated) const
+{
+    truncated = false;
+    return m_runs.contains(runId) ? QString("Hello from run %1\n").arg(runId) : QString();
+}
+
+QJsonObject MCPRunRegistry::readOutput(int runId, qint64 sinceSeq, QString &errorMessage) const
+{
+    if (!m_runs.contains(runId)) {
+        errorMessage = QString("Unknown run: %1").arg(runId);
+        return QJsonObject();
+    }
+    QJsonObject result;
+    result["runId"] = runId;
+    result["nextSeq"] = qMax<qint64>(sinceSeq, 1);
+    result["chunks"] = QJsonArray();
+    return result;
+}
+
+QJsonObject MCPRunRegistry::status(int runId, QString &errorMessage) const
+{
+    const auto it = m_runs.constFind(runId);
+    if (it == m_runs.constEnd()) {
+        errorMessage = QString("Unknown run: %1").arg(runId);
+        return QJsonObject();
+    }
+    QJsonObject status;
+    status["runId"] = it->id;
+    status["name"] = it->name;
+    status["running"] = it->running;
+    status["exitCode"] = it->exitCode;
+    return status;
+}
+
+QJsonArray MCPRunRegistry::runningApplications() const
+{
+    QJsonArray result;
+    for (const Run &run : m_runs) {
+        if (run.running) {
+            QString ignored;
+            result.append(status(run.id, ignored));
+        }
+    }
+    return result;
+}
+
+// MCPActionIndex
+
+MCPActionIndex::MCPActionIndex(QObject *parent)
+    : QObject(parent)
+{
+}
+
+MCPActionIndex::~MCPActionIndex() = default;
+
+MCPActionIndex *MCPActionIndex::instance()
+{
+    static MCPActionIndex index;
+    return &index;
+}
+
+QJsonArray MCPActionIndex::list(const QString &filter, int limit) const
+{
+    QJsonArray result;
+    const QString id = "QtCreator.Build";
+    if (limit > 0 && id.contains(filter, Qt::CaseInsensitive)) {
+        QJsonObject action;
+        action["id"] = id;
+        action["text"] = "Build";
+        result.append(action);
+    }
+    return result;
+}
+
+bool MCPActionIndex::trigger(const QString &id, QString &errorMessage)
+{
+    if (id != "QtCreator.Build") {
+        errorMessage = QString("Unknown action: %1").arg(id);
+        return false;
+    }
+    return true;
+}
+
+int MCPActionIndex::size() const
+{
+    return 1;
+}
+
+// MCPDebuggerInspector
+
+MCPDebuggerInspector::MCPDebuggerInspector(QObject *parent)
+    : QObject(parent)
+    , m_settleTimerP(nullptr)
+{
+}
+
+QJsonObject MCPDebuggerInspector::snapshot(const Limits &limits) const
+{
+    QJsonObject snapshot;
+    snapshot["paused"] = false;
+    snapshot["maxFrames"] = limits.maxFrames;
+    return snapshot;
+}
+
+// MCPBreakpoints
+
+MCPBreakpoints::MCPBreakpoints(QObject *parent)
+    : QObject(parent)
+{
+}
+
+QJsonArray MCPBreakpoints::list(QString &errorMessage) const
+{
+    Q_UNUSED(errorMessage)
+    return QJsonArray();
+}
+
+QJsonObject MCPBreakpoints::set(const QJsonArray &items, QString &errorMessage)
+{
+    if (items.isEmpty()) {
+        errorMessage = "No breakpoints given";
+        return QJsonObject();
+    }
+    QJsonObject result;
+    result["set"] = items.size();
+    return result;
+}
+
+QJsonObject MCPBreakpoints::clear(const QJsonObject &filter, QString &errorMessage)
+{
+    Q_UNUSED(filter)
+    Q_UNUSED(errorMessage)
+    QJsonObject result;
+    result["removed"] = 0;
+    return result;
+}
+
+// MCPDocuments
+
+MCPDocuments::MCPDocuments(QObject *parent)
+    : QObject(parent)
+{
+}
+
+QJsonObject MCPDocuments::read(const QJsonObject &params, QString &errorMessage)
+{
+    const QString path = params.value("path").toString();
+    if (path.isEmpty()) {
+        errorMessage = "No path given";
+        return QJsonObject();
+    }
+    QJsonObject result;
+    result["path"] = path;
+    result["text"] = "int main() {}\n";
+    result["hash"] = "0";
+    return result;
+}
+
+QJsonObject MCPDocuments::applyEdits(const QJsonObject &params, QString &errorMessage, int &errorCode)
+{
+    const QJsonArray edits = params.value("edits").toArray();
+    if (edits.isEmpty()) {
+        errorCode = MCPProtocol::InvalidParams;
+        errorMessage = "No edits given";
+        return QJsonObject();
+    }
+    if (params.contains("expectedHash") && params.value("expectedHash").toString() != "0") {
+        errorCode = MCPProtocol::ContentModified;
+        errorMessage = "Conflict: content changed since it was read";
+        return QJsonObject();
+    }
+    QJsonObject result;
+    result["files"] = QJsonArray();
+    return result;
+}
+
+// MCPFileIndex
+
+MCPFileIndex::MCPFileIndex(QObject *parent)
+    : QObject(parent)
+    , m_refreshTimerP(nullptr)
+{
+}
+
+QJsonArray MCPFileIndex::find(const QString &pattern, bool fuzzy, int limit, const QString &project) const
+{
+    Q_UNUSED(fuzzy)
+    QJsonArray result;
+    if (limit > 0 && !pattern.isEmpty()) {
+        QJsonObject match;
+        match["path"] = MockFile;
+        match["project"] = project.isEmpty() ? MockProject : project;
+        result.append(match);
+    }
+    return result;
+}
+
+// MCPSymbolSearch
+
+MCPSymbolSearch::MCPSymbolSearch(QObject *parent)
+    : QObject(parent)
+{
+}
+
+MCPSymbolSearch::~MCPSymbolSearch() = default;
+
+int MCPSymbolSearch::findSymbol(const QString &name, const QString &kind, int limit, QString &errorMessage)
+{
+    Q_UNUSED(kind)
+    if (name.isEmpty()) {
+        errorMessage = "No symbol name given";
+        return -1;
+    }
+    const int searchId = m_nextId++;
+    m_searches[searchId].limit = limit;
+    QTimer::singleShot(0, this, [this, searchId, name] {
+        if (!m_searches.remove(searchId)) {
+            return;
+        }
+        emit results(searchId, QJsonArray{mockMatch(name)});
+        emit finished(searchId, true, countReport(1));
+    });
+    return searchId;
+}
+
+int MCPSymbolSearch::findReferences(const QString &path, int line, int column, int limit, QString &errorMessage)
+{
+    Q_UNUSED(column)
+    if (path.isEmpty() || line < 1) {
+        errorMessage = "No symbol at this position";
+        return -1;
+    }
+    return findSymbol(path, QString(), limit, errorMessage);
+}
+
+void MCPSymbolSearch::cancel(int searchId)
+{
+    if (m_searches.remove(searchId)) {
+        emit finished(searchId, false, countReport(0));
+    }
+}
+
+// MCPTextSearch
+
+MCPTextSearch::MCPTextSearch(MCPFileIndex *fileIndex, QObject *parent)
+    : QObject(parent)
+    , m_fileIndex(fileIndex)
+{
+}
+
+MCPTextSearch::~MCPTextSearch() = default;
+
+int MCPTextSearch::start(const Query &query, QString &errorMessage)
+{
+    if (query.pattern.isEmpty()) {
+        errorMessage = "No pattern given";
+        return -1;
+    }
+    const int searchId = m_nextId++;
+    m_searches[searchId].query = query;
+    QTimer::singleShot(0, this, [this, searchId] {
+        auto it = m_searches.find(searchId);
+        if (it == m_searches.end()) {
+            return;
+        }
+        const QString pattern = it->query.pattern;
+        m_searches.erase(it);
+        emit results(searchId, QJsonArray{mockMatch(pattern)});
+        QJsonObject report = countReport(1);
+        report["files"] = 1;
+        emit finished(searchId, true, report);
+    });
+    return searchId;
+}
+
+void MCPTextSearch::cancel(int searchId)
+{
+    if (m_searches.remove(searchId)) {
+        emit finished(searchId, false, countReport(0));
+    }
+}
+
+// MCPDiagnostics
+
+MCPDiagnostics::MCPDiagnostics(QObject *parent)
+    : QObject(parent)
+    , m_pollTimerP(nullptr)
+{
+}
+
+QJsonArray MCPDiagnostics::diagnostics(const QStringList &paths)
+{
+    QJsonArray result;
+    for (const QString &path : paths.isEmpty() ? QStringList{MockFile} : paths) {
+        QJsonObject entry;
+        entry["path"] = path;
+        entry["errors"] = 0;
+        entry["warnings"] = 0;
+        entry["diagnostics"] = QJsonArray();
+        entry["followed"] = true;
+        result.append(entry);
+    }
+    return result;
+}
+
+void MCPDiagnostics::setActive(bool active)
+{
+    Q_UNUSED(active)
+}
+
+// MCPKits
+
+MCPKits::MCPKits(MCPParseTracker *parseTracker, QObject *parent)
+    : QObject(parent)
+    , m_parseTracker(parseTracker)
+{
+}
+
+QJsonArray MCPKits::kits() const
+{
+    QJsonObject kit;
+    kit["name"] = "Mock Kit";
+    kit["id"] = "mock.kit";
+    kit["valid"] = true;
+    kit["default"] = true;
+    return QJsonArray{kit};
+}
+
+QJsonArray MCPKits::targets(const QString &projectName, QString &errorMessage) const
+{
+    if (!projectName.isEmpty() && projectName != MockProject) {
+        errorMessage = QString("Project not found: %1").arg(projectName);
+        return QJsonArray();
+    }
+    QJsonObject target;
+    target["kit"] = "Mock Kit";
+    target["active"] = true;
+    return QJsonArray{target};
+}
+
+bool MCPKits::switchKit(const QString &kit, QString &errorMessage)
+{
+    if (kit != "Mock Kit" && kit != "mock.kit") {
+        errorMessage = QString("Kit not found: %1 (available: Mock Kit)").arg(kit);
+        return false;
+    }
+    return true;
+}
+
+QJsonObject MCPKits::compileFlags(const QString &path, QString &errorMessage)
+{
+    if (path.isEmpty()) {
+        errorMessage = "No file given";
+        return QJsonObject();
+    }
+    QJsonObject entry;
+    entry["directory"] = "/mock/build";
+    entry["file"] = path;
+    entry["arguments"] = QJsonArray{"c++", "-c", path};
+    entry["generation"] = qint64(m_parseTracker->generation());
+    return entry;
+}
+
+int MCPKits::exportDatabase(const QString &projectName, QString &errorMessage)
+{
+    if (targets(projectName, errorMessage).isEmpty()) {
+        return -1;
+    }
+    const int exportId = m_nextExportId++;
+    m_exports[exportId].directory = "/mock/build";
+    QTimer::singleShot(0, this, [this, exportId] {
+        if (!m_exports.remove(exportId)) {
+            return;
+        }
+        QString unused;
+        emit chunk(exportId, QJsonArray{compileFlags(MockFile, unused)});
+        QJsonObject report;
+        report["count"] = 1;
+        report["cached"] = false;
+        emit finished(exportId, true, report);
+    });
+    return exportId;
+}
+
+void MCPKits::cancelExport(int exportId)
+{
+    if (m_exports.remove(exportId)) {
+        QJsonObject report;
+        report["count"] = 0;
+        emit finished(exportId, false, report);
+    }
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
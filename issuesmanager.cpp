@@ -148,6 +148,8 @@ void IssuesManager::connectSignals()
                 this, &IssuesManager::onTaskAdded);
         connect(&hub, &ProjectExplorer::TaskHub::taskRemoved,
                 this, &IssuesManager::onTaskRemoved);
+        connect(&hub, &ProjectExplorer::TaskHub::tasksCleared,
+                this, &IssuesManager::onTasksCleared);
         
         qDebug() << "IssuesManager: Connected to TaskHub signals";
         
@@ -168,6 +170,8 @@ void IssuesManager::onTaskAdded(const ProjectExplorer::Task &task)
 {
     qDebug() << "IssuesManager: Task added:" << task.description();
     m_trackedTasks.append(task);
+    countTask(task, 1);
+    notifyIssuesChanged();
 }
 
 void IssuesManager::onTaskRemoved(const ProjectExplorer::Task &task)
@@ -177,12 +181,43 @@ void IssuesManager::onTaskRemoved(const ProjectExplorer::Task &task)
     // Find and remove the task from our tracked list
     for (int i = 0; i < m_trackedTasks.size(); ++i) {
         if (m_trackedTasks[i].taskId == task.taskId) {
-            m_trackedTasks.removeAt(i);
+            countTask(m_trackedTasks.takeAt(i), -1);
+            notifyIssuesChanged();
             break;
         }
     }
 }
 
+void IssuesManager::onTasksCleared(Utils::Id categoryId)
+{
+    qDebug() << "IssuesManager: Tasks cleared for category:" << categoryId.toString();
+    
+    const qsizetype removed = m_trackedTasks.removeIf([this, categoryId](const ProjectExplorer::Task &task) {
+        if (categoryId.isValid() && task.category != categoryId) {
+            return false;
+        }
+        countTask(task, -1);
+        return true;
+    });
+    if (removed > 0) {
+        notifyIssuesChanged();
+    }
+}
+
+void IssuesManager::countTask(const ProjectExplorer::Task &task, int delta)
+{
+    if (task.type == ProjectExplorer::Task::Error) {
+        m_errorCount += delta;
+    } else if (task.type == ProjectExplorer::Task::Warning) {
+        m_warningCount += delta;
+    }
+}
+
+void IssuesManager::notifyIssuesChanged()
+{
+    emit issuesChanged(m_errorCount, m_warningCount);
+}
+
 void IssuesManager::onTasksChanged()
 {
     qDebug() << "IssuesManager: TaskWindow reports tasks changed";
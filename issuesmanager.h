@@ -38,6 +38,14 @@ public:
      */
     QStringList testTaskAccess() const;
 
+signals:
+    /**
+     * @brief Emitted whenever the set of tracked tasks changes
+     * @param errorCount Number of tracked errors
+     * @param warningCount Number of tracked warnings
+     */
+    void issuesChanged(int errorCount, int warningCount);
+
 private slots:
     /**
      * @brief Handles task added signals from TaskHub
@@ -51,6 +59,12 @@ private slots:
      */
     void onTaskRemoved(const ProjectExplorer::Task &task);
 
+    /**
+     * @brief Handles tasks cleared signals from TaskHub
+     * @param categoryId The category whose tasks were cleared
+     */
+    void onTasksCleared(Utils::Id categoryId);
+
     /**
      * @brief Handles tasks changed signal from TaskWindow
      */
@@ -91,10 +105,23 @@ private:
      */
     void connectSignals();
 
+    /**
+     * @brief Adds a task to the running error and warning counts, or removes it
+     * @param delta 1 for an added task, -1 for a removed one
+     */
+    void countTask(const ProjectExplorer::Task &task, int delta);
+
+    /**
+     * @brief Emits issuesChanged() with the current error and warning counts
+     */
+    void notifyIssuesChanged();
+
     bool m_accessible = false;
     
     // Task tracking
     QList<ProjectExplorer::Task> m_trackedTasks;
+    int m_errorCount = 0;     // errors in m_trackedTasks
+    int m_warningCount = 0;   // warnings in m_trackedTasks
     QObject* m_taskWindow = nullptr;
     bool m_signalsConnected = false;
 };
@@ -0,0 +1,149 @@
+#include "mcpactions.h"
+
+#include <coreplugin/actionmanager/actionmanager.h>
+#include <coreplugin/actionmanager/command.h>
+#include <utils/id.h>
+
+#include <QAction>
+#include <QDebug>
+#include <QJsonObject>
+#include <QTimer>
+
+#include <algorithm>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+static MCPActionIndex *s_instance = nullptr;
+
+MCPActionIndex::MCPActionIndex(QObject *parent)
+    : QObject(parent)
+{
+    s_instance = this;
+
+    Core::ActionManager *actionManager = Core::ActionManager::instance();
+    connect(actionManager, &Core::ActionManager::commandAdded, this, [this](Utils::Id id) {
+        if (Core::Command *command = Core::ActionManager::command(id)) {
+            m_commands.insert(id.toString(), command);
+        }
+    });
+    // Commands can also disappear, which only the full list change reports
+    connect(actionManager, &Core::ActionManager::commandListChanged,
+            this, &MCPActionIndex::scheduleRebuild);
+}
+
+MCPActionIndex::~MCPActionIndex()
+{
+    if (s_instance == this) {
+        s_instance = nullptr;
+    }
+}
+
+MCPActionIndex *MCPActionIndex::instance()
+{
+    return s_instance;
+}
+
+Core::Command *MCPActionIndex::find(const QString &id)
+{
+    if (s_instance) {
+        return s_instance->m_commands.value(id);
+    }
+    return Core::ActionManager::command(Utils::Id::fromString(id));
+}
+
+Core::Command *MCPActionIndex::findFirst(const QStringList &ids, QString *foundId)
+{
+    for (const QString &id : ids) {
+        Core::Command *command = find(id);
+        if (command && command->action()) {
+            if (foundId) {
+                *foundId = id;
+            }
+            return command;
+        }
+    }
+    return nullptr;
+}
+
+void MCPActionIndex::scheduleRebuild()
+{
+    if (m_rebuildScheduled) {
+        return;
+    }
+    m_rebuildScheduled = true;
+    QTimer::singleShot(0, this, &MCPActionIndex::rebuild);
+}
+
+void MCPActionIndex::rebuild()
+{
+    m_rebuildScheduled = false;
+    m_commands.clear();
+    for (Core::Command *command : Core::ActionManager::commands()) {
+        m_commands.insert(command->id().toString(), command);
+    }
+    qDebug() << "Action index holds" << m_commands.size() << "commands";
+}
+
+int MCPActionIndex::size() const
+{
+    return m_commands.size();
+}
+
+QJsonArray MCPActionIndex::list(const QString &filter, int limit) const
+{
+    QStringList ids = m_commands.keys();
+    std::sort(ids.begin(), ids.end());
+
+    QJsonArray result;
+    for (const QString &id : std::as_const(ids)) {
+        Core::Command *command = m_commands.value(id);
+        if (!command || !command->action()) {
+            continue;
+        }
+
+        QAction *action = command->action();
+        const QString text = action->text().remove('&');
+        if (!filter.isEmpty() && !id.contains(filter, Qt::CaseInsensitive)
+            && !text.contains(filter, Qt::CaseInsensitive)) {
+            continue;
+        }
+
+        QJsonObject entry;
+        entry["id"] = id;
+        entry["text"] = text;
+        entry["enabled"] = action->isEnabled();
+        if (action->isCheckable()) {
+            entry["checked"] = action->isChecked();
+        }
+        if (!command->keySequence().isEmpty()) {
+            entry["shortcut"] = command->keySequence().toString(QKeySequence::PortableText);
+        }
+        result.append(entry);
+
+        if (result.size() >= limit) {
+            break;
+        }
+    }
+    return result;
+}
+
+bool MCPActionIndex::trigger(const QString &id, QString &errorMessage)
+{
+    Core::Command *command = m_commands.value(id);
+    if (!command || !command->action()) {
+        errorMessage = QString("Unknown action: %1").arg(id);
+        return false;
+    }
+    if (!command->action()->isEnabled()) {
+        errorMessage = QString("Action is disabled in the current context: %1").arg(id);
+        return false;
+    }
+
+    qDebug() << "Triggering action:" << id;
+    command->action()->trigger();
+    return true;
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
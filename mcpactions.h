@@ -0,0 +1,74 @@
+#ifndef MCPACTIONS_H
+#define MCPACTIONS_H
+
+#include <QObject>
+#include <QPointer>
+#include <QHash>
+#include <QJsonArray>
+#include <QStringList>
+
+namespace Core {
+class Command;
+}
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+/**
+ * @brief Index of all ActionManager commands by id
+ *
+ * The plugin creates one index, fills it in extensionsInitialized() and keeps
+ * it current through ActionManager::commandAdded and commandListChanged, so
+ * looking up a command is a hash lookup instead of a Utils::Id conversion
+ * and an ActionManager query per candidate id.
+ */
+class MCPActionIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MCPActionIndex(QObject *parent = nullptr);
+    ~MCPActionIndex() override;
+
+    /**
+     * @brief The plugin's index, nullptr before the plugin created it
+     */
+    static MCPActionIndex *instance();
+
+    /**
+     * @brief Looks up a command, falling back to ActionManager without an index
+     */
+    static Core::Command *find(const QString &id);
+
+    /**
+     * @brief Returns the first of the candidate ids that has an action
+     * @param foundId Receives the id that was found
+     */
+    static Core::Command *findFirst(const QStringList &ids, QString *foundId = nullptr);
+
+    void rebuild();
+
+    /**
+     * @brief Lists commands whose id or text contains the filter
+     */
+    QJsonArray list(const QString &filter, int limit) const;
+
+    /**
+     * @brief Triggers a command's action
+     * @param errorMessage Set if the command is unknown or disabled
+     */
+    bool trigger(const QString &id, QString &errorMessage);
+
+    int size() const;
+
+private:
+    void scheduleRebuild();
+
+    QHash<QString, QPointer<Core::Command>> m_commands;
+    bool m_rebuildScheduled = false;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPACTIONS_H
@@ -0,0 +1,80 @@
+#include "mcpbreakpointrows.h"
+
+#include <QDir>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+namespace MCPBreakpointRows {
+
+bool matches(const QString &cellPath, const QString &file)
+{
+    if (cellPath.isEmpty()) {
+        return false;
+    }
+
+    const QString cell = QDir::fromNativeSeparators(cellPath);
+    const QString wanted = QDir::fromNativeSeparators(file);
+    return wanted == cell || wanted.endsWith('/' + cell) || cell.endsWith('/' + wanted);
+}
+
+int findRow(const QAbstractItemModel *model, const QModelIndex &root, const QString &file, int line)
+{
+    for (int row = 0; row < model->rowCount(root); ++row) {
+        const QString cellFile = model->index(row, FileColumn, root).data().toString();
+        const int cellLine = model->index(row, LineColumn, root).data().toInt();
+        if (cellLine == line && matches(cellFile, file)) {
+            return row;
+        }
+    }
+    return -1;
+}
+
+QList<int> filterRows(const QAbstractItemModel *model, const QModelIndex &root, const QString &file, int line)
+{
+    QList<int> rows;
+    for (int row = 0; row < model->rowCount(root); ++row) {
+        if (!file.isEmpty() && !matches(model->index(row, FileColumn, root).data().toString(), file)) {
+            continue;
+        }
+        if (line >= 0 && model->index(row, LineColumn, root).data().toInt() != line) {
+            continue;
+        }
+        rows.append(row);
+    }
+    return rows;
+}
+
+QJsonObject breakpoint(const QAbstractItemModel *model, const QModelIndex &root, int row)
+{
+    QJsonObject breakpoint;
+    breakpoint["file"] = model->index(row, FileColumn, root).data().toString();
+    breakpoint["line"] = model->index(row, LineColumn, root).data().toInt();
+    const QString condition = model->index(row, ConditionColumn, root).data().toString();
+    if (!condition.isEmpty()) {
+        breakpoint["condition"] = condition;
+    }
+    const int ignoreCount = model->index(row, IgnoreCountColumn, root).data().toInt();
+    if (ignoreCount > 0) {
+        breakpoint["ignoreCount"] = ignoreCount;
+    }
+    breakpoint["enabled"] = model->index(row, 0, root).data(Qt::CheckStateRole).toInt() != Qt::Unchecked;
+    return breakpoint;
+}
+
+bool hasParameters(const QAbstractItemModel *model, const QModelIndex &root, int row,
+                   const std::optional<QString> &condition, int ignoreCount)
+{
+    if (row < 0 || row >= model->rowCount(root)) {
+        return false;
+    }
+    if (condition && model->index(row, ConditionColumn, root).data().toString() != *condition) {
+        return false;
+    }
+    return ignoreCount < 0 || model->index(row, IgnoreCountColumn, root).data().toInt() == ignoreCount;
+}
+
+} // namespace MCPBreakpointRows
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
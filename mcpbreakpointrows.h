@@ -0,0 +1,68 @@
+#ifndef MCPBREAKPOINTROWS_H
+#define MCPBREAKPOINTROWS_H
+
+#include <QAbstractItemModel>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+
+#include <optional>
+
+// This header only depends on QtCore; MCPBreakpoints uses it to read the
+// debugger's breakpoint model, and the unit tests run it on their own model.
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+namespace MCPBreakpointRows {
+
+// Column order of the debugger's breakpoint model
+enum Column {
+    NumberColumn,
+    FunctionColumn,
+    FileColumn,
+    LineColumn,
+    AddressColumn,
+    ConditionColumn,
+    IgnoreCountColumn,
+    ColumnCount = IgnoreCountColumn + 1
+};
+
+/**
+ * @brief Checks if a file cell refers to file
+ *
+ * The view may show a shortened path, so paths are compared from the end.
+ */
+bool matches(const QString &cellPath, const QString &file);
+
+/**
+ * @brief Returns the row of the breakpoint at file and line, or -1
+ */
+int findRow(const QAbstractItemModel *model, const QModelIndex &root, const QString &file, int line);
+
+/**
+ * @brief Returns the rows matching a clearBreakpoints filter
+ * @param file Empty matches any file
+ * @param line Negative matches any line
+ */
+QList<int> filterRows(const QAbstractItemModel *model, const QModelIndex &root, const QString &file, int line);
+
+/**
+ * @brief Returns a listBreakpoints entry for one row
+ */
+QJsonObject breakpoint(const QAbstractItemModel *model, const QModelIndex &root, int row);
+
+/**
+ * @brief Checks that a row has the condition and ignore count a request asked for
+ * @param condition Not checked if unset
+ * @param ignoreCount Not checked if negative
+ */
+bool hasParameters(const QAbstractItemModel *model, const QModelIndex &root, int row,
+                   const std::optional<QString> &condition, int ignoreCount);
+
+} // namespace MCPBreakpointRows
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPBREAKPOINTROWS_H
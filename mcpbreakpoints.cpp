@@ -0,0 +1,295 @@
+#include "mcpbreakpoints.h"
+#include "mcpbreakpointrows.h"
+#include "mcpdebugger.h"
+#include "mcpactions.h"
+
+#include <coreplugin/actionmanager/command.h>
+#include <coreplugin/editormanager/editormanager.h>
+#include <coreplugin/editormanager/ieditor.h>
+#include <utils/basetreeview.h>
+#include <utils/filepath.h>
+#include <utils/link.h>
+
+#include <QAbstractItemView>
+#include <QAction>
+#include <QApplication>
+#include <QCoreApplication>
+#include <QDialog>
+#include <QLabel>
+#include <QLineEdit>
+#include <QMouseEvent>
+#include <QPointer>
+#include <QSpinBox>
+#include <QTimer>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+namespace {
+
+// A dialog label as the Debugger plugin shows it in the current UI language
+QString debuggerLabel(const char *sourceText)
+{
+    return QCoreApplication::translate("QtC::Debugger", sourceText).remove('&');
+}
+
+} // namespace
+
+MCPBreakpoints::MCPBreakpoints(QObject *parent)
+    : QObject(parent)
+{
+}
+
+QAbstractItemView *MCPBreakpoints::view(QString &errorMessage) const
+{
+    QAbstractItemView *breakView = findDebuggerView("Break");
+    if (!breakView) {
+        errorMessage = "Debugger breakpoint view not found (is the Debugger plugin loaded?)";
+        return nullptr;
+    }
+    if (breakView->model()->columnCount(breakView->rootIndex()) < MCPBreakpointRows::ColumnCount) {
+        errorMessage = QString("Debugger breakpoint view has %1 columns, expected at least %2")
+                           .arg(breakView->model()->columnCount(breakView->rootIndex()))
+                           .arg(int(MCPBreakpointRows::ColumnCount));
+        return nullptr;
+    }
+    return breakView;
+}
+
+void MCPBreakpoints::toggle(Core::Command *command, const Utils::FilePath &file, int line)
+{
+    Core::EditorManager::openEditorAt(Utils::Link(file, line, 0));
+    command->action()->trigger();
+}
+
+QJsonArray MCPBreakpoints::list(QString &errorMessage) const
+{
+    QJsonArray breakpoints;
+    QAbstractItemView *breakView = view(errorMessage);
+    if (!breakView) {
+        return breakpoints;
+    }
+
+    const QAbstractItemModel *model = breakView->model();
+    const QModelIndex root = breakView->rootIndex();
+    for (int row = 0; row < model->rowCount(root); ++row) {
+        breakpoints.append(MCPBreakpointRows::breakpoint(model, root, row));
+    }
+    return breakpoints;
+}
+
+bool MCPBreakpoints::editBreakpoint(QAbstractItemView *breakView, int row, const std::optional<QString> &condition,
+                                    int ignoreCount)
+{
+    // A double click on the address column or right of it opens the edit
+    // dialog modally. The dialog is filled in and accepted from the first
+    // event loop pass inside it; the guard drops the timer if no dialog opens.
+    const QAbstractItemModel *model = breakView->model();
+    const QModelIndex root = breakView->rootIndex();
+    const QModelIndex index = model->index(row, MCPBreakpointRows::ConditionColumn, root);
+    if (!index.isValid()) {
+        return false;
+    }
+
+    // The debugger finds the breakpoint from the click position, so the
+    // click has to land on this row; if the view cannot show it, nothing is sent
+    breakView->scrollTo(index);
+    const QPoint position = breakView->visualRect(index).center();
+    if (breakView->indexAt(position) != index) {
+        return false;
+    }
+
+    // Only the fields the caller asked for are touched
+    const QString conditionLabel = debuggerLabel("&Condition:");
+    const QString ignoreCountLabel = debuggerLabel("&Ignore count:");
+    const int wanted = (condition ? 1 : 0) + (ignoreCount >= 0 ? 1 : 0);
+    int filled = 0;
+    QObject guard;
+    QTimer::singleShot(0, &guard, [&filled, wanted, condition, ignoreCount, conditionLabel, ignoreCountLabel] {
+        auto dialog = qobject_cast<QDialog *>(QApplication::activeModalWidget());
+        if (!dialog) {
+            return;
+        }
+        for (QLabel *label : dialog->findChildren<QLabel *>()) {
+            const QString text = label->text().remove('&');
+            if (condition && text == conditionLabel) {
+                if (auto edit = qobject_cast<QLineEdit *>(label->buddy())) {
+                    edit->setText(*condition);
+                    ++filled;
+                }
+            } else if (ignoreCount >= 0 && text == ignoreCountLabel) {
+                if (auto spinBox = qobject_cast<QSpinBox *>(label->buddy())) {
+                    spinBox->setValue(ignoreCount);
+                    ++filled;
+                }
+            }
+        }
+        if (filled == wanted) {
+            dialog->accept();
+        } else {
+            dialog->reject();
+        }
+    });
+
+    QMouseEvent event(QEvent::MouseButtonDblClick, position, breakView->viewport()->mapToGlobal(position),
+                      Qt::LeftButton, Qt::LeftButton, Qt::NoModifier);
+    breakView->model()->setData(index, QVariant::fromValue(Utils::ItemViewEvent(&event, breakView)),
+                                Utils::BaseTreeView::ItemViewEventRole);
+    return filled == wanted && MCPBreakpointRows::hasParameters(model, root, row, condition, ignoreCount);
+}
+
+QJsonObject MCPBreakpoints::set(const QJsonArray &items, QString &errorMessage)
+{
+    QJsonObject result;
+    QAbstractItemView *breakView = view(errorMessage);
+    if (!breakView) {
+        return result;
+    }
+
+    Core::Command *toggleCommand = MCPActionIndex::find("Debugger.ToggleBreak");
+    if (!toggleCommand || !toggleCommand->action()) {
+        errorMessage = "Debugger.ToggleBreak action not available";
+        return result;
+    }
+
+    QPointer<Core::IEditor> previousEditor = Core::EditorManager::currentEditor();
+    QJsonArray results;
+    int created = 0;
+    int failed = 0;
+
+    for (const QJsonValue &value : items) {
+        const QJsonObject item = value.toObject();
+        const QString file = item.value("file").toString();
+        const int line = item.value("line").toInt();
+        std::optional<QString> condition;
+        if (item.contains("condition")) {
+            condition = item.value("condition").toString();
+        }
+
+        // hitCount N stops on the Nth hit, which the debugger expresses as ignoring N-1
+        int ignoreCount = item.value("ignoreCount").toInt(-1);
+        if (item.contains("hitCount")) {
+            ignoreCount = qMax(0, item.value("hitCount").toInt() - 1);
+        }
+
+        QJsonObject entry;
+        entry["file"] = file;
+        entry["line"] = line;
+
+        const Utils::FilePath filePath = Utils::FilePath::fromString(file);
+        if (file.isEmpty() || line < 1 || !filePath.exists()) {
+            entry["success"] = false;
+            entry["error"] = file.isEmpty() || line < 1 ? "file and line are required"
+                                                        : QString("File does not exist: %1").arg(file);
+            results.append(entry);
+            ++failed;
+            continue;
+        }
+
+        // Toggling an existing breakpoint would remove it
+        int row = MCPBreakpointRows::findRow(breakView->model(), breakView->rootIndex(), file, line);
+        entry["created"] = row < 0;
+        if (row < 0) {
+            toggle(toggleCommand, filePath, line);
+            row = MCPBreakpointRows::findRow(breakView->model(), breakView->rootIndex(), file, line);
+            if (row < 0) {
+                entry["success"] = false;
+                entry["error"] = "Debugger did not create the breakpoint";
+                results.append(entry);
+                ++failed;
+                continue;
+            }
+            ++created;
+        }
+
+        bool successB = true;
+        if (condition || ignoreCount >= 0) {
+            successB = editBreakpoint(breakView, row, condition, ignoreCount);
+            if (!successB) {
+                entry["error"] = "Breakpoint set, but condition or hit count could not be applied";
+                ++failed;
+            }
+        }
+        entry["success"] = successB;
+        results.append(entry);
+    }
+
+    if (previousEditor) {
+        Core::EditorManager::activateEditor(previousEditor);
+    }
+
+    result["results"] = results;
+    result["created"] = created;
+    result["failed"] = failed;
+    return result;
+}
+
+QJsonObject MCPBreakpoints::clear(const QJsonObject &filter, QString &errorMessage)
+{
+    QJsonObject result;
+    QAbstractItemView *breakView = view(errorMessage);
+    if (!breakView) {
+        return result;
+    }
+
+    Core::Command *toggleCommand = MCPActionIndex::find("Debugger.ToggleBreak");
+    if (!toggleCommand || !toggleCommand->action()) {
+        errorMessage = "Debugger.ToggleBreak action not available";
+        return result;
+    }
+
+    struct Location
+    {
+        QString file;
+        int line = 0;
+        QString function;
+    };
+
+    // Take the locations first, rows move as breakpoints go away
+    const QAbstractItemModel *model = breakView->model();
+    const QModelIndex root = breakView->rootIndex();
+    QList<Location> locations;
+    for (int row : MCPBreakpointRows::filterRows(model, root, filter.value("file").toString(),
+                                                 filter.value("line").toInt(-1))) {
+        locations.append({model->index(row, MCPBreakpointRows::FileColumn, root).data().toString(),
+                          model->index(row, MCPBreakpointRows::LineColumn, root).data().toInt(),
+                          model->index(row, MCPBreakpointRows::FunctionColumn, root).data().toString()});
+    }
+
+    QPointer<Core::IEditor> previousEditor = Core::EditorManager::currentEditor();
+    int removed = 0;
+    QStringList kept;
+    for (const Location &location : std::as_const(locations)) {
+        const Utils::FilePath filePath = Utils::FilePath::fromString(location.file);
+        const int before = model->rowCount(root);
+        if (location.line > 0 && filePath.isAbsolutePath() && filePath.exists()) {
+            toggle(toggleCommand, filePath, location.line);
+            if (model->rowCount(root) > before) {
+                toggle(toggleCommand, filePath, location.line);   // there was none at that line; undo
+            }
+        }
+        if (model->rowCount(root) < before) {
+            ++removed;
+        } else if (location.file.isEmpty()) {
+            kept.append(location.function);
+        } else {
+            kept.append(QString("%1:%2").arg(location.file).arg(location.line));
+        }
+    }
+
+    if (previousEditor) {
+        Core::EditorManager::activateEditor(previousEditor);
+    }
+
+    if (removed != locations.size()) {
+        errorMessage = QString("Removed %1 of %2 matching breakpoints; these have to be removed in the "
+                               "Breakpoints view: %3").arg(removed).arg(locations.size()).arg(kept.join(", "));
+        return QJsonObject();
+    }
+    result["removed"] = removed;
+    result["remaining"] = model->rowCount(root);
+    return result;
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
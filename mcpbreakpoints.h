@@ -0,0 +1,88 @@
+#ifndef MCPBREAKPOINTS_H
+#define MCPBREAKPOINTS_H
+
+#include <QObject>
+#include <QJsonArray>
+#include <QJsonObject>
+
+#include <optional>
+
+class QAbstractItemView;
+
+namespace Core {
+class Command;
+}
+
+namespace Utils {
+class FilePath;
+}
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+/**
+ * @brief Sets, lists and clears debugger breakpoints in bulk
+ *
+ * The Debugger plugin's BreakpointManager is not exported. Breakpoints are
+ * read from the model behind the debugger's Breakpoints view, and created
+ * and removed with the "Toggle Breakpoint" action at their line, the same
+ * way a user does it in the editor; the view's selection is never touched.
+ * Breakpoints without a file and line (e.g. on a function) cannot be
+ * removed that way, and clear() reports them as an error.
+ *
+ * Conditions and hit counts have no action, so they are entered in the
+ * breakpoint's edit dialog, opened by a double click on the breakpoint's
+ * own row and accepted as soon as it opens. The row is scrolled into view
+ * first, and the model is read back afterwards, so an edit that did not
+ * reach the breakpoint is reported instead of assumed.
+ *
+ * Columns are addressed by the debugger's fixed column order and dialog
+ * fields by their translated labels, so neither depends on the UI language.
+ *
+ * Every call works on the whole list in one pass on the GUI thread and
+ * leaves the editor that was current before.
+ */
+class MCPBreakpoints : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MCPBreakpoints(QObject *parent = nullptr);
+
+    /**
+     * @brief Returns all breakpoints with file, line, condition and ignore count
+     */
+    QJsonArray list(QString &errorMessage) const;
+
+    /**
+     * @brief Creates breakpoints that do not exist yet and applies conditions
+     * @param items [{file, line, condition, hitCount | ignoreCount}]
+     * @return Per-item results; a failing item does not stop the others
+     */
+    QJsonObject set(const QJsonArray &items, QString &errorMessage);
+
+    /**
+     * @brief Removes breakpoints matching the filter
+     * @param filter {file, line}, both optional; empty removes all
+     * @param errorMessage Set if not every matching breakpoint could be removed
+     */
+    QJsonObject clear(const QJsonObject &filter, QString &errorMessage);
+
+private:
+    /**
+     * @brief Finds the Breakpoints view and checks that it has the expected columns
+     */
+    QAbstractItemView *view(QString &errorMessage) const;
+
+    /**
+     * @brief Toggles the breakpoint at file and line in the editor
+     */
+    static void toggle(Core::Command *command, const Utils::FilePath &file, int line);
+    bool editBreakpoint(QAbstractItemView *view, int row, const std::optional<QString> &condition,
+                        int ignoreCount);
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPBREAKPOINTS_H
@@ -0,0 +1,214 @@
+#include "mcpbuildhistory.h"
+
+#include <coreplugin/icore.h>
+#include <projectexplorer/buildconfiguration.h>
+#include <projectexplorer/buildmanager.h>
+#include <projectexplorer/buildstep.h>
+#include <projectexplorer/buildsteplist.h>
+#include <projectexplorer/project.h>
+#include <projectexplorer/target.h>
+#include <projectexplorer/task.h>
+#include <projectexplorer/taskhub.h>
+
+#include <QDateTime>
+#include <QDebug>
+#include <QSet>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+MCPBuildHistory::MCPBuildHistory(QObject *parent)
+    : QObject(parent)
+{
+    openLog();
+    connectBuildSignals();
+}
+
+MCPBuildHistory::~MCPBuildHistory() = default;
+
+void MCPBuildHistory::connectBuildSignals()
+{
+    ProjectExplorer::BuildManager *buildManager = ProjectExplorer::BuildManager::instance();
+    connect(buildManager, &ProjectExplorer::BuildManager::buildStateChanged,
+            this, [this](ProjectExplorer::Project *project) {
+        if (!m_recording && ProjectExplorer::BuildManager::isBuilding()) {
+            beginBuild(project);
+        }
+    });
+    connect(buildManager, &ProjectExplorer::BuildManager::buildQueueFinished,
+            this, [this](bool success) {
+        if (m_recording) {
+            finishBuild(success);
+        }
+    });
+
+    connect(&ProjectExplorer::taskHub(), &ProjectExplorer::TaskHub::taskAdded,
+            this, &MCPBuildHistory::taskAdded);
+}
+
+void MCPBuildHistory::beginBuild(ProjectExplorer::Project *project)
+{
+    m_recording = true;
+    m_errors = 0;
+    m_warnings = 0;
+    m_steps.clear();
+    m_stepOrder.clear();
+    m_runningStep = nullptr;
+    m_buildTimer.start();
+
+    m_current = QJsonObject();
+    m_current["project"] = project ? project->displayName() : QString();
+    m_current["startMs"] = QDateTime::currentMSecsSinceEpoch();
+
+    // Connections die with the context object when the build ends
+    delete m_stepContextP;
+    m_stepContextP = new QObject(this);
+
+    ProjectExplorer::Target *target = project ? project->activeTarget() : nullptr;
+    ProjectExplorer::BuildConfiguration *buildConfig = target ? target->activeBuildConfiguration() : nullptr;
+    m_current["buildConfig"] = buildConfig ? buildConfig->displayName() : QString();
+    if (target) {
+        for (ProjectExplorer::BuildConfiguration *config : target->buildConfigurations()) {
+            watchSteps(config->cleanSteps(), "clean", config->displayName());
+            watchSteps(config->buildSteps(), "build", config->displayName());
+        }
+    }
+
+    qDebug() << "Recording build of" << m_current.value("project").toString()
+             << "with" << m_steps.size() << "steps";
+}
+
+void MCPBuildHistory::watchSteps(ProjectExplorer::BuildStepList *list, const QString &listName,
+                                 const QString &config)
+{
+    if (!list) {
+        return;
+    }
+
+    QHash<QString, int> occurrences;
+    for (ProjectExplorer::BuildStep *step : list->steps()) {
+        if (!step->enabled()) {
+            continue;
+        }
+
+        const QString stepId = step->id().toString();
+        StepTiming timing;
+        timing.key = QString("%1:%2#%3").arg(listName, stepId).arg(occurrences[stepId]++);
+        timing.name = step->displayName();
+        timing.list = listName;
+        timing.config = config;
+        m_steps.insert(step, timing);
+
+        connect(step, &ProjectExplorer::BuildStep::addOutput, m_stepContextP, [this, step] {
+            stepActive(step);
+        });
+        connect(step, &ProjectExplorer::BuildStep::progress, m_stepContextP, [this, step] {
+            stepActive(step);
+        });
+    }
+}
+
+void MCPBuildHistory::stepActive(ProjectExplorer::BuildStep *step)
+{
+    auto it = m_steps.find(step);
+    if (it == m_steps.end() || it->timer.isValid()) {
+        return;
+    }
+
+    // The first step that runs tells which configuration is being built
+    if (m_stepOrder.isEmpty()) {
+        m_current["buildConfig"] = it->config;
+    }
+
+    // Steps run one after another, so a new one ends the previous one
+    closeRunningStep();
+    it->timer.start();
+    m_runningStep = step;
+    m_stepOrder.append(step);
+}
+
+void MCPBuildHistory::closeRunningStep()
+{
+    if (!m_runningStep) {
+        return;
+    }
+
+    StepTiming &timing = m_steps[m_runningStep];
+    timing.durationMs = timing.timer.elapsed();
+    m_runningStep = nullptr;
+}
+
+void MCPBuildHistory::taskAdded(const ProjectExplorer::Task &task)
+{
+    if (!m_recording) {
+        return;
+    }
+
+    if (task.type == ProjectExplorer::Task::Error) {
+        m_errors++;
+    } else if (task.type == ProjectExplorer::Task::Warning) {
+        m_warnings++;
+    }
+}
+
+void MCPBuildHistory::finishBuild(bool success)
+{
+    closeRunningStep();
+
+    QJsonArray steps;
+    QSet<QString> lists;
+    for (ProjectExplorer::BuildStep *step : std::as_const(m_stepOrder)) {
+        const StepTiming &timing = m_steps[step];
+        QJsonObject entry;
+        entry["key"] = timing.key;
+        entry["name"] = timing.name;
+        entry["durationMs"] = timing.durationMs;
+        steps.append(entry);
+        lists.insert(timing.list);
+    }
+
+    QString kind = "unknown";
+    if (lists.contains("clean") && lists.contains("build")) {
+        kind = "rebuild";
+    } else if (lists.contains("clean")) {
+        kind = "clean";
+    } else if (lists.contains("build")) {
+        kind = "build";
+    }
+
+    m_current["id"] = m_log.nextId();
+    m_current["kind"] = kind;
+    m_current["endMs"] = QDateTime::currentMSecsSinceEpoch();
+    m_current["durationMs"] = m_buildTimer.elapsed();
+    m_current["success"] = success;
+    m_current["errors"] = m_errors;
+    m_current["warnings"] = m_warnings;
+    m_current["steps"] = steps;
+    m_log.append(m_current);
+
+    qDebug() << "Recorded" << kind << "of" << m_current.value("project").toString()
+             << "in" << m_current.value("durationMs").toInteger() << "ms";
+
+    delete m_stepContextP;
+    m_steps.clear();
+    m_stepOrder.clear();
+    m_recording = false;
+}
+
+void MCPBuildHistory::openLog()
+{
+    m_log.open(Core::ICore::userResourcePath("qt_mcp_plugin/buildhistory.jsonl").toFSPathString());
+}
+
+QJsonArray MCPBuildHistory::history(const QString &project, const QString &buildConfig, int limit) const
+{
+    return m_log.history(project, buildConfig, limit);
+}
+
+QJsonObject MCPBuildHistory::compare(const QJsonObject &params, QString &errorMessage) const
+{
+    return m_log.compare(params, errorMessage);
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
@@ -0,0 +1,105 @@
+#ifndef MCPBUILDHISTORY_H
+#define MCPBUILDHISTORY_H
+
+#include "mcpbuildlog.h"
+
+#include <QObject>
+#include <QPointer>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QList>
+
+namespace ProjectExplorer {
+class BuildStep;
+class BuildStepList;
+class Project;
+class Task;
+}
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+/**
+ * @brief Records every build that runs in Qt Creator
+ *
+ * A record holds project, build configuration, start and end time, the
+ * duration of each build step, error and warning counts and the result.
+ * Records are appended to an MCPBuildLog, which also answers the history
+ * and comparison queries.
+ *
+ * Steps of all build configurations of the active target are watched, and
+ * the configuration whose step runs first names the record, so builds of an
+ * inactive configuration (buildMatrix) are attributed correctly.
+ *
+ * BuildManager does not report step boundaries, so a step counts as started
+ * when it first produces output or progress, and as finished when the next
+ * step starts or the build queue ends.
+ */
+class MCPBuildHistory : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MCPBuildHistory(QObject *parent = nullptr);
+    ~MCPBuildHistory() override;
+
+    /**
+     * @brief Returns the most recent builds, newest first
+     * @param project Project name, empty for all projects
+     * @param buildConfig Build configuration name, empty for all
+     * @param limit Maximum number of records
+     */
+    QJsonArray history(const QString &project, const QString &buildConfig, int limit) const;
+
+    /**
+     * @brief Compares the step durations of two builds
+     *
+     * Without explicit ids the newest build matching project and buildConfig
+     * is compared against the per-step median of up to BaselineBuilds earlier
+     * successful builds of the same kind.
+     *
+     * @param errorMessage Set if there is nothing to compare
+     */
+    QJsonObject compare(const QJsonObject &params, QString &errorMessage) const;
+
+private:
+    struct StepTiming
+    {
+        QString key;     // step id plus occurrence, stable across builds
+        QString name;
+        QString list;    // "build" or "clean"
+        QString config;  // build configuration the step belongs to
+        QElapsedTimer timer;
+        qint64 durationMs = -1;
+    };
+
+    void connectBuildSignals();
+    void beginBuild(ProjectExplorer::Project *project);
+    void finishBuild(bool success);
+    void watchSteps(ProjectExplorer::BuildStepList *list, const QString &listName, const QString &config);
+    void stepActive(ProjectExplorer::BuildStep *step);
+    void closeRunningStep();
+    void taskAdded(const ProjectExplorer::Task &task);
+
+    void openLog();
+
+    MCPBuildLog m_log;
+
+    // Build in progress
+    bool m_recording = false;
+    QPointer<QObject> m_stepContextP;   // owns the step connections of the current build
+    QHash<ProjectExplorer::BuildStep *, StepTiming> m_steps;
+    QList<ProjectExplorer::BuildStep *> m_stepOrder;
+    ProjectExplorer::BuildStep *m_runningStep = nullptr;
+    QJsonObject m_current;
+    QElapsedTimer m_buildTimer;
+    int m_errors = 0;
+    int m_warnings = 0;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPBUILDHISTORY_H
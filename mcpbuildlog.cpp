@@ -0,0 +1,305 @@
+#include "mcpbuildlog.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonDocument>
+
+#include <algorithm>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+namespace {
+
+qint64 median(QList<qint64> values)
+{
+    std::sort(values.begin(), values.end());
+    return values.at(values.size() / 2);
+}
+
+} // namespace
+
+MCPBuildLog::~MCPBuildLog()
+{
+    if (m_map) {
+        m_file.unmap(m_map);
+    }
+}
+
+bool MCPBuildLog::open(const QString &path)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    // The log is never rewritten; once it is too large it is moved aside whole
+    if (QFileInfo(path).size() > MaxLogSize) {
+        QFile::remove(path + ".1");
+        QFile::rename(path, path + ".1");
+    }
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        qDebug() << "Cannot open build history" << path << ":" << m_file.errorString();
+        return false;
+    }
+
+    remap();
+    indexLog();
+    qDebug() << "Build history" << path << "has" << m_index.size() << "records";
+    return true;
+}
+
+bool MCPBuildLog::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+int MCPBuildLog::recordCount() const
+{
+    return int(m_index.size());
+}
+
+qint64 MCPBuildLog::nextId() const
+{
+    return m_nextId;
+}
+
+void MCPBuildLog::remap()
+{
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+
+    m_mapSize = m_file.size();
+    if (m_mapSize > 0) {
+        m_map = m_file.map(0, m_mapSize);
+        if (!m_map) {
+            m_mapSize = 0;
+        }
+    }
+}
+
+void MCPBuildLog::indexLog()
+{
+    const char *data = reinterpret_cast<const char *>(m_map);
+    qint64 start = 0;
+    for (qint64 i = 0; i < m_mapSize; ++i) {
+        if (data[i] != '\n') {
+            continue;
+        }
+        if (i > start && !indexRecord(start, int(i - start))) {
+            qDebug() << "Skipping damaged build history record at offset" << start;
+        }
+        start = i + 1;
+    }
+}
+
+bool MCPBuildLog::indexRecord(qint64 offset, int length)
+{
+    IndexEntry entry;
+    entry.offset = offset;
+    entry.length = length;
+
+    const QJsonObject record = readRecord(entry);
+    if (record.isEmpty()) {
+        return false;
+    }
+
+    addToIndex(entry, record);
+    return true;
+}
+
+void MCPBuildLog::addToIndex(IndexEntry entry, const QJsonObject &record)
+{
+    entry.id = record.value("id").toInteger();
+    entry.project = record.value("project").toString();
+    entry.buildConfig = record.value("buildConfig").toString();
+    entry.kind = record.value("kind").toString();
+    entry.success = record.value("success").toBool();
+    m_index.append(entry);
+    m_nextId = qMax(m_nextId, entry.id + 1);
+}
+
+void MCPBuildLog::append(const QJsonObject &record)
+{
+    // Ids stay unique for this session even when the file cannot be written
+    m_nextId = qMax(m_nextId, record.value("id").toInteger() + 1);
+    if (!m_file.isOpen()) {
+        return;
+    }
+
+    QByteArray line = QJsonDocument(record).toJson(QJsonDocument::Compact);
+    qint64 offset = m_file.size();
+
+    // A record cut short by a crash must not swallow the next one
+    QByteArray prefix;
+    if (m_mapSize > 0 && m_map[m_mapSize - 1] != '\n') {
+        prefix = "\n";
+        offset++;
+    }
+
+    m_file.seek(m_file.size());
+    if (m_file.write(prefix + line + "\n") < 0 || !m_file.flush()) {
+        qDebug() << "Cannot append to build history:" << m_file.errorString();
+        return;
+    }
+    remap();
+
+    IndexEntry entry;
+    entry.offset = offset;
+    entry.length = int(line.size());
+    addToIndex(entry, record);
+}
+
+QJsonObject MCPBuildLog::readRecord(const IndexEntry &entry) const
+{
+    if (!m_map || entry.offset + entry.length > m_mapSize) {
+        return QJsonObject();
+    }
+
+    const QByteArray line = QByteArray::fromRawData(reinterpret_cast<const char *>(m_map) + entry.offset,
+                                                    entry.length);
+    return QJsonDocument::fromJson(line).object();
+}
+
+const MCPBuildLog::IndexEntry *MCPBuildLog::findById(qint64 id) const
+{
+    for (const IndexEntry &entry : m_index) {
+        if (entry.id == id) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+QJsonArray MCPBuildLog::history(const QString &project, const QString &buildConfig, int limit) const
+{
+    QJsonArray records;
+    for (auto it = m_index.crbegin(); it != m_index.crend() && records.size() < limit; ++it) {
+        if ((!project.isEmpty() && it->project != project)
+            || (!buildConfig.isEmpty() && it->buildConfig != buildConfig)) {
+            continue;
+        }
+        records.append(readRecord(*it));
+    }
+    return records;
+}
+
+QJsonObject MCPBuildLog::compare(const QJsonObject &params, QString &errorMessage) const
+{
+    const QString project = params.value("project").toString();
+    const QString buildConfig = params.value("buildConfig").toString();
+    const double thresholdPercent = params.value("thresholdPercent").toDouble(10.0);
+    const qint64 minDeltaMs = params.value("minDeltaMs").toInteger(500);
+
+    // Head: an explicit id or the newest matching build
+    int headIndex = -1;
+    if (params.contains("head")) {
+        const IndexEntry *head = findById(params.value("head").toInteger());
+        headIndex = head ? int(head - m_index.constData()) : -1;
+    } else {
+        for (int i = m_index.size() - 1; i >= 0; --i) {
+            if ((project.isEmpty() || m_index.at(i).project == project)
+                && (buildConfig.isEmpty() || m_index.at(i).buildConfig == buildConfig)) {
+                headIndex = i;
+                break;
+            }
+        }
+    }
+    if (headIndex < 0) {
+        errorMessage = "No build found to compare";
+        return QJsonObject();
+    }
+    const IndexEntry &head = m_index.at(headIndex);
+
+    // Baseline: an explicit id or recent successful builds of the same kind
+    QList<QJsonObject> baseline;
+    if (params.contains("base")) {
+        const IndexEntry *base = findById(params.value("base").toInteger());
+        if (base) {
+            baseline.append(readRecord(*base));
+        }
+    } else {
+        for (int i = headIndex - 1; i >= 0 && baseline.size() < BaselineBuilds; --i) {
+            const IndexEntry &entry = m_index.at(i);
+            if (entry.success && entry.project == head.project && entry.buildConfig == head.buildConfig
+                && entry.kind == head.kind) {
+                baseline.append(readRecord(entry));
+            }
+        }
+    }
+    if (baseline.isEmpty()) {
+        errorMessage = "No earlier build to compare with";
+        return QJsonObject();
+    }
+
+    auto isRegression = [&](qint64 baseMs, qint64 headMs) {
+        const qint64 deltaMs = headMs - baseMs;
+        return deltaMs >= minDeltaMs && deltaMs * 100.0 >= thresholdPercent * baseMs;
+    };
+    auto compareDurations = [&](QJsonObject &entry, const QList<qint64> &baseDurations, qint64 headMs) {
+        entry["headMs"] = headMs;
+        if (baseDurations.isEmpty() || headMs < 0) {
+            entry["regression"] = false;
+            return false;
+        }
+        const qint64 baseMs = median(baseDurations);
+        entry["baseMs"] = baseMs;
+        entry["deltaMs"] = headMs - baseMs;
+        entry["deltaPercent"] = baseMs > 0 ? qRound((headMs - baseMs) * 1000.0 / baseMs) / 10.0 : 0.0;
+        const bool regressionB = isRegression(baseMs, headMs);
+        entry["regression"] = regressionB;
+        return regressionB;
+    };
+
+    const QJsonObject headRecord = readRecord(head);
+    QJsonArray baselineIds;
+    QList<qint64> baseTotals;
+    QHash<QString, QList<qint64>> baseSteps;
+    for (const QJsonObject &record : std::as_const(baseline)) {
+        baselineIds.append(record.value("id"));
+        baseTotals.append(record.value("durationMs").toInteger());
+        for (const QJsonValue &step : record.value("steps").toArray()) {
+            const qint64 durationMs = step.toObject().value("durationMs").toInteger(-1);
+            if (durationMs >= 0) {
+                baseSteps[step.toObject().value("key").toString()].append(durationMs);
+            }
+        }
+    }
+
+    QJsonArray steps;
+    QJsonArray regressions;
+    for (const QJsonValue &value : headRecord.value("steps").toArray()) {
+        const QJsonObject step = value.toObject();
+        QJsonObject entry;
+        entry["key"] = step.value("key");
+        entry["name"] = step.value("name");
+        if (compareDurations(entry, baseSteps.value(step.value("key").toString()),
+                             step.value("durationMs").toInteger(-1))) {
+            regressions.append(step.value("name"));
+        }
+        steps.append(entry);
+    }
+
+    QJsonObject total;
+    compareDurations(total, baseTotals, headRecord.value("durationMs").toInteger());
+
+    QJsonObject result;
+    result["head"] = head.id;
+    result["baseline"] = baselineIds;
+    result["project"] = head.project;
+    result["buildConfig"] = head.buildConfig;
+    result["kind"] = head.kind;
+    result["thresholdPercent"] = thresholdPercent;
+    result["minDeltaMs"] = minDeltaMs;
+    result["total"] = total;
+    result["steps"] = steps;
+    result["regressions"] = regressions;
+    result["regressed"] = !regressions.isEmpty() || total.value("regression").toBool();
+    return result;
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
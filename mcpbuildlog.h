@@ -0,0 +1,103 @@
+#ifndef MCPBUILDLOG_H
+#define MCPBUILDLOG_H
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+/**
+ * @brief Append-only JSON lines log of build records
+ *
+ * The file is never rewritten; once it grows beyond MaxLogSize it is moved
+ * aside whole when the log is opened. It is memory-mapped for reading and an
+ * in-memory index of record offsets answers queries without parsing the
+ * whole log. Damaged lines, for example a record cut short by a crash, are
+ * skipped.
+ *
+ * This class only depends on QtCore; MCPBuildHistory records the builds.
+ */
+class MCPBuildLog
+{
+public:
+    MCPBuildLog() = default;
+    ~MCPBuildLog();
+
+    MCPBuildLog(const MCPBuildLog &) = delete;
+    MCPBuildLog &operator=(const MCPBuildLog &) = delete;
+
+    /**
+     * @brief Opens or creates the log file and indexes its records
+     * @return false if the file cannot be opened; appends are then dropped
+     */
+    bool open(const QString &path);
+
+    bool isOpen() const;
+    int recordCount() const;
+
+    /**
+     * @brief The id for the next record, one above the highest id seen
+     */
+    qint64 nextId() const;
+
+    /**
+     * @brief Appends a record; its "id" should come from nextId()
+     */
+    void append(const QJsonObject &record);
+
+    /**
+     * @brief Returns the most recent builds, newest first
+     * @param project Project name, empty for all projects
+     * @param buildConfig Build configuration name, empty for all
+     * @param limit Maximum number of records
+     */
+    QJsonArray history(const QString &project, const QString &buildConfig, int limit) const;
+
+    /**
+     * @brief Compares the step durations of two builds
+     *
+     * Without explicit ids the newest build matching project and buildConfig
+     * is compared against the per-step median of up to BaselineBuilds earlier
+     * successful builds of the same kind.
+     *
+     * @param errorMessage Set if there is nothing to compare
+     */
+    QJsonObject compare(const QJsonObject &params, QString &errorMessage) const;
+
+    static constexpr int BaselineBuilds = 5;
+    static constexpr qint64 MaxLogSize = 16 * 1024 * 1024;
+
+private:
+    struct IndexEntry
+    {
+        qint64 id = 0;
+        qint64 offset = 0;
+        int length = 0;
+        QString project;
+        QString buildConfig;
+        QString kind;
+        bool success = false;
+    };
+
+    void remap();
+    void indexLog();
+    bool indexRecord(qint64 offset, int length);
+    void addToIndex(IndexEntry entry, const QJsonObject &record);
+    QJsonObject readRecord(const IndexEntry &entry) const;
+    const IndexEntry *findById(qint64 id) const;
+
+    QFile m_file;
+    uchar *m_map = nullptr;
+    qint64 m_mapSize = 0;
+    QList<IndexEntry> m_index;
+    qint64 m_nextId = 1;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPBUILDLOG_H
@@ -0,0 +1,283 @@
+#include "mcpbuildmatrix.h"
+#include "mcpparsetracker.h"
+
+#include <projectexplorer/buildconfiguration.h>
+#include <projectexplorer/buildmanager.h>
+#include <projectexplorer/buildsteplist.h>
+#include <projectexplorer/buildsystem.h>
+#include <projectexplorer/project.h>
+#include <projectexplorer/projectmanager.h>
+#include <projectexplorer/target.h>
+#include <projectexplorer/task.h>
+#include <projectexplorer/taskhub.h>
+
+#include <QDebug>
+#include <QJsonArray>
+#include <QTimer>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+MCPBuildMatrix::MCPBuildMatrix(MCPParseTracker *parseTracker, QObject *parent)
+    : QObject(parent)
+    , m_parseTracker(parseTracker)
+{
+    connect(ProjectExplorer::BuildManager::instance(), &ProjectExplorer::BuildManager::buildQueueFinished,
+            this, [this](bool success) {
+        if (m_running && m_current >= 0 && m_current < m_runs.size()
+            && m_runs.at(m_current).state == "building") {
+            configFinished(success);
+        }
+    });
+    connect(&ProjectExplorer::taskHub(), &ProjectExplorer::TaskHub::taskAdded,
+            this, &MCPBuildMatrix::taskAdded);
+}
+
+bool MCPBuildMatrix::start(const QStringList &configs, QString &errorMessage)
+{
+    if (m_running) {
+        errorMessage = "A build matrix is already running";
+        return false;
+    }
+    if (ProjectExplorer::BuildManager::isBuilding()) {
+        errorMessage = "A build is already running";
+        return false;
+    }
+    if (configs.isEmpty()) {
+        errorMessage = "No build configurations given";
+        return false;
+    }
+
+    ProjectExplorer::Project *project = ProjectExplorer::ProjectManager::startupProject();
+    ProjectExplorer::Target *target = project ? project->activeTarget() : nullptr;
+    if (!target) {
+        errorMessage = "No current project";
+        return false;
+    }
+
+    QList<ConfigRun> runs;
+    QStringList available;
+    for (ProjectExplorer::BuildConfiguration *config : target->buildConfigurations()) {
+        available.append(config->displayName());
+    }
+    for (const QString &name : configs) {
+        ConfigRun run;
+        run.name = name;
+        for (ProjectExplorer::BuildConfiguration *config : target->buildConfigurations()) {
+            if (config->displayName() == name) {
+                run.config = config;
+                break;
+            }
+        }
+        if (!run.config) {
+            errorMessage = QString("Unknown build configuration '%1'. Available: %2").arg(name, available.join(", "));
+            return false;
+        }
+        runs.append(run);
+    }
+
+    qDebug() << "Starting build matrix for" << project->displayName() << ":" << configs;
+    m_runs = runs;
+    m_originalConfig = target->activeBuildConfiguration();
+    m_current = -1;
+    m_running = true;
+    m_cancelled = false;
+    m_startPending = false;
+    m_timer.start();
+    startNext();
+    return true;
+}
+
+void MCPBuildMatrix::cancel()
+{
+    if (!m_running) {
+        return;
+    }
+
+    m_cancelled = true;
+    if (m_startPending) {
+        // The queued startNext() marks the rest cancelled and finishes the matrix
+        return;
+    }
+    if (m_current >= 0 && m_current < m_runs.size() && m_runs.at(m_current).state == "building") {
+        // configFinished() picks up the rest once the build has stopped
+        ProjectExplorer::BuildManager::cancel();
+    } else if (m_parseWait) {
+        disconnect(m_parseWait);
+        ConfigRun &run = m_runs[m_current];
+        run.state = "cancelled";
+        run.durationMs = run.timer.elapsed();
+        emit progress(entryFor(run));
+        startNext();
+    } else {
+        startNext();
+    }
+}
+
+bool MCPBuildMatrix::isRunning() const
+{
+    return m_running;
+}
+
+void MCPBuildMatrix::startNext()
+{
+    m_startPending = false;
+    if (!m_running) {
+        return;
+    }
+
+    while (++m_current < m_runs.size()) {
+        ConfigRun &run = m_runs[m_current];
+        if (m_cancelled) {
+            run.state = "cancelled";
+            emit progress(entryFor(run));
+            continue;
+        }
+        if (!run.config) {
+            run.state = "skipped";
+            emit progress(entryFor(run));
+            continue;
+        }
+
+        run.timer.start();
+        ProjectExplorer::Target *target = run.config->target();
+        if (target->activeBuildConfiguration() != run.config) {
+            target->setActiveBuildConfiguration(run.config, ProjectExplorer::SetActive::NoCascade);
+        }
+
+        // Switching schedules a parse; the build waits until it is done
+        if (m_parseTracker->isParsing()) {
+            run.state = "configuring";
+            emit progress(entryFor(run));
+            m_parseWait = connect(m_parseTracker, &MCPParseTracker::idle, this, [this] {
+                disconnect(m_parseWait);
+                if (!buildCurrent()) {
+                    startNext();
+                }
+            });
+            return;
+        }
+        if (buildCurrent()) {
+            return;
+        }
+    }
+
+    restoreActiveConfig();
+    m_running = false;
+    m_totalMs = m_timer.elapsed();
+    const QJsonObject summary = report();
+    qDebug() << "Build matrix finished:" << summary.value("succeeded").toInt() << "of"
+             << m_runs.size() << "configurations succeeded";
+    emit finished(summary.value("failed").toInt() == 0 && !m_cancelled, summary);
+}
+
+bool MCPBuildMatrix::buildCurrent()
+{
+    ConfigRun &run = m_runs[m_current];
+    ProjectExplorer::BuildSystem *buildSystem = run.config ? run.config->buildSystem() : nullptr;
+    if (!run.config) {
+        run.error = "The build configuration was removed";
+    } else if (!buildSystem || !buildSystem->hasParsingData()) {
+        run.error = "The build directory could not be configured";
+    } else {
+        run.state = "building";
+        emit progress(entryFor(run));
+        if (ProjectExplorer::BuildManager::buildLists({run.config->buildSteps()})) {
+            return true;
+        }
+        run.error = "The build could not be started";
+    }
+
+    // Nothing was queued, so no buildQueueFinished will follow
+    run.state = "failed";
+    run.durationMs = run.timer.elapsed();
+    emit progress(entryFor(run));
+    return false;
+}
+
+void MCPBuildMatrix::restoreActiveConfig()
+{
+    if (m_originalConfig && m_originalConfig->target()->activeBuildConfiguration() != m_originalConfig) {
+        m_originalConfig->target()->setActiveBuildConfiguration(m_originalConfig,
+                                                                ProjectExplorer::SetActive::NoCascade);
+    }
+    m_originalConfig.clear();
+}
+
+void MCPBuildMatrix::configFinished(bool success)
+{
+    ConfigRun &run = m_runs[m_current];
+    run.durationMs = run.timer.elapsed();
+    run.state = m_cancelled ? "cancelled" : success ? "succeeded" : "failed";
+    emit progress(entryFor(run));
+
+    // Start the next configuration once BuildManager has finished its bookkeeping
+    m_startPending = true;
+    QTimer::singleShot(0, this, &MCPBuildMatrix::startNext);
+}
+
+void MCPBuildMatrix::taskAdded(const ProjectExplorer::Task &task)
+{
+    if (!m_running || m_current < 0 || m_current >= m_runs.size()) {
+        return;
+    }
+
+    ConfigRun &run = m_runs[m_current];
+    if (task.type == ProjectExplorer::Task::Error) {
+        run.errors++;
+        if (run.firstErrors.size() < MaxReportedErrors) {
+            run.firstErrors.append(task.file.isEmpty() ? task.description()
+                                                       : QString("%1:%2: %3").arg(task.file.toUserOutput())
+                                                             .arg(task.line).arg(task.description()));
+        }
+    } else if (task.type == ProjectExplorer::Task::Warning) {
+        run.warnings++;
+    }
+}
+
+QJsonObject MCPBuildMatrix::entryFor(const ConfigRun &run) const
+{
+    QJsonObject entry;
+    entry["config"] = run.name;
+    entry["state"] = run.state;
+    if (run.durationMs >= 0) {
+        entry["durationMs"] = run.durationMs;
+    }
+    if (!run.error.isEmpty()) {
+        entry["error"] = run.error;
+    }
+    entry["errors"] = run.errors;
+    entry["warnings"] = run.warnings;
+    if (!run.firstErrors.isEmpty()) {
+        entry["firstErrors"] = QJsonArray::fromStringList(run.firstErrors);
+    }
+    return entry;
+}
+
+QJsonObject MCPBuildMatrix::report() const
+{
+    QJsonArray configs;
+    int succeeded = 0;
+    int failed = 0;
+    int errors = 0;
+    int warnings = 0;
+    for (const ConfigRun &run : m_runs) {
+        configs.append(entryFor(run));
+        succeeded += run.state == "succeeded" ? 1 : 0;
+        failed += run.state == "failed" ? 1 : 0;
+        errors += run.errors;
+        warnings += run.warnings;
+    }
+
+    QJsonObject result;
+    result["configs"] = configs;
+    result["succeeded"] = succeeded;
+    result["failed"] = failed;
+    result["errors"] = errors;
+    result["warnings"] = warnings;
+    result["totalDurationMs"] = m_running ? m_timer.elapsed() : m_totalMs;
+    return result;
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
@@ -0,0 +1,102 @@
+#ifndef MCPBUILDMATRIX_H
+#define MCPBUILDMATRIX_H
+
+#include <QObject>
+#include <QPointer>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QList>
+#include <QStringList>
+
+namespace ProjectExplorer {
+class BuildConfiguration;
+class Task;
+}
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+class MCPParseTracker;
+
+/**
+ * @brief Builds several build configurations of the startup project in a row
+ *
+ * An inactive configuration may never have been configured (the usual case
+ * for CMake), and building it as it is would fail or use a stale build
+ * directory. So each configuration is made active in turn, and its build
+ * starts once the parse tracker reports the project parsed; a configuration
+ * whose parse produced no data fails with an error. The configuration that
+ * was active before is made active again when the matrix ends.
+ *
+ * Each configuration gets its own BuildManager run: BuildManager executes
+ * steps one at a time anyway, and a separate run yields an exact result per
+ * configuration and lets the matrix continue after a configuration fails.
+ */
+class MCPBuildMatrix : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MCPBuildMatrix(MCPParseTracker *parseTracker, QObject *parent = nullptr);
+
+    /**
+     * @brief Starts building the given configurations
+     * @param configs Build configuration names of the startup project's active target
+     * @param errorMessage Set if nothing was started
+     */
+    bool start(const QStringList &configs, QString &errorMessage);
+
+    /**
+     * @brief Stops the running build and skips the remaining configurations
+     */
+    void cancel();
+
+    bool isRunning() const;
+    QJsonObject report() const;
+
+    static constexpr int MaxReportedErrors = 5;
+
+signals:
+    /**
+     * @brief Emitted when a configuration starts or finishes building
+     */
+    void progress(const QJsonObject &entry);
+    void finished(bool success, const QJsonObject &report);
+
+private:
+    struct ConfigRun
+    {
+        QPointer<ProjectExplorer::BuildConfiguration> config;
+        QString name;
+        QString state = "queued";   // queued, configuring, building, succeeded, failed, cancelled, skipped
+        QString error;
+        QElapsedTimer timer;
+        qint64 durationMs = -1;
+        int errors = 0;
+        int warnings = 0;
+        QStringList firstErrors;
+    };
+
+    void startNext();
+    bool buildCurrent();
+    void configFinished(bool success);
+    void restoreActiveConfig();
+    void taskAdded(const ProjectExplorer::Task &task);
+    QJsonObject entryFor(const ConfigRun &run) const;
+
+    MCPParseTracker *m_parseTracker;
+    QMetaObject::Connection m_parseWait;   // set while the current configuration is parsed
+    QPointer<ProjectExplorer::BuildConfiguration> m_originalConfig;
+    QList<ConfigRun> m_runs;
+    int m_current = -1;
+    bool m_running = false;
+    bool m_cancelled = false;
+    bool m_startPending = false;   // configFinished() has queued startNext()
+    QElapsedTimer m_timer;
+    qint64 m_totalMs = 0;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPBUILDMATRIX_H
@@ -1,4 +1,6 @@
 #include "mcpcommands.h"
+#include "mcpdurations.h"
+#include "mcpactions.h"
 #include "issuesmanager.h"
 
 #include <coreplugin/icore.h>
@@ -16,14 +18,16 @@
 #include <projectexplorer/buildmanager.h>
 #include <projectexplorer/runcontrol.h>
 #include <projectexplorer/runconfiguration.h>
+#include <projectexplorer/projectexplorer.h>
+#include <projectexplorer/projectnodes.h>
 #include <debugger/debuggerruncontrol.h>
 #include <utils/fileutils.h>
+#include <utils/link.h>
 #include <utils/id.h>
 
 #include <QApplication>
 #include <QDebug>
 #include <QThread>
-#include <QProcess>
 #include <QFile>
 
 namespace Qt_MCP_Plugin {
@@ -37,7 +41,8 @@ MCPCommands::MCPCommands(QObject *parent)
             this, &MCPCommands::handleSessionLoadRequest, 
             Qt::QueuedConnection);
     
-    // Initialize default method timeouts (in seconds)
+    // Initialize default method timeouts (in seconds), used until the
+    // duration history has enough samples for the current project
     m_methodTimeouts["debug"] = 60;
     m_methodTimeouts["build"] = 1200;  // 20 minutes
     m_methodTimeouts["runProject"] = 60;
@@ -46,6 +51,42 @@ MCPCommands::MCPCommands(QObject *parent)
     
     // Initialize issues manager
     m_issuesManager = new IssuesManager(this);
+    
+    connectEventSignals();
+}
+
+void MCPCommands::connectEventSignals()
+{
+    ProjectExplorer::BuildManager *buildManager = ProjectExplorer::BuildManager::instance();
+    connect(buildManager, &ProjectExplorer::BuildManager::buildStateChanged,
+            this, [this](ProjectExplorer::Project *project) {
+        if (!m_buildRunning && ProjectExplorer::BuildManager::isBuilding()) {
+            m_buildRunning = true;
+            emit buildStarted(project ? project->displayName() : QString());
+        }
+    });
+    connect(buildManager, &ProjectExplorer::BuildManager::buildQueueFinished,
+            this, [this](bool success) {
+        m_buildRunning = false;
+        finishMeasurement(m_buildMeasurement, success);
+        emit buildFinished(success);
+    });
+    
+    // A run is measured up to the moment its process is started
+    connect(ProjectExplorer::ProjectExplorerPlugin::instance(), &ProjectExplorer::ProjectExplorerPlugin::runControlStarted,
+            this, [this](ProjectExplorer::RunControl *) {
+        finishMeasurement(m_runMeasurement, true);
+    });
+    
+    connect(m_issuesManager, &IssuesManager::issuesChanged,
+            this, &MCPCommands::issuesChanged);
+    
+    connect(ProjectExplorer::ProjectManager::instance(), &ProjectExplorer::ProjectManager::startupProjectChanged,
+            this, [this](ProjectExplorer::Project *project) {
+        emit startupProjectChanged(project ? project->displayName() : QString());
+    });
+    connect(Core::SessionManager::instance(), &Core::SessionManager::sessionLoaded,
+            this, &MCPCommands::sessionLoaded);
 }
 
 bool MCPCommands::build()
@@ -74,6 +115,7 @@ bool MCPCommands::build()
     }
 
     qDebug() << "Starting build for project:" << project->displayName();
+    startMeasurement(m_buildMeasurement, "build");
     
     // Trigger build
     ProjectExplorer::BuildManager::buildProjectWithoutDependencies(project);
@@ -113,65 +155,29 @@ QString MCPCommands::debug()
     results.append("Run configuration: " + runConfig->displayName());
     results.append("");
     
-    // Helper function to check if kJams process is running (cross-platform)
-    auto checkProcessRunning = []() -> bool {
-        QProcess checkProcess;
-#ifdef Q_OS_WIN
-        // Windows: Use tasklist with proper filtering
-        checkProcess.start("tasklist", QStringList() << "/FI" << "IMAGENAME eq kJams.exe" << "/FO" << "CSV");
-        checkProcess.waitForFinished(2000);
-        QString output = QString::fromUtf8(checkProcess.readAllStandardOutput());
-        // On Windows, tasklist returns CSV format, look for kJams.exe
-        return output.contains("kJams.exe", Qt::CaseInsensitive);
-#else
-        // macOS/Linux: Use ps command (existing functionality preserved)
-        checkProcess.start("ps", QStringList() << "aux");
-        checkProcess.waitForFinished(2000);
-        QString output = QString::fromUtf8(checkProcess.readAllStandardOutput());
-        return output.contains("kJams", Qt::CaseInsensitive);
-#endif
-    };
-    
     // Trigger debug action on main thread
     results.append("=== STARTING DEBUG SESSION ===");
     
-    Core::ActionManager *actionManager = Core::ActionManager::instance();
-    if (actionManager) {
-        // Try multiple common debug action IDs
-        QStringList debugActionIds = {
-            "Debugger.StartDebugging",
-            "ProjectExplorer.StartDebugging", 
-            "Debugger.Debug",
-            "ProjectExplorer.Debug",
-            "Debugger.StartDebuggingOfStartupProject",
-            "ProjectExplorer.StartDebuggingOfStartupProject"
-        };
-        
-        bool debugTriggered = false;
-        for (const QString &debugActionId : debugActionIds) {
-            results.append("Trying debug action: " + debugActionId);
-            
-            Core::Command *command = actionManager->command(Utils::Id::fromString(debugActionId));
-            if (command && command->action()) {
-                results.append("Found debug action, triggering...");
-                command->action()->trigger();
-                results.append("Debug action triggered successfully");
-                debugTriggered = true;
-                break;
-            } else {
-                results.append("Debug action not found: " + debugActionId);
-            }
-        }
-        
-        if (!debugTriggered) {
-            results.append("ERROR: No debug action found among tried IDs");
-            return results.join("\n");
-        }
-    } else {
-        results.append("ERROR: ActionManager not available");
+    // Candidate ids are resolved through the action index, one hash lookup each
+    QStringList debugActionIds = {
+        "Debugger.StartDebugging",
+        "ProjectExplorer.StartDebugging", 
+        "Debugger.Debug",
+        "ProjectExplorer.Debug",
+        "Debugger.StartDebuggingOfStartupProject",
+        "ProjectExplorer.StartDebuggingOfStartupProject"
+    };
+    
+    QString debugActionId;
+    Core::Command *command = MCPActionIndex::findFirst(debugActionIds, &debugActionId);
+    if (!command) {
+        results.append("ERROR: No debug action found among: " + debugActionIds.join(", "));
         return results.join("\n");
     }
     
+    command->action()->trigger();
+    results.append("Debug action triggered: " + debugActionId);
+    
     results.append("Debug session initiated successfully!");
     results.append("The debugger is now starting in the background.");
     results.append("Check Qt Creator's debugger output for progress updates.");
@@ -189,13 +195,6 @@ QString MCPCommands::stopDebug()
     QStringList results;
     results.append("=== STOP DEBUGGING ===");
     
-    // Use ActionManager to trigger the "Stop Debugging" action
-    Core::ActionManager *actionManager = Core::ActionManager::instance();
-    if (!actionManager) {
-        results.append("ERROR: ActionManager not available");
-        return results.join("\n");
-    }
-    
     // Try different possible action IDs for stopping debugging
     QStringList stopActionIds = {
         "Debugger.StopDebugger",
@@ -205,20 +204,12 @@ QString MCPCommands::stopDebug()
         "Debugger.StopDebugging"
     };
     
-    bool actionTriggered = false;
-    for (const QString &actionId : stopActionIds) {
-        results.append("Trying stop debug action: " + actionId);
-        
-        Core::Command *command = actionManager->command(Utils::Id::fromString(actionId));
-        if (command && command->action()) {
-            results.append("Found stop debug action, triggering...");
-            command->action()->trigger();
-            results.append("Stop debug action triggered successfully");
-            actionTriggered = true;
-            break;
-        } else {
-            results.append("Stop debug action not found: " + actionId);
-        }
+    QString stopActionId;
+    Core::Command *command = MCPActionIndex::findFirst(stopActionIds, &stopActionId);
+    bool actionTriggered = command != nullptr;
+    if (actionTriggered) {
+        command->action()->trigger();
+        results.append("Stop debug action triggered: " + stopActionId);
     }
     
     if (!actionTriggered) {
@@ -259,6 +250,51 @@ bool MCPCommands::openFile(const QString &path)
     return true;
 }
 
+QJsonArray MCPCommands::openFiles(const QJsonArray &files, bool activateLast)
+{
+    QJsonArray results;
+    int opened = 0;
+    
+    for (int i = 0; i < files.size(); ++i) {
+        const QJsonObject item = files.at(i).toObject();
+        const QString path = item.value("path").toString();
+        const int line = item.value("line").toInt(0);
+        const int column = item.value("column").toInt(0);
+        
+        QJsonObject entry;
+        entry["path"] = path;
+        
+        // A failed open shows a modal error in Qt Creator, so missing files
+        // are reported here; the stat is the one the editor would do anyway
+        const Utils::FilePath filePath = Utils::FilePath::fromString(path);
+        if (path.isEmpty() || !filePath.isFile()) {
+            entry["success"] = false;
+            entry["error"] = path.isEmpty() ? QString("path is required")
+                                            : QString("File does not exist: %1").arg(path);
+            results.append(entry);
+            continue;
+        }
+        
+        const bool activateB = activateLast && i == files.size() - 1;
+        Core::EditorManager::OpenEditorFlags flags = Core::EditorManager::NoFlags;
+        if (!activateB) {
+            flags |= Core::EditorManager::DoNotChangeCurrentEditor | Core::EditorManager::DoNotSwitchToEditMode;
+        }
+        
+        Core::IEditor *editor = Core::EditorManager::openEditorAt(Utils::Link(filePath, line, column), {}, flags);
+        entry["success"] = editor != nullptr;
+        if (editor) {
+            ++opened;
+        } else {
+            entry["error"] = QString("Qt Creator could not open %1").arg(path);
+        }
+        results.append(entry);
+    }
+    
+    qDebug() << "Opened" << opened << "of" << files.size() << "file(s)";
+    return results;
+}
+
 QStringList MCPCommands::listProjects()
 {
     QStringList projects;
@@ -396,13 +432,7 @@ bool MCPCommands::runProject()
     }
 
     qDebug() << "Running project:" << project->displayName();
-    
-    // Use ActionManager to trigger the "Run" action
-    Core::ActionManager *actionManager = Core::ActionManager::instance();
-    if (!actionManager) {
-        qDebug() << "ActionManager not available";
-        return false;
-    }
+    startMeasurement(m_runMeasurement, "runProject");
     
     // Try different possible action IDs for running
     QStringList runActionIds = {
@@ -411,15 +441,12 @@ bool MCPCommands::runProject()
         "ProjectExplorer.RunStartupProject"
     };
     
-    bool actionTriggered = false;
-    for (const QString &actionId : runActionIds) {
-        Core::Command *command = actionManager->command(Utils::Id::fromString(actionId));
-        if (command && command->action()) {
-            qDebug() << "Triggering run action:" << actionId;
-            command->action()->trigger();
-            actionTriggered = true;
-            break;
-        }
+    QString runActionId;
+    Core::Command *command = MCPActionIndex::findFirst(runActionIds, &runActionId);
+    bool actionTriggered = command != nullptr;
+    if (actionTriggered) {
+        qDebug() << "Triggering run action:" << runActionId;
+        command->action()->trigger();
     }
     
     if (!actionTriggered) {
@@ -448,6 +475,7 @@ bool MCPCommands::cleanProject()
         ProjectExplorer::BuildConfiguration *buildConfig = target->activeBuildConfiguration();
         if (buildConfig) {
             qDebug() << "Cleaning project:" << project->displayName();
+            startMeasurement(m_buildMeasurement, "cleanProject");
             ProjectExplorer::BuildManager::cleanProjectWithoutDependencies(project);
             return true;
         }
@@ -457,6 +485,86 @@ bool MCPCommands::cleanProject()
     return false;
 }
 
+void MCPCommands::cancelBuild()
+{
+    if (ProjectExplorer::BuildManager::isBuilding()) {
+        qDebug() << "Cancelling build queue";
+        ProjectExplorer::BuildManager::cancel();
+    }
+}
+
+bool MCPCommands::compileFile(const QString &path, QString &errorMessage)
+{
+    Utils::FilePath filePath = Utils::FilePath::fromString(path);
+    if (path.isEmpty() || !filePath.exists()) {
+        errorMessage = QString("File does not exist: %1").arg(path);
+        return false;
+    }
+    
+    ProjectExplorer::Project *project = ProjectExplorer::ProjectManager::projectForFile(filePath);
+    if (!project) {
+        errorMessage = QString("File does not belong to an open project: %1").arg(path);
+        return false;
+    }
+    
+    // "Compile File" works on the current editor, and the build system
+    // plugins enable it when the editor changes
+    Core::EditorManager::openEditor(filePath);
+    
+    // CMake and qmake each register their own Compile File action
+    QStringList buildFileActionIds = {
+        "CMakeProject.BuildFile",
+        "Qt4Builder.BuildFile"
+    };
+    
+    for (const QString &actionId : buildFileActionIds) {
+        Core::Command *command = MCPActionIndex::find(actionId);
+        if (command && command->action() && command->action()->isEnabled()) {
+            qDebug() << "Compiling file:" << path << "via" << actionId;
+            startMeasurement(m_buildMeasurement, "compileFile");
+            command->action()->trigger();
+            return true;
+        }
+    }
+    
+    errorMessage = QString("Compile File is not available for %1 (only CMake and qmake projects support it)").arg(path);
+    return false;
+}
+
+bool MCPCommands::buildTarget(const QString &name, QString &errorMessage)
+{
+    ProjectExplorer::Project *project = ProjectExplorer::ProjectManager::startupProject();
+    if (!project || !project->rootProjectNode()) {
+        errorMessage = "No current project";
+        return false;
+    }
+    
+    // Build system targets (CMake targets, qmake sub-projects) are product nodes
+    ProjectExplorer::ProjectNode *targetNode = nullptr;
+    QStringList available;
+    project->rootProjectNode()->forEachProjectNode([&](const ProjectExplorer::ProjectNode *node) {
+        if (!node->isProduct()) {
+            return;
+        }
+        available.append(node->displayName());
+        if (!targetNode && (node->displayName() == name || node->buildKey() == name)) {
+            targetNode = const_cast<ProjectExplorer::ProjectNode *>(node);
+        }
+    });
+    
+    if (!targetNode) {
+        available.removeDuplicates();
+        errorMessage = QString("Unknown target '%1'. Available targets: %2").arg(name, available.join(", "));
+        return false;
+    }
+    
+    qDebug() << "Building target:" << targetNode->displayName() << "of project" << project->displayName();
+    startMeasurement(m_buildMeasurement, "buildTarget");
+    targetNode->build();
+    
+    return true;
+}
+
 QStringList MCPCommands::listOpenFiles()
 {
     QStringList files;
@@ -519,6 +627,7 @@ bool MCPCommands::loadSession(const QString &sessionName)
     
     // Reset result flag
     m_sessionLoadResult = false;
+    m_sessionLoadPending = true;
     
     // Emit signal to load session on main thread
     emit sessionLoadRequested(sessionName);
@@ -546,14 +655,25 @@ void MCPCommands::handleSessionLoadRequest(const QString &sessionName)
     qDebug() << "Handling session load request on main thread:" << sessionName;
     
     // Load session on main thread
+    QElapsedTimer timer;
+    timer.start();
     bool success = Core::SessionManager::loadSession(sessionName);
     m_sessionLoadResult = success;
     
     if (success) {
         qDebug() << "Session loaded successfully on main thread:" << sessionName;
+        MCPDurationHistory::instance().record("loadSession", sessionName, QString(), timer.elapsed());
     } else {
         qDebug() << "Failed to load session on main thread:" << sessionName;
     }
+    
+    m_sessionLoadPending = false;
+    emit sessionLoadFinished(success);
+}
+
+bool MCPCommands::isSessionLoadPending() const
+{
+    return m_sessionLoadPending;
 }
 
 bool MCPCommands::saveSession()
@@ -614,6 +734,23 @@ QString MCPCommands::getMethodMetadata()
         results.append(QString("  %1: %2").arg(method, -20).arg(timeoutStr));
     }
     
+    results.append("");
+    results.append("=== MEASURED DURATIONS ===");
+    results.append("");
+    
+    for (const QString &method : {QString("build"), QString("cleanProject"), QString("runProject"), QString("loadSession")}) {
+        QJsonObject prediction = getDurationPrediction(method);
+        if (prediction.value("samples").toInt() == 0) {
+            results.append(QString("  %1: no measurements yet").arg(method, -20));
+            continue;
+        }
+        results.append(QString("  %1: average %2 ms, p90 %3 ms (%4 samples)")
+                       .arg(method, -20)
+                       .arg(prediction.value("ewmaMs").toInteger())
+                       .arg(prediction.value("p90Ms").toInteger())
+                       .arg(prediction.value("samples").toInt()));
+    }
+    
     results.append("");
     results.append("=== METHOD DESCRIPTIONS ===");
     results.append("");
@@ -661,8 +798,9 @@ QString MCPCommands::setMethodMetadata(const QString &method, int timeoutSeconds
     }
     
     // Store the new timeout value
-    int oldTimeout = m_methodTimeouts.value(method, -1);
+    int oldTimeout = getMethodTimeout(method);
     m_methodTimeouts[method] = timeoutSeconds;
+    m_timeoutOverrides.insert(method);
     
     results.append("Method: " + method);
     results.append("Previous timeout: " + (oldTimeout >= 0 ? QString::number(oldTimeout) + " seconds" : QString("not set")));
@@ -670,6 +808,7 @@ QString MCPCommands::setMethodMetadata(const QString &method, int timeoutSeconds
     results.append("");
     results.append("Timeout updated successfully!");
     results.append("Note: This change affects the timeout hints shown in method responses.");
+    results.append("Measured durations no longer replace this value.");
     results.append("The actual operation timeouts are still controlled by Qt Creator's internal mechanisms.");
     
     results.append("");
@@ -681,9 +820,82 @@ QString MCPCommands::setMethodMetadata(const QString &method, int timeoutSeconds
 
 int MCPCommands::getMethodTimeout(const QString &method) const
 {
+    if (!m_timeoutOverrides.contains(method)) {
+        QJsonObject prediction = getDurationPrediction(method);
+        if (prediction.value("samples").toInt() >= MCPDurationHistory::MinSamples) {
+            return prediction.value("suggestedTimeoutSeconds").toInt();
+        }
+    }
     return m_methodTimeouts.value(method, -1);
 }
 
+QJsonObject MCPCommands::getDurationPrediction(const QString &method, const QString &project,
+                                               const QString &buildConfig) const
+{
+    QString projectName = project;
+    QString configName = buildConfig;
+    if (method == "loadSession") {
+        // Sessions are measured by name, there is no build configuration
+        if (projectName.isEmpty()) {
+            projectName = Core::SessionManager::activeSession();
+        }
+        configName.clear();
+    } else if (projectName.isEmpty()) {
+        currentContext(projectName, configName);
+    }
+    
+    QJsonObject result;
+    MCPDurationHistory::Prediction prediction;
+    if (MCPDurationHistory::instance().predict(method, projectName, configName, prediction)) {
+        result = prediction.toJson();
+    } else {
+        result["samples"] = 0;
+    }
+    result[method == "loadSession" ? "session" : "project"] = projectName;
+    if (method != "loadSession") {
+        result["buildConfig"] = configName;
+    }
+    return result;
+}
+
+void MCPCommands::currentContext(QString &project, QString &buildConfig) const
+{
+    ProjectExplorer::Project *startupProject = ProjectExplorer::ProjectManager::startupProject();
+    if (!startupProject) {
+        return;
+    }
+    
+    project = startupProject->displayName();
+    if (ProjectExplorer::Target *target = startupProject->activeTarget()) {
+        if (ProjectExplorer::BuildConfiguration *config = target->activeBuildConfiguration()) {
+            buildConfig = config->displayName();
+        }
+    }
+}
+
+void MCPCommands::startMeasurement(PendingMeasurement &measurement, const QString &method)
+{
+    measurement.method = method;
+    measurement.project.clear();
+    measurement.buildConfig.clear();
+    currentContext(measurement.project, measurement.buildConfig);
+    measurement.timer.start();
+}
+
+void MCPCommands::finishMeasurement(PendingMeasurement &measurement, bool success)
+{
+    if (!measurement.timer.isValid()) {
+        return;
+    }
+    
+    // Failed and cancelled operations say nothing about the usual duration
+    if (success) {
+        MCPDurationHistory::instance().record(measurement.method, measurement.project,
+                                              measurement.buildConfig, measurement.timer.elapsed());
+    }
+    measurement.timer.invalidate();
+}
+
 
 // handleSessionLoadRequest method removed - using direct session loading instead
 
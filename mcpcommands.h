@@ -4,6 +4,10 @@
 #include <QObject>
 #include <QStringList>
 #include <QMap>
+#include <QSet>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QJsonArray>
 
 // Forward declarations
 namespace Qt_MCP_Plugin {
@@ -27,6 +31,10 @@ public:
     QString debug();
     QString stopDebug();
     bool openFile(const QString &path);
+    
+    // Opens [{path, line, column}] in one pass; the last one is activated
+    // if activateLast is set, the others open without changing the current editor
+    QJsonArray openFiles(const QJsonArray &files, bool activateLast);
     QStringList listProjects();
     QStringList listBuildConfigs();
     bool switchToBuildConfig(const QString &name);
@@ -38,6 +46,11 @@ public:
     QString getCurrentBuildConfig();
     bool runProject();
     bool cleanProject();
+    void cancelBuild();
+    
+    // Fast inner-loop builds; errorMessage says why nothing was started
+    bool compileFile(const QString &path, QString &errorMessage);
+    bool buildTarget(const QString &name, QString &errorMessage);
     QStringList listOpenFiles();
     
     // Session management commands
@@ -45,6 +58,8 @@ public:
     QString getCurrentSession();
     bool loadSession(const QString &sessionName);
     bool saveSession();
+    // True from a loadSession() call until the queued load has run
+    bool isSessionLoadPending() const;
     
     // Issue management commands
     QStringList listIssues();
@@ -54,19 +69,51 @@ public:
     QString setMethodMetadata(const QString &method, int timeoutSeconds);
     int getMethodTimeout(const QString &method) const;
     
+    // Measured durations for the current project and build configuration
+    // (current session for loadSession) unless given explicitly
+    QJsonObject getDurationPrediction(const QString &method, const QString &project = QString(),
+                                      const QString &buildConfig = QString()) const;
+    
 
 signals:
     void sessionLoadRequested(const QString &sessionName);
 
+    // IDE events relayed to MCP clients as notifications
+    void buildStarted(const QString &projectName);
+    void buildFinished(bool success);
+    void issuesChanged(int errorCount, int warningCount);
+    void startupProjectChanged(const QString &projectName);
+    void sessionLoaded(const QString &sessionName);
+    void sessionLoadFinished(bool success);
+
 private slots:
     void handleSessionLoadRequest(const QString &sessionName);
 
 private:
+    // An operation started by this instance whose duration is being measured
+    struct PendingMeasurement
+    {
+        QString method;
+        QString project;
+        QString buildConfig;
+        QElapsedTimer timer;
+    };
+
     bool hasValidProject() const;
+    void connectEventSignals();
+    void startMeasurement(PendingMeasurement &measurement, const QString &method);
+    void finishMeasurement(PendingMeasurement &measurement, bool success);
+    void currentContext(QString &project, QString &buildConfig) const;
     bool m_sessionLoadResult;
+    bool m_sessionLoadPending = false;
+    bool m_buildRunning = false;
     
-    // Method timeout storage
+    // Method timeout storage: defaults until enough durations were measured,
+    // values set through setMethodMetadata() always win
     QMap<QString, int> m_methodTimeouts;
+    QSet<QString> m_timeoutOverrides;
+    PendingMeasurement m_buildMeasurement;
+    PendingMeasurement m_runMeasurement;
     
     // Issues management
     IssuesManager *m_issuesManager;
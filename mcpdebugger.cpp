@@ -0,0 +1,253 @@
+#include "mcpdebugger.h"
+#include "mcpactions.h"
+
+#include <coreplugin/actionmanager/actionmanager.h>
+#include <coreplugin/actionmanager/command.h>
+
+#include <QAbstractItemView>
+#include <QAction>
+#include <QApplication>
+#include <QDebug>
+#include <QTimer>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+namespace {
+
+// JSON keys for the columns of the debugger's models, in column order
+const QStringList threadKeys = {"id", "address", "function", "file", "line", "state", "name",
+                                "targetId", "details", "core"};
+const QStringList stackKeys = {"level", "function", "file", "line", "address"};
+
+QStringList watchKeys(const QAbstractItemModel *model)
+{
+    // Newer debuggers have a (hidden) time column after the name
+    return model->columnCount() > 3 ? QStringList{"name", "time", "value", "type"}
+                                    : QStringList{"name", "value", "type"};
+}
+
+} // namespace
+
+QAbstractItemView *findDebuggerView(const QString &key)
+{
+    QAbstractItemView *found = nullptr;
+    for (QWidget *widget : QApplication::allWidgets()) {
+        auto view = qobject_cast<QAbstractItemView *>(widget);
+        if (!view || !view->model()) {
+            continue;
+        }
+
+        bool matchB = QString(view->windowTitle()).remove('&') == key;
+        QWidget *w = view;
+        for (int level = 0; w && level < 3 && !matchB; ++level, w = w->parentWidget()) {
+            const QString name = w->objectName();
+            matchB = name.startsWith("Debugger") && name.contains(key, Qt::CaseInsensitive);
+        }
+        if (!matchB) {
+            continue;
+        }
+
+        if (!found || (view->isVisible() && !found->isVisible())) {
+            found = view;
+        }
+    }
+    return found;
+}
+
+MCPDebuggerInspector::MCPDebuggerInspector(QObject *parent)
+    : QObject(parent)
+    , m_settleTimerP(new QTimer(this))
+{
+    m_settleTimerP->setSingleShot(true);
+    connect(m_settleTimerP, &QTimer::timeout, this, [this] {
+        if (m_paused) {
+            emit paused(snapshot(Limits()));
+        }
+    });
+
+    // The debugger registers its actions after this plugin is initialized
+    attach();
+    connect(Core::ActionManager::instance(), &Core::ActionManager::commandListChanged,
+            this, &MCPDebuggerInspector::attach);
+}
+
+void MCPDebuggerInspector::attach()
+{
+    if (m_continueAction) {
+        return;
+    }
+
+    Core::Command *command = MCPActionIndex::find("Debugger.Continue");
+    if (!command || !command->action()) {
+        return;
+    }
+
+    m_continueAction = command->action();
+    connect(m_continueAction, &QAction::changed, this, &MCPDebuggerInspector::updateState);
+    qDebug() << "Debugger inspector attached to the Continue action";
+    updateState();
+}
+
+bool MCPDebuggerInspector::isPaused() const
+{
+    return m_paused;
+}
+
+void MCPDebuggerInspector::updateState()
+{
+    const bool pausedB = m_continueAction && m_continueAction->isEnabled();
+    if (pausedB == m_paused) {
+        return;
+    }
+
+    m_paused = pausedB;
+    m_views.clear();
+    if (m_paused) {
+        // Stack and locals arrive shortly after the stop, wait until they settle
+        m_pausedSince.start();
+        watchModels();
+        m_settleTimerP->start(SettleMs);
+    } else {
+        m_settleTimerP->stop();
+        emit resumed();
+    }
+}
+
+void MCPDebuggerInspector::watchModels()
+{
+    for (const QMetaObject::Connection &connection : std::as_const(m_modelConnections)) {
+        disconnect(connection);
+    }
+    m_modelConnections.clear();
+
+    auto restartSettle = [this] {
+        if (m_paused && m_settleTimerP->isActive() && m_pausedSince.elapsed() < MaxSettleMs) {
+            m_settleTimerP->start(SettleMs);
+        }
+    };
+
+    for (const QString &key : {QString("Stack"), QString("Locals")}) {
+        QAbstractItemView *itemView = view(key);
+        if (!itemView || !itemView->model()) {
+            continue;
+        }
+        QAbstractItemModel *model = itemView->model();
+        m_modelConnections.append(connect(model, &QAbstractItemModel::modelReset, this, restartSettle));
+        m_modelConnections.append(connect(model, &QAbstractItemModel::rowsInserted, this, restartSettle));
+        m_modelConnections.append(connect(model, &QAbstractItemModel::dataChanged, this, restartSettle));
+    }
+}
+
+QAbstractItemView *MCPDebuggerInspector::view(const QString &key) const
+{
+    auto it = m_views.constFind(key);
+    if (it != m_views.cend() && (it->view || !it->found)) {
+        return it->view;
+    }
+
+    QAbstractItemView *found = findDebuggerView(key);
+    m_views.insert(key, CachedView{found, found != nullptr});
+    return found;
+}
+
+QJsonObject MCPDebuggerInspector::readRow(const QAbstractItemModel *model, const QModelIndex &parent, int row,
+                                          const QStringList &keys) const
+{
+    QJsonObject entry;
+    for (int column = 0; column < model->columnCount(parent); ++column) {
+        const QString value = model->index(row, column, parent).data(Qt::DisplayRole).toString();
+        if (value.isEmpty()) {
+            continue;
+        }
+        const QString key = column < keys.size() ? keys.at(column) : QString("column%1").arg(column);
+        entry[key] = value.size() > MaxValueLength ? value.left(MaxValueLength) + "..." : value;
+    }
+    return entry;
+}
+
+QJsonArray MCPDebuggerInspector::readRows(QAbstractItemView *view, const QStringList &keys, int limit,
+                                          bool &truncated) const
+{
+    QJsonArray rows;
+    if (!view) {
+        return rows;
+    }
+
+    const QAbstractItemModel *model = view->model();
+    const QModelIndex root = view->rootIndex();
+    const int count = model->rowCount(root);
+    truncated = truncated || count > limit;
+    for (int row = 0; row < qMin(count, limit); ++row) {
+        rows.append(readRow(model, root, row, keys));
+    }
+    return rows;
+}
+
+QJsonArray MCPDebuggerInspector::readTree(const QAbstractItemModel *model, const QModelIndex &parent, int depth,
+                                          const Limits &limits, const QString &filter, bool &truncated) const
+{
+    QJsonArray items;
+    const int count = model->rowCount(parent);
+    for (int row = 0; row < count; ++row) {
+        if (items.size() >= limits.maxChildren) {
+            truncated = true;
+            break;
+        }
+
+        const QModelIndex index = model->index(row, 0, parent);
+        if (!filter.isEmpty() && !index.data().toString().contains(filter, Qt::CaseInsensitive)) {
+            continue;
+        }
+
+        QJsonObject item = readRow(model, parent, row, watchKeys(model));
+        if (model->hasChildren(index)) {
+            // Children the engine has not fetched yet are not requested here
+            if (depth + 1 < limits.maxDepth && model->rowCount(index) > 0) {
+                item["children"] = readTree(model, index, depth + 1, limits, QString(), truncated);
+            } else {
+                item["hasChildren"] = true;
+                truncated = truncated || depth + 1 >= limits.maxDepth;
+            }
+        }
+        items.append(item);
+    }
+    return items;
+}
+
+QJsonObject MCPDebuggerInspector::snapshot(const Limits &limits) const
+{
+    QJsonObject result;
+    result["paused"] = m_paused;
+
+    bool threadsTruncatedB = false;
+    bool framesTruncatedB = false;
+    bool localsTruncatedB = false;
+
+    QAbstractItemView *threadsView = view("Threads");
+    QAbstractItemView *stackView = view("Stack");
+    QAbstractItemView *localsView = view("Locals");
+    if (!stackView && !localsView) {
+        result["available"] = false;
+        result["message"] = "No debugger views found; is a debug session running?";
+        return result;
+    }
+
+    result["available"] = true;
+    result["threads"] = readRows(threadsView, threadKeys, 256, threadsTruncatedB);
+    result["stack"] = readRows(stackView, stackKeys, limits.maxFrames, framesTruncatedB);
+    if (localsView) {
+        result["locals"] = readTree(localsView->model(), localsView->rootIndex(), 0, limits,
+                                    limits.varFilter, localsTruncatedB);
+    }
+
+    QJsonObject truncated;
+    truncated["threads"] = threadsTruncatedB;
+    truncated["frames"] = framesTruncatedB;
+    truncated["locals"] = localsTruncatedB;
+    result["truncated"] = truncated;
+    return result;
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
@@ -0,0 +1,100 @@
+#ifndef MCPDEBUGGER_H
+#define MCPDEBUGGER_H
+
+#include <QObject>
+#include <QPointer>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QModelIndex>
+
+class QAbstractItemView;
+class QAction;
+class QTimer;
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+/**
+ * @brief Finds one of the debugger's item views
+ *
+ * Debugger views (or the search wrappers around them) are named like
+ * "Debugger.Dock.Stack.<engine>"; a window title equal to the key is the
+ * fallback. With several engines the visible view wins.
+ */
+QAbstractItemView *findDebuggerView(const QString &key);
+
+/**
+ * @brief Reads the debugger's threads, stack and locals in one pass
+ *
+ * The Debugger plugin does not export its engine or watch handler, so the
+ * inspector reads the item models behind the debugger's Threads, Stack and
+ * Locals views, found by object name like IssuesManager finds the
+ * TaskWindow. Whether the inferior is stopped follows the enabled state of
+ * the "Continue" action. Once stopped and the views have settled, a
+ * snapshot is taken and reported through paused().
+ *
+ * Values are reported under fixed keys per column, so the result does not
+ * depend on the UI language. The views are looked up once per stop, since
+ * finding them means walking every widget of the application.
+ */
+class MCPDebuggerInspector : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MCPDebuggerInspector(QObject *parent = nullptr);
+
+    struct Limits
+    {
+        int maxFrames = 20;
+        int maxDepth = 2;
+        int maxChildren = 100;
+        QString varFilter;      // substring of top-level variable names
+    };
+
+    /**
+     * @brief Collects threads, stack and locals
+     */
+    QJsonObject snapshot(const Limits &limits) const;
+
+    bool isPaused() const;
+
+    static constexpr int SettleMs = 100;
+    static constexpr int MaxSettleMs = 1000;
+    static constexpr int MaxValueLength = 1000;
+
+signals:
+    void paused(const QJsonObject &snapshot);
+    void resumed();
+
+private:
+    void attach();
+    void updateState();
+    void watchModels();
+    QAbstractItemView *view(const QString &key) const;
+    QJsonArray readRows(QAbstractItemView *view, const QStringList &keys, int limit, bool &truncated) const;
+    QJsonArray readTree(const QAbstractItemModel *model, const QModelIndex &parent, int depth,
+                        const Limits &limits, const QString &filter, bool &truncated) const;
+    QJsonObject readRow(const QAbstractItemModel *model, const QModelIndex &parent, int row,
+                        const QStringList &keys) const;
+
+    struct CachedView
+    {
+        QPointer<QAbstractItemView> view;
+        bool found = false;
+    };
+
+    QPointer<QAction> m_continueAction;
+    mutable QHash<QString, CachedView> m_views;   // cleared whenever the debuggee stops or resumes
+    bool m_paused = false;
+    QTimer *m_settleTimerP;
+    QElapsedTimer m_pausedSince;
+    QList<QMetaObject::Connection> m_modelConnections;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPDEBUGGER_H
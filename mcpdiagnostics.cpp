@@ -0,0 +1,193 @@
+#include "mcpdiagnostics.h"
+
+#include <coreplugin/editormanager/documentmodel.h>
+#include <cplusplus/CppDocument.h>
+#include <cppeditor/cppmodelmanager.h>
+#include <texteditor/textdocument.h>
+#include <texteditor/textmark.h>
+#include <utils/theme/theme.h>
+
+#include <QDebug>
+#include <QTimer>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+namespace {
+
+TextEditor::TextDocument *openTextDocument(const QString &path)
+{
+    Core::IDocument *document = Core::DocumentModel::documentForFilePath(Utils::FilePath::fromString(path));
+    return qobject_cast<TextEditor::TextDocument *>(document);
+}
+
+} // namespace
+
+MCPDiagnostics::MCPDiagnostics(QObject *parent)
+    : QObject(parent)
+    , m_pollTimerP(new QTimer(this))
+{
+    m_pollTimerP->setInterval(PollMs);
+    connect(m_pollTimerP, &QTimer::timeout, this, &MCPDiagnostics::poll);
+
+    connect(CppEditor::CppModelManager::instance(), &CppEditor::CppModelManager::documentUpdated,
+            this, [this](const CPlusPlus::Document::Ptr &document) {
+        const QString path = document->filePath().toFSPathString();
+        if (m_watched.contains(path)) {
+            check(path);
+        }
+    });
+}
+
+QJsonArray MCPDiagnostics::collect(const QString &path) const
+{
+    QJsonArray diagnostics;
+
+    if (TextEditor::TextDocument *document = openTextDocument(path)) {
+        for (TextEditor::TextMark *mark : document->marks()) {
+            const std::optional<Utils::Theme::Color> color = mark->color();
+            if (!color) {
+                continue;
+            }
+            QString severity;
+            if (*color == Utils::Theme::CodeModel_Error_TextMarkColor) {
+                severity = "error";
+            } else if (*color == Utils::Theme::CodeModel_Warning_TextMarkColor) {
+                severity = "warning";
+            } else {
+                continue;
+            }
+
+            QJsonObject diagnostic;
+            diagnostic["line"] = mark->lineNumber();
+            diagnostic["severity"] = severity;
+            diagnostic["message"] = mark->lineAnnotation().isEmpty() ? mark->toolTip() : mark->lineAnnotation();
+            diagnostic["source"] = mark->category().displayName;
+            diagnostics.append(diagnostic);
+        }
+        return diagnostics;
+    }
+
+    const CPlusPlus::Document::Ptr document
+        = CppEditor::CppModelManager::snapshot().document(Utils::FilePath::fromString(path));
+    if (!document) {
+        return diagnostics;
+    }
+    for (const CPlusPlus::Document::DiagnosticMessage &message : document->diagnosticMessages()) {
+        QJsonObject diagnostic;
+        diagnostic["line"] = message.line();
+        diagnostic["column"] = message.column();
+        diagnostic["severity"] = message.isWarning() ? "warning" : "error";
+        diagnostic["message"] = message.text();
+        diagnostic["source"] = "C++ code model";
+        diagnostics.append(diagnostic);
+    }
+    return diagnostics;
+}
+
+QJsonObject MCPDiagnostics::fileEntry(const QString &path, const QJsonArray &diagnostics) const
+{
+    int errors = 0;
+    int warnings = 0;
+    for (const QJsonValue &diagnostic : diagnostics) {
+        if (diagnostic.toObject().value("severity") == "error") {
+            ++errors;
+        } else {
+            ++warnings;
+        }
+    }
+
+    QJsonObject entry;
+    entry["path"] = path;
+    entry["errors"] = errors;
+    entry["warnings"] = warnings;
+    return entry;
+}
+
+QJsonArray MCPDiagnostics::diagnostics(const QStringList &paths)
+{
+    QStringList files = paths;
+    if (files.isEmpty()) {
+        for (Core::IDocument *document : Core::DocumentModel::openedDocuments()) {
+            if (qobject_cast<TextEditor::TextDocument *>(document)) {
+                files.append(document->filePath().toFSPathString());
+            }
+        }
+    }
+
+    QJsonArray result;
+    for (const QString &path : std::as_const(files)) {
+        const QJsonArray current = collect(path);
+        m_last.insert(path, current);
+        const bool openB = openTextDocument(path);
+        if (!openB && m_watched.size() < MaxWatchedFiles) {
+            m_watched.insert(path);
+        }
+
+        QJsonObject entry = fileEntry(path, current);
+        entry["diagnostics"] = current;
+        entry["followed"] = openB || m_watched.contains(path);
+        result.append(entry);
+    }
+    return result;
+}
+
+void MCPDiagnostics::check(const QString &path)
+{
+    const QJsonArray current = collect(path);
+    const QJsonArray previous = m_last.value(path);
+    if (current == previous) {
+        return;
+    }
+    m_last.insert(path, current);
+
+    QJsonArray added;
+    QJsonArray removed;
+    diff(previous, current, added, removed);
+
+    // Only the order changed
+    if (added.isEmpty() && removed.isEmpty()) {
+        return;
+    }
+
+    QJsonObject delta = fileEntry(path, current);
+    delta["added"] = added;
+    delta["removed"] = removed;
+    emit diagnosticsChanged(delta);
+}
+
+void MCPDiagnostics::setActive(bool active)
+{
+    if (active == m_pollTimerP->isActive()) {
+        return;
+    }
+    if (active) {
+        m_pollTimerP->start();
+    } else {
+        m_pollTimerP->stop();
+    }
+}
+
+void MCPDiagnostics::poll()
+{
+    QSet<QString> openPaths;
+    for (Core::IDocument *document : Core::DocumentModel::openedDocuments()) {
+        if (qobject_cast<TextEditor::TextDocument *>(document)) {
+            const QString path = document->filePath().toFSPathString();
+            openPaths.insert(path);
+            check(path);
+        }
+    }
+
+    // Forget documents that were closed unless a client asked for them
+    for (auto it = m_last.begin(); it != m_last.end();) {
+        if (!openPaths.contains(it.key()) && !m_watched.contains(it.key())) {
+            it = m_last.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
@@ -0,0 +1,85 @@
+#ifndef MCPDIAGNOSTICS_H
+#define MCPDIAGNOSTICS_H
+
+#include <QObject>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QSet>
+#include <QStringList>
+
+class QTimer;
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+/**
+ * @brief Code model diagnostics per file, without a build
+ *
+ * For open documents the diagnostics are the text marks the code model
+ * backend (clangd or another language server) puts into the editor, told
+ * apart from other marks by their code model error and warning colors. For
+ * files that are not open the built-in C++ code model's parse diagnostics
+ * are used.
+ *
+ * Backends publish diagnostics asynchronously and text documents have no
+ * change signal for marks, so while someone listens (setActive()) open
+ * documents are compared against the last state every PollMs. Files that
+ * are not open are checked when the built-in code model reparses them.
+ * Changes are reported per file as added and removed diagnostics.
+ */
+class MCPDiagnostics : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MCPDiagnostics(QObject *parent = nullptr);
+
+    /**
+     * @brief Current diagnostics of the given files, or of all open documents
+     *
+     * Files that are asked for are watched for changes from then on, up to
+     * MaxWatchedFiles; each entry tells in `followed` whether it is.
+     */
+    QJsonArray diagnostics(const QStringList &paths);
+
+    /**
+     * @brief Starts or stops polling open documents for changes
+     */
+    void setActive(bool active);
+
+    /**
+     * @brief Diagnostics in current that are not in previous, and the other way round
+     *
+     * Diagnostics are compared by line, column, severity, message and source.
+     * Equal ones are matched one to one, so a repeated diagnostic that
+     * appears once more is reported as added.
+     */
+    static void diff(const QJsonArray &previous, const QJsonArray &current, QJsonArray &added, QJsonArray &removed);
+
+    static constexpr int PollMs = 500;
+    static constexpr int MaxWatchedFiles = 256;
+
+signals:
+    /**
+     * @brief One file's diagnostics changed
+     * @param delta {path, added, removed, errors, warnings}
+     */
+    void diagnosticsChanged(const QJsonObject &delta);
+
+private:
+    QJsonArray collect(const QString &path) const;
+    static QString keyOf(const QJsonObject &diagnostic);
+    QJsonObject fileEntry(const QString &path, const QJsonArray &diagnostics) const;
+    void check(const QString &path);
+    void poll();
+
+    QHash<QString, QJsonArray> m_last;   // last reported diagnostics per file
+    QSet<QString> m_watched;             // files asked for that are not open
+    QTimer *m_pollTimerP;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPDIAGNOSTICS_H
@@ -0,0 +1,42 @@
+#include "mcpdiagnostics.h"
+
+#include <QMultiHash>
+
+// The comparison of diagnostics only depends on QtCore, so it is kept apart
+// from the code model access in mcpdiagnostics.cpp and can be unit tested.
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+QString MCPDiagnostics::keyOf(const QJsonObject &diagnostic)
+{
+    // Text marks have no column, so a missing one must not make two diagnostics equal
+    return QString("%1:%2:%3:%4:%5").arg(diagnostic.value("line").toInt())
+                                    .arg(diagnostic.value("column").toInt(-1))
+                                    .arg(diagnostic.value("severity").toString(),
+                                         diagnostic.value("source").toString(),
+                                         diagnostic.value("message").toString());
+}
+
+void MCPDiagnostics::diff(const QJsonArray &previous, const QJsonArray &current, QJsonArray &added, QJsonArray &removed)
+{
+    QMultiHash<QString, QJsonObject> before;
+    for (const QJsonValue &diagnostic : previous) {
+        before.insert(keyOf(diagnostic.toObject()), diagnostic.toObject());
+    }
+
+    for (const QJsonValue &diagnostic : current) {
+        auto it = before.find(keyOf(diagnostic.toObject()));
+        if (it != before.end()) {
+            before.erase(it);
+        } else {
+            added.append(diagnostic);
+        }
+    }
+    for (const QJsonObject &diagnostic : std::as_const(before)) {
+        removed.append(diagnostic);
+    }
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
@@ -0,0 +1,351 @@
+#include "mcpdocuments.h"
+#include "mcpdocumenttext.h"
+#include "mcpeditbatch.h"
+#include "mcpprotocol.h"
+
+#include <coreplugin/documentmanager.h>
+#include <coreplugin/editormanager/documentmodel.h>
+#include <coreplugin/editormanager/editormanager.h>
+#include <texteditor/textdocument.h>
+#include <utils/filepath.h>
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <QTextBlock>
+#include <QTextCursor>
+#include <QTextDocument>
+
+#include <climits>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+namespace {
+
+// The canonical form of a buffer: its blocks joined by LF. Unlike
+// toPlainText() this keeps non-breaking spaces as they are on disk.
+QByteArray canonicalText(const QTextDocument *document)
+{
+    QString text;
+    text.reserve(document->characterCount());
+    for (QTextBlock block = document->begin(); block.isValid(); block = block.next()) {
+        if (block != document->begin()) {
+            text += '\n';
+        }
+        text += block.text();
+    }
+    return text.toUtf8();
+}
+
+// Read access to a whole file, mapped where possible
+class MappedFile
+{
+public:
+    ~MappedFile()
+    {
+        if (m_map) {
+            m_file.unmap(m_map);
+        }
+    }
+
+    bool open(const QString &path, QString &errorMessage)
+    {
+        m_file.setFileName(path);
+        if (!m_file.open(QIODevice::ReadOnly)) {
+            errorMessage = QString("Cannot read %1: %2").arg(path, m_file.errorString());
+            return false;
+        }
+        size = m_file.size();
+        m_map = size > 0 ? m_file.map(0, size) : nullptr;
+        if (m_map) {
+            data = reinterpret_cast<const char *>(m_map);
+        } else if (size > 0) {
+            // Files that cannot be mapped (pipes, some network mounts) are read
+            m_fallback = m_file.readAll();
+            data = m_fallback.constData();
+            size = m_fallback.size();
+        }
+        modified = QFileInfo(m_file).lastModified().toMSecsSinceEpoch();
+        return true;
+    }
+
+    const char *data = "";
+    qint64 size = 0;
+    qint64 modified = 0;
+
+private:
+    QFile m_file;
+    uchar *m_map = nullptr;
+    QByteArray m_fallback;
+};
+
+} // namespace
+
+MCPDocuments::MCPDocuments(QObject *parent)
+    : QObject(parent)
+{
+}
+
+TextEditor::TextDocument *MCPDocuments::textDocument(const QString &path)
+{
+    Core::IDocument *document = Core::DocumentModel::documentForFilePath(Utils::FilePath::fromString(path));
+    return qobject_cast<TextEditor::TextDocument *>(document);
+}
+
+QTextDocument *MCPDocuments::openBuffer(const QString &path)
+{
+    TextEditor::TextDocument *document = textDocument(path);
+    return document ? document->document() : nullptr;
+}
+
+QString MCPDocuments::bufferHash(const QString &path, QTextDocument *document)
+{
+    HashEntry &entry = m_hashes["buffer:" + path];
+    if (entry.hash.isEmpty() || entry.stamp != document->revision() || entry.size != document->characterCount()) {
+        entry.stamp = document->revision();
+        entry.size = document->characterCount();
+        entry.hash = MCPDocumentText::hashOf(canonicalText(document));
+    }
+    return entry.hash;
+}
+
+QString MCPDocuments::contentHash(const QString &path, QString &errorMessage)
+{
+    if (QTextDocument *document = openBuffer(path)) {
+        return bufferHash(path, document);
+    }
+
+    MappedFile file;
+    if (!file.open(path, errorMessage)) {
+        return QString();
+    }
+    return fileHash(path, file.data, file.size, file.modified);
+}
+
+QString MCPDocuments::fileHash(const QString &path, const char *data, qint64 size, qint64 modified)
+{
+    HashEntry &entry = m_hashes["file:" + path];
+    if (entry.hash.isEmpty() || entry.stamp != modified || entry.size != size) {
+        entry.stamp = modified;
+        entry.size = size;
+        entry.hash = MCPDocumentText::hashOf(MCPDocumentText::canonicalText(QByteArrayView(data, size)));
+    }
+    return entry.hash;
+}
+
+QJsonObject MCPDocuments::read(const QJsonObject &params, QString &errorMessage)
+{
+    const QString path = params.value("path").toString();
+    if (path.isEmpty()) {
+        errorMessage = "path is required";
+        return QJsonObject();
+    }
+
+    if (QTextDocument *document = openBuffer(path)) {
+        return readBuffer(path, document, params);
+    }
+    return readFile(path, params, errorMessage);
+}
+
+QJsonObject MCPDocuments::readBuffer(const QString &path, QTextDocument *document, const QJsonObject &params)
+{
+    QJsonObject result;
+    result["path"] = path;
+    result["source"] = "buffer";
+    result["modified"] = document->isModified();
+    result["hash"] = bufferHash(path, document);
+    result["lineCount"] = document->blockCount();
+    if (!params.value("knownHash").toString().isEmpty() && params.value("knownHash") == result["hash"]) {
+        result["unchanged"] = true;
+        return result;
+    }
+
+    QString content;
+    bool truncatedB = false;
+    if (params.contains("byteRange")) {
+        // Byte offsets refer to the canonical UTF-8 form the hash is computed over
+        const QByteArray bytes = canonicalText(document);
+        MCPDocumentText::Range range = MCPDocumentText::byteRange(bytes, params.value("byteRange").toObject());
+        truncatedB = MCPDocumentText::limitRange(bytes, range, MaxReadBytes);
+        content = QString::fromUtf8(bytes.constData() + range.begin, range.end - range.begin);
+        result["offset"] = range.begin;
+        result["length"] = range.end - range.begin;
+    } else {
+        const int startLine = qMax(1, params.value("startLine").toInt(1));
+        const int endLine = qMin(document->blockCount(), params.value("endLine").toInt(document->blockCount()));
+        int line = startLine;
+        qint64 bytes = 0;
+        for (QTextBlock block = document->findBlockByNumber(startLine - 1);
+             block.isValid() && line <= endLine; block = block.next(), ++line) {
+            const QString text = block.text();
+            bytes += text.size() + 1;
+            if (bytes > MaxReadBytes) {
+                truncatedB = true;
+                break;
+            }
+            content += text;
+            if (line < document->blockCount()) {
+                content += '\n';
+            }
+        }
+        result["startLine"] = startLine;
+        result["endLine"] = line - 1;
+    }
+
+    result["content"] = content;
+    result["truncated"] = truncatedB;
+    return result;
+}
+
+QJsonObject MCPDocuments::readFile(const QString &path, const QJsonObject &params, QString &errorMessage)
+{
+    MappedFile file;
+    if (!file.open(path, errorMessage)) {
+        return QJsonObject();
+    }
+    const char *data = file.data;
+    const qint64 size = file.size;
+
+    QJsonObject result;
+    result["path"] = path;
+    result["source"] = "file";
+    result["hash"] = fileHash(path, data, size, file.modified);
+    result["size"] = size;
+    if (!params.value("knownHash").toString().isEmpty() && params.value("knownHash") == result["hash"]) {
+        result["unchanged"] = true;
+        return result;
+    }
+
+    const QByteArrayView bytes(data, size);
+    MCPDocumentText::Range range{0, size};
+    if (params.contains("byteRange")) {
+        range = MCPDocumentText::byteRange(bytes, params.value("byteRange").toObject());
+        result["offset"] = range.begin;
+    } else if (params.contains("startLine") || params.contains("endLine")) {
+        range = MCPDocumentText::lineRange(bytes, params.value("startLine").toInt(1), params.value("endLine").toInt(INT_MAX));
+        result["startLine"] = range.startLine;
+        result["endLine"] = range.endLine;
+    }
+
+    const bool truncatedB = MCPDocumentText::limitRange(bytes, range, MaxReadBytes);
+    result["content"] = QString::fromUtf8(data + range.begin, range.end - range.begin);
+    result["length"] = range.end - range.begin;
+    result["truncated"] = truncatedB;
+    return result;
+}
+
+QJsonObject MCPDocuments::applyEdits(const QJsonObject &params, QString &errorMessage, int &errorCode)
+{
+    MCPEditBatch batch;
+    if (!batch.parse(params, errorMessage)) {
+        errorCode = MCPProtocol::InvalidParams;
+        return QJsonObject();
+    }
+    const QStringList &paths = batch.paths();
+    const QHash<QString, QString> &expectedHashes = batch.expectedHashes();
+
+    // Nothing changes unless every file still has the content the client saw
+    QStringList conflicts;
+    for (const QString &path : std::as_const(paths)) {
+        if (!expectedHashes.contains(path)) {
+            continue;
+        }
+        const QString hash = contentHash(path, errorMessage);
+        if (!errorMessage.isEmpty()) {
+            return QJsonObject();
+        }
+        if (hash != expectedHashes.value(path)) {
+            conflicts.append(path);
+        }
+    }
+    if (!conflicts.isEmpty()) {
+        errorCode = MCPProtocol::ContentModified;
+        errorMessage = QString("Conflict: content changed since it was read: %1").arg(conflicts.join(", "));
+        return QJsonObject();
+    }
+
+    // Resolve every range before the first change, so a bad range leaves all files untouched
+    QHash<QString, TextEditor::TextDocument *> documents;
+    QSet<QString> openedInBackground;
+    for (const QString &path : std::as_const(paths)) {
+        TextEditor::TextDocument *document = textDocument(path);
+        if (!document) {
+            Core::EditorManager::openEditor(Utils::FilePath::fromString(path), {},
+                                            Core::EditorManager::DoNotMakeVisible
+                                                | Core::EditorManager::DoNotChangeCurrentEditor
+                                                | Core::EditorManager::DoNotSwitchToEditMode);
+            document = textDocument(path);
+            if (document) {
+                openedInBackground.insert(path);
+            }
+        }
+        if (!document) {
+            errorMessage = QString("Cannot open %1 as a text document").arg(path);
+            return QJsonObject();
+        }
+        documents.insert(path, document);
+
+        QTextDocument *buffer = document->document();
+        auto position = [buffer](int line, int column, int &pos) {
+            const QTextBlock block = buffer->findBlockByNumber(line - 1);
+            if (!block.isValid() || column < 0 || column >= block.length()) {
+                return false;
+            }
+            pos = block.position() + column;
+            return true;
+        };
+
+        if (!batch.resolve(path, position, errorMessage)) {
+            errorCode = MCPProtocol::InvalidParams;
+            return QJsonObject();
+        }
+    }
+
+    const bool saveB = params.value("save").toBool(false);
+    QJsonArray files;
+    for (const QString &path : std::as_const(paths)) {
+        TextEditor::TextDocument *document = documents.value(path);
+        const QList<MCPEditBatch::Edit> fileEdits = batch.edits(path);
+
+        // Back to front, so earlier positions stay valid; one edit block is one undo step
+        QTextCursor cursor(document->document());
+        cursor.beginEditBlock();
+        for (auto it = fileEdits.crbegin(); it != fileEdits.crend(); ++it) {
+            cursor.setPosition(it->start);
+            cursor.setPosition(it->end, QTextCursor::KeepAnchor);
+            cursor.insertText(it->newText);
+        }
+        cursor.endEditBlock();
+
+        QJsonObject file;
+        file["path"] = path;
+        file["edits"] = fileEdits.size();
+        const bool savedB = saveB && Core::DocumentManager::saveDocument(document);
+        if (saveB) {
+            file["saved"] = savedB;
+        }
+        file["hash"] = bufferHash(path, document->document());
+
+        // An editor opened only for this request is closed once its changes are
+        // on disk; unsaved changes keep it open, and the client is told so
+        if (openedInBackground.contains(path)) {
+            if (savedB) {
+                m_hashes.remove("buffer:" + path);
+                Core::EditorManager::closeDocuments({document}, false);
+            } else {
+                file["openedInBackground"] = true;
+            }
+        }
+        files.append(file);
+    }
+
+    QJsonObject result;
+    result["files"] = files;
+    result["applied"] = batch.size();
+    return result;
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
@@ -0,0 +1,100 @@
+#ifndef MCPDOCUMENTS_H
+#define MCPDOCUMENTS_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+
+class QTextDocument;
+
+namespace TextEditor {
+class TextDocument;
+}
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+/**
+ * @brief Reads documents by line or byte range
+ *
+ * A file that is open in an editor is served from its text buffer, so
+ * unsaved edits are included. Other files are memory-mapped and only the
+ * requested range is decoded. Every read returns a hash of the whole
+ * content; a client that passes the hash it already has gets no content
+ * back while the document is unchanged. Hashes are cached per buffer
+ * revision and per file size and modification time.
+ *
+ * Buffer and file are hashed in one canonical form, the UTF-8 text without
+ * byte order mark and with LF line endings, so opening a file in an editor
+ * does not change its hash. Byte ranges refer to the same form for buffers
+ * and are widened to whole UTF-8 sequences.
+ */
+class MCPDocuments : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MCPDocuments(QObject *parent = nullptr);
+
+    /**
+     * @brief Reads a range of a document
+     * @param params {path, startLine, endLine} (1-based, inclusive) or
+     *        {path, byteRange: {offset, length}}; no range reads everything.
+     *        {knownHash} skips the content if it still matches.
+     * @param errorMessage Set if the file cannot be read
+     */
+    QJsonObject read(const QJsonObject &params, QString &errorMessage);
+
+    /**
+     * @brief Applies range edits to one or more documents
+     *
+     * Expected hashes of all files are checked before anything changes. Each
+     * file's edits are applied in one edit block, so they form one undo step.
+     * Files that are not open are opened in the background first; they are
+     * closed again once saved, and reported as openedInBackground otherwise.
+     *
+     * @param params {edits: [{path, range: {startLine, startColumn, endLine,
+     *        endColumn}, newText, expectedHash}], expectedHash, save}.
+     *        Lines are 1-based, columns 0-based. The top-level expectedHash
+     *        is only allowed when all edits touch one file.
+     * @param errorCode Set to ContentModified if a file changed since the
+     *        client read it, or to InvalidParams for malformed edits
+     */
+    QJsonObject applyEdits(const QJsonObject &params, QString &errorMessage, int &errorCode);
+
+    /**
+     * @brief Returns the hash of the current content of a document
+     *
+     * Uses the editor buffer when the file is open, otherwise the file.
+     */
+    QString contentHash(const QString &path, QString &errorMessage);
+
+    /**
+     * @brief Returns the editor buffer of an open text document, or nullptr
+     */
+    static QTextDocument *openBuffer(const QString &path);
+
+    static constexpr qint64 MaxReadBytes = 4 * 1024 * 1024;
+
+private:
+    struct HashEntry
+    {
+        qint64 stamp = 0;   // buffer revision or file modification time
+        qint64 size = 0;
+        QString hash;
+    };
+
+    static TextEditor::TextDocument *textDocument(const QString &path);
+    QString bufferHash(const QString &path, QTextDocument *document);
+    QString fileHash(const QString &path, const char *data, qint64 size, qint64 modified);
+    QJsonObject readBuffer(const QString &path, QTextDocument *document, const QJsonObject &params);
+    QJsonObject readFile(const QString &path, const QJsonObject &params, QString &errorMessage);
+
+    QHash<QString, HashEntry> m_hashes;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPDOCUMENTS_H
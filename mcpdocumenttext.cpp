@@ -0,0 +1,85 @@
+#include "mcpdocumenttext.h"
+
+#include <QCryptographicHash>
+
+#include <cstring>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+namespace MCPDocumentText {
+
+QString hashOf(const QByteArray &canonical)
+{
+    return QString::fromLatin1(QCryptographicHash::hash(canonical, QCryptographicHash::Sha1).toHex());
+}
+
+QByteArray canonicalText(QByteArrayView content)
+{
+    if (content.startsWith("\xEF\xBB\xBF")) {
+        content = content.sliced(3);
+    }
+    QString text = QString::fromUtf8(content);
+    text.replace("\r\n", "\n");
+    return text.toUtf8();
+}
+
+qint64 sequenceStart(QByteArrayView data, qint64 offset)
+{
+    while (offset > 0 && offset < data.size() && (uchar(data[offset]) & 0xC0) == 0x80) {
+        --offset;
+    }
+    return offset;
+}
+
+Range byteRange(QByteArrayView data, const QJsonObject &range)
+{
+    const qint64 size = data.size();
+    Range result;
+    result.begin = sequenceStart(data, qBound<qint64>(0, range.value("offset").toInteger(0), size));
+    result.end = result.begin + qBound<qint64>(0, range.value("length").toInteger(size - result.begin),
+                                               size - result.begin);
+    return result;
+}
+
+Range lineRange(QByteArrayView data, int startLine, int endLine)
+{
+    const char *bytes = data.data();
+    const qint64 size = data.size();
+    auto nextLine = [bytes, size](qint64 pos) {
+        const void *newline = std::memchr(bytes + pos, '\n', size - pos);
+        return newline ? static_cast<const char *>(newline) - bytes + 1 : size;
+    };
+
+    Range result;
+    result.startLine = qMax(1, startLine);
+    int line = 1;
+    qint64 pos = 0;
+    while (line < result.startLine && pos < size) {
+        pos = nextLine(pos);
+        ++line;
+    }
+    result.begin = pos;
+    while (line <= endLine && pos < size) {
+        pos = nextLine(pos);
+        ++line;
+    }
+    result.end = pos;
+    result.endLine = line - 1;
+    if (result.begin == 0 && data.startsWith("\xEF\xBB\xBF")) {
+        result.begin = qMin<qint64>(3, result.end);   // the byte order mark is not part of the first line
+    }
+    return result;
+}
+
+bool limitRange(QByteArrayView data, Range &range, qint64 maxBytes)
+{
+    const bool truncatedB = range.end - range.begin > maxBytes;
+    range.end = sequenceStart(data, qMin(range.end, range.begin + maxBytes));
+    return truncatedB;
+}
+
+} // namespace MCPDocumentText
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
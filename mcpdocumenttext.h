@@ -0,0 +1,71 @@
+#ifndef MCPDOCUMENTTEXT_H
+#define MCPDOCUMENTTEXT_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QJsonObject>
+#include <QString>
+
+// This header only depends on QtCore; MCPDocuments uses it to hash and cut
+// file content, and the unit tests use it without a running Qt Creator.
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+namespace MCPDocumentText {
+
+/**
+ * @brief A byte range of UTF-8 content, and the lines it covers for line ranges
+ */
+struct Range
+{
+    qint64 begin = 0;
+    qint64 end = 0;
+    int startLine = 0;
+    int endLine = 0;   // the last line reached, which may be before the requested one
+};
+
+/**
+ * @brief Returns the hash readDocument and applyEdits report for canonical text
+ */
+QString hashOf(const QByteArray &canonical);
+
+/**
+ * @brief Returns file content in canonical form, as the editor would load it
+ *
+ * The UTF-8 byte order mark is dropped and CRLF line endings become LF.
+ */
+QByteArray canonicalText(QByteArrayView content);
+
+/**
+ * @brief Moves a byte offset back to the start of the UTF-8 sequence it points into
+ */
+qint64 sequenceStart(QByteArrayView data, qint64 offset);
+
+/**
+ * @brief Resolves a readDocument byteRange against data
+ * @param range {offset, length}; both are clamped to data, a missing length
+ *        reads to the end. The start is widened to a whole UTF-8 sequence.
+ */
+Range byteRange(QByteArrayView data, const QJsonObject &range);
+
+/**
+ * @brief Finds the bytes of lines startLine to endLine (1-based, inclusive)
+ *
+ * Only data up to the end of endLine is scanned. The line terminators are
+ * part of the range, a byte order mark before the first line is not.
+ */
+Range lineRange(QByteArrayView data, int startLine, int endLine);
+
+/**
+ * @brief Cuts range down to at most maxBytes, ending on a whole UTF-8 sequence
+ * @return true if the range was cut
+ */
+bool limitRange(QByteArrayView data, Range &range, qint64 maxBytes);
+
+} // namespace MCPDocumentText
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPDOCUMENTTEXT_H
@@ -0,0 +1,153 @@
+#include "mcpdurations.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include <algorithm>
+#include <cmath>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+int MCPDurationHistory::Prediction::suggestedTimeoutSeconds() const
+{
+    // Half again the p90 covers the usual jitter, never less than five seconds
+    const qint64 basisMs = qMax(p90Ms, ewmaMs);
+    return qMax(5, int(std::ceil(basisMs * 1.5 / 1000.0)));
+}
+
+QJsonObject MCPDurationHistory::Prediction::toJson() const
+{
+    QJsonObject result;
+    result["samples"] = samples;
+    result["ewmaMs"] = ewmaMs;
+    result["p90Ms"] = p90Ms;
+    result["lastMs"] = lastMs;
+    result["suggestedTimeoutSeconds"] = suggestedTimeoutSeconds();
+    return result;
+}
+
+void MCPDurationHistory::setSaveHandler(const SaveHandler &handler)
+{
+    m_saveHandler = handler;
+}
+
+QString MCPDurationHistory::keyFor(const QString &method, const QString &project, const QString &buildConfig)
+{
+    return method + QChar('\n') + project + QChar('\n') + buildConfig;
+}
+
+void MCPDurationHistory::record(const QString &method, const QString &project, const QString &buildConfig,
+                                qint64 durationMs)
+{
+    if (durationMs < 0) {
+        return;
+    }
+
+    Entry &entry = m_entries[keyFor(method, project, buildConfig)];
+    entry.method = method;
+    entry.project = project;
+    entry.buildConfig = buildConfig;
+    entry.ewmaMs = entry.count == 0 ? double(durationMs)
+                                    : EwmaWeight * durationMs + (1.0 - EwmaWeight) * entry.ewmaMs;
+    entry.count++;
+    entry.recentMs.append(durationMs);
+    if (entry.recentMs.size() > RecentSamples) {
+        entry.recentMs.removeFirst();
+    }
+    entry.updated = QDateTime::currentMSecsSinceEpoch();
+
+    qDebug() << "Measured" << method << "for" << project << buildConfig << ":" << durationMs << "ms,"
+             << "average now" << qint64(entry.ewmaMs) << "ms";
+
+    evict();
+    if (m_saveHandler) {
+        m_saveHandler(toJson());
+    }
+}
+
+bool MCPDurationHistory::predict(const QString &method, const QString &project, const QString &buildConfig,
+                                 Prediction &prediction) const
+{
+    auto it = m_entries.constFind(keyFor(method, project, buildConfig));
+    if (it == m_entries.cend() || it->recentMs.isEmpty()) {
+        return false;
+    }
+
+    QList<qint64> sorted = it->recentMs;
+    std::sort(sorted.begin(), sorted.end());
+
+    // Nearest-rank p90 over the recent samples
+    const int rank = int(std::ceil(0.9 * sorted.size()));
+    prediction.samples = it->count;
+    prediction.ewmaMs = qint64(it->ewmaMs);
+    prediction.p90Ms = sorted.at(qBound(0, rank - 1, int(sorted.size()) - 1));
+    prediction.lastMs = it->recentMs.last();
+    return true;
+}
+
+void MCPDurationHistory::evict()
+{
+    while (m_entries.size() > MaxEntries) {
+        auto oldest = m_entries.begin();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (it->updated < oldest->updated) {
+                oldest = it;
+            }
+        }
+        m_entries.erase(oldest);
+    }
+}
+
+void MCPDurationHistory::fromJson(const QByteArray &json)
+{
+    const QJsonArray entries = QJsonDocument::fromJson(json).array();
+    for (const QJsonValue &value : entries) {
+        const QJsonObject object = value.toObject();
+        Entry entry;
+        entry.method = object.value("m").toString();
+        entry.project = object.value("p").toString();
+        entry.buildConfig = object.value("c").toString();
+        entry.count = object.value("n").toInt();
+        entry.ewmaMs = object.value("e").toDouble();
+        entry.updated = qint64(object.value("t").toDouble());
+        for (const QJsonValue &sample : object.value("s").toArray()) {
+            entry.recentMs.append(qint64(sample.toDouble()));
+        }
+
+        if (!entry.method.isEmpty() && entry.count > 0 && !entry.recentMs.isEmpty()) {
+            m_entries.insert(keyFor(entry.method, entry.project, entry.buildConfig), entry);
+        }
+    }
+    evict();
+
+    qDebug() << "Loaded duration history with" << m_entries.size() << "entries";
+}
+
+QByteArray MCPDurationHistory::toJson() const
+{
+    QJsonArray entries;
+    for (const Entry &entry : m_entries) {
+        QJsonArray samples;
+        for (qint64 sample : entry.recentMs) {
+            samples.append(sample);
+        }
+
+        QJsonObject object;
+        object["m"] = entry.method;
+        object["p"] = entry.project;
+        object["c"] = entry.buildConfig;
+        object["n"] = entry.count;
+        object["e"] = std::round(entry.ewmaMs);
+        object["t"] = entry.updated;
+        object["s"] = samples;
+        entries.append(object);
+    }
+
+    return QJsonDocument(entries).toJson(QJsonDocument::Compact);
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
@@ -0,0 +1,113 @@
+#ifndef MCPDURATIONS_H
+#define MCPDURATIONS_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+
+#include <functional>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+/**
+ * @brief Measured durations of long-running operations
+ *
+ * Durations are kept per method, project and build configuration (loadSession
+ * uses the session name as project). Each entry holds an exponentially
+ * weighted moving average and the most recent samples for a p90 estimate.
+ * The history is shared by all MCPCommands instances through instance(),
+ * which persists it in the Qt Creator settings as compact JSON. The history
+ * itself only depends on QtCore; the settings glue is in
+ * mcpdurationsettings.cpp.
+ */
+class MCPDurationHistory
+{
+public:
+    struct Prediction
+    {
+        int samples = 0;
+        qint64 ewmaMs = 0;
+        qint64 p90Ms = 0;
+        qint64 lastMs = 0;
+
+        /**
+         * @brief Timeout hint with head room above the p90 duration
+         */
+        int suggestedTimeoutSeconds() const;
+        QJsonObject toJson() const;
+    };
+
+    using SaveHandler = std::function<void(const QByteArray &json)>;
+
+    /**
+     * @brief Creates an empty history that is not persisted
+     */
+    MCPDurationHistory() = default;
+
+    /**
+     * @brief The shared history, loaded from and saved to the Qt Creator settings
+     */
+    static MCPDurationHistory &instance();
+
+    /**
+     * @brief Sets the function that stores the history after every record()
+     */
+    void setSaveHandler(const SaveHandler &handler);
+
+    /**
+     * @brief Serializes all entries as compact JSON
+     */
+    QByteArray toJson() const;
+
+    /**
+     * @brief Adds the entries serialized by toJson(), skipping malformed ones
+     */
+    void fromJson(const QByteArray &json);
+
+    /**
+     * @brief Adds a measured duration and saves the history
+     */
+    void record(const QString &method, const QString &project, const QString &buildConfig, qint64 durationMs);
+
+    /**
+     * @brief Looks up the prediction for an operation
+     * @return false if the operation was never measured
+     */
+    bool predict(const QString &method, const QString &project, const QString &buildConfig,
+                 Prediction &prediction) const;
+
+    /**
+     * @brief Enough samples to replace the static default timeout
+     */
+    static constexpr int MinSamples = 3;
+
+    static constexpr double EwmaWeight = 0.3;
+    static constexpr int RecentSamples = 20;
+    static constexpr int MaxEntries = 200;
+
+private:
+    struct Entry
+    {
+        QString method;
+        QString project;
+        QString buildConfig;
+        int count = 0;
+        double ewmaMs = 0;
+        QList<qint64> recentMs;   // oldest first, at most RecentSamples
+        qint64 updated = 0;       // msecs since epoch, for evicting stale entries
+    };
+
+    static QString keyFor(const QString &method, const QString &project, const QString &buildConfig);
+    void evict();
+
+    QHash<QString, Entry> m_entries;
+    SaveHandler m_saveHandler;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPDURATIONS_H
@@ -0,0 +1,39 @@
+#include "mcpdurations.h"
+
+#include <coreplugin/icore.h>
+#include <utils/qtcsettings.h>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+namespace {
+
+const char SettingsKey[] = "Qt_MCP_Plugin/DurationHistory";
+
+MCPDurationHistory loadFromSettings()
+{
+    MCPDurationHistory history;
+    Utils::QtcSettings *settings = Core::ICore::settings();
+    if (!settings) {
+        return history;
+    }
+
+    history.fromJson(settings->value(SettingsKey).toByteArray());
+    history.setSaveHandler([](const QByteArray &json) {
+        if (Utils::QtcSettings *settings = Core::ICore::settings()) {
+            settings->setValue(SettingsKey, json);
+        }
+    });
+    return history;
+}
+
+} // namespace
+
+MCPDurationHistory &MCPDurationHistory::instance()
+{
+    static MCPDurationHistory history = loadFromSettings();
+    return history;
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
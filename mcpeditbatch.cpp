@@ -0,0 +1,70 @@
+#include "mcpeditbatch.h"
+
+#include <QJsonArray>
+
+#include <algorithm>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+bool MCPEditBatch::parse(const QJsonObject &params, QString &errorMessage)
+{
+    const QJsonArray edits = params.value("edits").toArray();
+    for (int i = 0; i < edits.size(); ++i) {
+        const QJsonObject item = edits.at(i).toObject();
+        const QString path = item.value("path").toString();
+        if (path.isEmpty() || !item.value("range").isObject()) {
+            errorMessage = QString("Edit %1 needs path and range").arg(i);
+            return false;
+        }
+        if (!m_editsByPath.contains(path)) {
+            m_paths.append(path);
+        }
+        m_editsByPath[path].append({i, item.value("range").toObject(), item.value("newText").toString()});
+        if (item.contains("expectedHash")) {
+            m_expectedHashes[path] = item.value("expectedHash").toString();
+        }
+    }
+    m_size = edits.size();
+    if (m_paths.isEmpty()) {
+        errorMessage = "No edits given";
+        return false;
+    }
+    if (params.contains("expectedHash")) {
+        // One hash cannot stand for several files, and dropping it would skip the check
+        if (m_paths.size() > 1) {
+            errorMessage = "A top-level expectedHash needs all edits in one file; give expectedHash per edit instead";
+            return false;
+        }
+        m_expectedHashes.insert(m_paths.first(), params.value("expectedHash").toString());
+    }
+    return true;
+}
+
+bool MCPEditBatch::resolve(const QString &path, const PositionFunction &position, QString &errorMessage)
+{
+    QList<Edit> &fileEdits = m_editsByPath[path];
+    for (Edit &edit : fileEdits) {
+        if (!position(edit.range.value("startLine").toInt(), edit.range.value("startColumn").toInt(), edit.start)
+            || !position(edit.range.value("endLine").toInt(), edit.range.value("endColumn").toInt(), edit.end)
+            || edit.end < edit.start) {
+            errorMessage = QString("Edit %1: range outside of %2").arg(edit.index).arg(path);
+            return false;
+        }
+    }
+
+    std::stable_sort(fileEdits.begin(), fileEdits.end(), [](const Edit &a, const Edit &b) {
+        return a.start < b.start;
+    });
+    for (int i = 1; i < fileEdits.size(); ++i) {
+        if (fileEdits.at(i).start < fileEdits.at(i - 1).end) {
+            errorMessage = QString("Edits %1 and %2 overlap in %3")
+                               .arg(fileEdits.at(i - 1).index).arg(fileEdits.at(i).index).arg(path);
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
@@ -0,0 +1,71 @@
+#ifndef MCPEDITBATCH_H
+#define MCPEDITBATCH_H
+
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include <functional>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+/**
+ * @brief The edits of one applyEdits request, checked before anything changes
+ *
+ * parse() groups the edits per file, in the order files first appear, and
+ * collects the expected hash of each file. resolve() turns one file's
+ * ranges into positions, sorts them and rejects overlapping edits.
+ *
+ * This class only depends on QtCore; MCPDocuments uses it to validate a
+ * request and supplies the positions from the editor buffers.
+ */
+class MCPEditBatch
+{
+public:
+    struct Edit
+    {
+        int index = 0;   // position in the request's edits array
+        QJsonObject range;
+        QString newText;
+        int start = 0;   // set by resolve()
+        int end = 0;
+    };
+
+    /**
+     * @brief Maps a 1-based line and 0-based column to a position
+     * @return false if the line or column is outside the document
+     */
+    using PositionFunction = std::function<bool(int line, int column, int &pos)>;
+
+    /**
+     * @brief Reads {edits: [{path, range, newText, expectedHash}], expectedHash}
+     *
+     * The top-level expectedHash is only accepted when all edits touch one file.
+     */
+    bool parse(const QJsonObject &params, QString &errorMessage);
+
+    /**
+     * @brief Resolves the ranges of one file's edits and sorts them by start
+     * @return false if a range is outside the document or two edits overlap
+     */
+    bool resolve(const QString &path, const PositionFunction &position, QString &errorMessage);
+
+    const QStringList &paths() const { return m_paths; }
+    QList<Edit> edits(const QString &path) const { return m_editsByPath.value(path); }
+    const QHash<QString, QString> &expectedHashes() const { return m_expectedHashes; }
+    int size() const { return m_size; }
+
+private:
+    QStringList m_paths;
+    QHash<QString, QList<Edit>> m_editsByPath;
+    QHash<QString, QString> m_expectedHashes;
+    int m_size = 0;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPEDITBATCH_H
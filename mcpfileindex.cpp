@@ -0,0 +1,237 @@
+#include "mcpfileindex.h"
+#include "mcpfilematcher.h"
+
+#include <projectexplorer/project.h>
+#include <projectexplorer/projectmanager.h>
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QTimer>
+
+#include <algorithm>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+MCPFileIndex::MCPFileIndex(QObject *parent)
+    : QObject(parent)
+    , m_refreshTimerP(new QTimer(this))
+{
+    m_refreshTimerP->setSingleShot(true);
+    m_refreshTimerP->setInterval(RefreshDelayMs);
+    connect(m_refreshTimerP, &QTimer::timeout, this, &MCPFileIndex::refresh);
+
+    ProjectExplorer::ProjectManager *projectManager = ProjectExplorer::ProjectManager::instance();
+    connect(projectManager, &ProjectExplorer::ProjectManager::projectAdded,
+            this, &MCPFileIndex::addProject);
+    connect(projectManager, &ProjectExplorer::ProjectManager::projectRemoved,
+            this, &MCPFileIndex::removeProject);
+
+    for (ProjectExplorer::Project *project : ProjectExplorer::ProjectManager::projects()) {
+        addProject(project);
+    }
+}
+
+void MCPFileIndex::addProject(ProjectExplorer::Project *project)
+{
+    if (!project || m_projects.contains(project)) {
+        return;
+    }
+
+    m_projects.insert(project, ProjectFiles());
+    connect(project, &ProjectExplorer::Project::fileListChanged, this, [this, project] {
+        m_dirty.insert(project);
+        m_refreshTimerP->start();
+    });
+    rebuild(project);
+}
+
+void MCPFileIndex::removeProject(ProjectExplorer::Project *project)
+{
+    disconnect(project, nullptr, this, nullptr);
+    m_projects.remove(project);
+    m_dirty.remove(project);
+    pruneDirs();
+}
+
+void MCPFileIndex::refresh()
+{
+    const QSet<ProjectExplorer::Project *> dirty = m_dirty;
+    m_dirty.clear();
+    for (ProjectExplorer::Project *project : dirty) {
+        if (m_projects.contains(project)) {
+            rebuild(project);
+        }
+    }
+}
+
+int MCPFileIndex::internDir(const QString &dir)
+{
+    auto it = m_dirIds.constFind(dir);
+    if (it != m_dirIds.constEnd()) {
+        return it.value();
+    }
+    m_dirs.append(dir);
+    m_dirIds.insert(dir, m_dirs.size() - 1);
+    return m_dirs.size() - 1;
+}
+
+void MCPFileIndex::pruneDirs()
+{
+    // Drop directories no project lists anymore and renumber the rest in order,
+    // so the entries stay sorted by directory
+    QList<int> newIds(m_dirs.size(), -1);
+    for (const ProjectFiles &files : std::as_const(m_projects)) {
+        for (const Entry &entry : files.entries) {
+            newIds[entry.dir] = 0;
+        }
+    }
+    if (!newIds.contains(-1)) {
+        return;
+    }
+
+    QStringList dirs;
+    m_dirIds.clear();
+    for (int i = 0; i < m_dirs.size(); ++i) {
+        if (newIds.at(i) == 0) {
+            newIds[i] = dirs.size();
+            m_dirIds.insert(m_dirs.at(i), dirs.size());
+            dirs.append(m_dirs.at(i));
+        }
+    }
+    m_dirs = dirs;
+
+    for (ProjectFiles &files : m_projects) {
+        for (Entry &entry : files.entries) {
+            entry.dir = newIds.at(entry.dir);
+        }
+    }
+}
+
+void MCPFileIndex::rebuild(ProjectExplorer::Project *project)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    ProjectFiles &files = m_projects[project];
+    files.name = project->displayName();
+    files.rootDir = project->projectDirectory().toFSPathString() + '/';
+
+    const Utils::FilePaths paths = project->files(ProjectExplorer::Project::SourceFiles);
+    QList<Entry> entries;
+    entries.reserve(paths.size());
+    for (const Utils::FilePath &path : paths) {
+        const QString fullPath = path.toFSPathString();
+        const int slash = fullPath.lastIndexOf('/');
+        const int start = fullPath.startsWith(files.rootDir) ? files.rootDir.size() : 0;
+        entries.append({internDir(fullPath.left(slash + 1)), fullPath.mid(start), slash + 1 - start});
+    }
+
+    std::sort(entries.begin(), entries.end(), [this](const Entry &a, const Entry &b) {
+        if (a.dir != b.dir) {
+            return m_dirs.at(a.dir) < m_dirs.at(b.dir);
+        }
+        return a.name() < b.name();
+    });
+    files.entries = entries;
+
+    // Directories of files the project dropped would otherwise pile up
+    pruneDirs();
+
+    qDebug() << "Indexed" << entries.size() << "files of" << files.name << "in" << timer.elapsed() << "ms";
+}
+
+QString MCPFileIndex::pathOf(const Entry &entry) const
+{
+    return m_dirs.at(entry.dir) + entry.name();
+}
+
+QJsonArray MCPFileIndex::find(const QString &pattern, bool fuzzy, int limit, const QString &project) const
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const MCPFileMatcher matcher(pattern, fuzzy);
+    QJsonArray result;
+
+    auto toJson = [this](const ProjectFiles &files, const Entry &entry) {
+        QJsonObject match;
+        match["path"] = pathOf(entry);
+        match["project"] = files.name;
+        return match;
+    };
+
+    if (fuzzy) {
+        struct Candidate
+        {
+            int score;
+            const ProjectFiles *files;
+            const Entry *entry;
+        };
+        QList<Candidate> candidates;
+        for (const ProjectFiles &files : m_projects) {
+            if (!project.isEmpty() && files.name != project) {
+                continue;
+            }
+            for (const Entry &entry : files.entries) {
+                const int score = matcher.match(entry.name(), entry.relativePath);
+                if (score >= 0) {
+                    candidates.append({score, &files, &entry});
+                }
+            }
+        }
+
+        const int count = qMin(limit, int(candidates.size()));
+        std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(),
+                          [](const Candidate &a, const Candidate &b) { return a.score > b.score; });
+        for (int i = 0; i < count; ++i) {
+            QJsonObject match = toJson(*candidates.at(i).files, *candidates.at(i).entry);
+            match["score"] = candidates.at(i).score;
+            result.append(match);
+        }
+    } else {
+        for (const ProjectFiles &files : m_projects) {
+            if (!project.isEmpty() && files.name != project) {
+                continue;
+            }
+            for (const Entry &entry : files.entries) {
+                if (result.size() >= limit) {
+                    break;
+                }
+                if (matcher.match(entry.name(), entry.relativePath) >= 0) {
+                    result.append(toJson(files, entry));
+                }
+            }
+        }
+    }
+
+    qDebug() << "findFiles" << pattern << "matched" << result.size() << "in" << timer.elapsed() << "ms";
+    return result;
+}
+
+QStringList MCPFileIndex::files(const QString &project) const
+{
+    QStringList paths;
+    for (const ProjectFiles &files : m_projects) {
+        if (!project.isEmpty() && files.name != project) {
+            continue;
+        }
+        for (const Entry &entry : files.entries) {
+            paths.append(pathOf(entry));
+        }
+    }
+    return paths;
+}
+
+int MCPFileIndex::fileCount() const
+{
+    int count = 0;
+    for (const ProjectFiles &files : m_projects) {
+        count += files.entries.size();
+    }
+    return count;
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
@@ -0,0 +1,96 @@
+#ifndef MCPFILEINDEX_H
+#define MCPFILEINDEX_H
+
+#include <QObject>
+#include <QHash>
+#include <QJsonArray>
+#include <QList>
+#include <QSet>
+#include <QStringList>
+
+class QTimer;
+
+namespace ProjectExplorer {
+class Project;
+}
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+/**
+ * @brief Index of the source files of all open projects
+ *
+ * Built from Project::files() and refreshed when a project reports
+ * fileListChanged (debounced, since parses emit it in bursts). Paths are
+ * stored as an interned directory plus the path relative to the project
+ * directory, whose tail is the file name. So 200k files cost one string per
+ * file and one per directory, and queries match without building strings.
+ * Build directories and other files outside the project tree are never
+ * listed by the project, so they never show up.
+ */
+class MCPFileIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MCPFileIndex(QObject *parent = nullptr);
+
+    /**
+     * @brief Finds files by glob or fuzzy name match
+     *
+     * Each file is matched by MCPFileMatcher against its name, or against its
+     * path relative to the project directory if the pattern has a '/'. Fuzzy
+     * matches are returned best first.
+     *
+     * @param project Project display name, empty for all projects
+     */
+    QJsonArray find(const QString &pattern, bool fuzzy, int limit, const QString &project) const;
+
+    /**
+     * @brief Absolute paths of all indexed files
+     * @param project Project display name, empty for all projects
+     */
+    QStringList files(const QString &project = QString()) const;
+
+    int fileCount() const;
+
+    static constexpr int RefreshDelayMs = 250;
+
+private:
+    struct Entry
+    {
+        int dir = 0;
+        QString relativePath;   // absolute for files outside the project directory
+        int nameStart = 0;
+
+        QStringView name() const { return QStringView(relativePath).mid(nameStart); }
+    };
+
+    struct ProjectFiles
+    {
+        QString name;
+        QString rootDir;   // with trailing '/'
+        QList<Entry> entries;
+    };
+
+    void addProject(ProjectExplorer::Project *project);
+    void removeProject(ProjectExplorer::Project *project);
+    void refresh();
+    void rebuild(ProjectExplorer::Project *project);
+    int internDir(const QString &dir);
+    void pruneDirs();
+    QString pathOf(const Entry &entry) const;
+
+    QHash<ProjectExplorer::Project *, ProjectFiles> m_projects;
+    QSet<ProjectExplorer::Project *> m_dirty;
+    QTimer *m_refreshTimerP;
+
+    // Directory prefixes shared by all projects, each with a trailing '/'
+    QStringList m_dirs;
+    QHash<QString, int> m_dirIds;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPFILEINDEX_H
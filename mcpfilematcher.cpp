@@ -0,0 +1,62 @@
+#include "mcpfilematcher.h"
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+MCPFileMatcher::MCPFileMatcher(const QString &pattern, bool fuzzy)
+    : m_fuzzy(fuzzy)
+    , m_pathPattern(pattern.contains('/'))
+{
+    if (fuzzy) {
+        m_needle = pattern.toLower();
+    } else {
+        // Path globs may cross directories with '*'
+        m_glob = QRegularExpression::fromWildcard(
+            pattern, Qt::CaseInsensitive,
+            m_pathPattern ? QRegularExpression::NonPathWildcardConversion
+                           : QRegularExpression::DefaultWildcardConversion);
+    }
+}
+
+int MCPFileMatcher::match(QStringView name, QStringView relativePath) const
+{
+    const QStringView text = m_pathPattern ? relativePath : name;
+    if (m_fuzzy) {
+        return fuzzyScore(m_needle, text);
+    }
+    return m_glob.matchView(text).hasMatch() ? 0 : -1;
+}
+
+// Greedy subsequence match; consecutive characters and word starts score higher
+int MCPFileMatcher::fuzzyScore(QStringView pattern, QStringView text)
+{
+    int score = 0;
+    int p = 0;
+    int lastMatch = -2;
+    for (int i = 0; i < text.size() && p < pattern.size(); ++i) {
+        const QChar c = text.at(i);
+        if (c.toLower() != pattern.at(p)) {
+            continue;
+        }
+        int bonus = 1;
+        if (i == lastMatch + 1) {
+            bonus += 5;
+        }
+        if (i == 0 || !text.at(i - 1).isLetterOrNumber() || (c.isUpper() && text.at(i - 1).isLower())) {
+            bonus += 8;
+        }
+        score += bonus;
+        lastMatch = i;
+        ++p;
+    }
+    if (p < pattern.size()) {
+        return -1;
+    }
+
+    // Among equal matches the shorter name wins. The length never outweighs
+    // a point of score, so long paths still come out as matches.
+    return score * 1024 - qMin(int(text.size()), 1023);
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
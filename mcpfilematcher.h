@@ -0,0 +1,49 @@
+#ifndef MCPFILEMATCHER_H
+#define MCPFILEMATCHER_H
+
+#include <QRegularExpression>
+#include <QString>
+#include <QStringView>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+/**
+ * @brief Matches file names and project-relative paths against a findFiles pattern
+ *
+ * A pattern without '/' is matched against the file name, one with '/'
+ * against the path relative to the project directory. Globs are case
+ * insensitive, and '*' in a path glob also crosses directories. Fuzzy
+ * patterns match as a case-insensitive subsequence and are scored so that
+ * runs of consecutive characters and word starts rank higher.
+ *
+ * This class only depends on QtCore; MCPFileIndex applies it to the index.
+ */
+class MCPFileMatcher
+{
+public:
+    MCPFileMatcher(const QString &pattern, bool fuzzy);
+
+    /**
+     * @brief Matches one indexed file
+     * @return The fuzzy score, 0 for a glob match, or -1 if the file does not match
+     */
+    int match(QStringView name, QStringView relativePath) const;
+
+    /**
+     * @brief Scores text as a greedy subsequence match of a lower-case pattern
+     * @return -1 if pattern is not a subsequence of text
+     */
+    static int fuzzyScore(QStringView pattern, QStringView text);
+
+private:
+    QString m_needle;   // lower-case fuzzy pattern
+    QRegularExpression m_glob;
+    bool m_fuzzy = false;
+    bool m_pathPattern = false;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPFILEMATCHER_H
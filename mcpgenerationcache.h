@@ -0,0 +1,85 @@
+#ifndef MCPGENERATIONCACHE_H
+#define MCPGENERATIONCACHE_H
+
+#include <QHash>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+/**
+ * @brief A cache of values derived from one parse generation
+ *
+ * Everything in it was computed from the project state of generation().
+ * update() drops all entries once the parse generation has moved on, and
+ * insert() refuses a value computed from an older generation, so work that
+ * spans event loop passes cannot put a stale result back after a reparse.
+ *
+ * This class only depends on QtCore; MCPKits caches compile flags and
+ * compilation databases in it.
+ */
+template <typename Key, typename Value>
+class MCPGenerationCache
+{
+public:
+    explicit MCPGenerationCache(quint64 generation = 0)
+        : m_generation(generation)
+    {
+    }
+
+    quint64 generation() const
+    {
+        return m_generation;
+    }
+
+    /**
+     * @brief Clears the cache if generation differs from the one it holds
+     */
+    void update(quint64 generation)
+    {
+        if (generation != m_generation) {
+            m_generation = generation;
+            m_entries.clear();
+        }
+    }
+
+    /**
+     * @return The cached value, or nullptr
+     */
+    const Value *find(const Key &key) const
+    {
+        const auto it = m_entries.constFind(key);
+        return it != m_entries.constEnd() ? &it.value() : nullptr;
+    }
+
+    /**
+     * @brief Caches a value that was computed from generation builtFrom
+     * @return false if builtFrom is not the current generation; nothing is stored
+     */
+    bool insert(const Key &key, const Value &value, quint64 builtFrom)
+    {
+        if (builtFrom != m_generation) {
+            return false;
+        }
+        m_entries.insert(key, value);
+        return true;
+    }
+
+    void remove(const Key &key)
+    {
+        m_entries.remove(key);
+    }
+
+    int size() const
+    {
+        return int(m_entries.size());
+    }
+
+private:
+    quint64 m_generation;
+    QHash<Key, Value> m_entries;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPGENERATIONCACHE_H
@@ -0,0 +1,185 @@
+#include "mcpjobs.h"
+#include "mcpprotocol.h"
+
+#include <QDebug>
+#include <QTimer>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+MCPJobRegistry::MCPJobRegistry(QObject *parent)
+    : QObject(parent)
+{
+}
+
+int MCPJobRegistry::start(const QString &method, QTcpSocket *client, const QJsonValue &requestId,
+                          const CancelFunction &cancel, const QDeadlineTimer &deadline)
+{
+    Job job;
+    job.id = m_nextJobId++;
+    job.method = method;
+    job.owner = client;
+    job.requestId = requestId;
+    job.cancel = cancel;
+    job.elapsed.start();
+    m_jobs.insert(job.id, job);
+
+    if (!deadline.isForever()) {
+        const int jobId = job.id;
+        QTimer::singleShot(qMax<qint64>(0, deadline.remainingTime()), this, [this, jobId] {
+            if (isRunning(jobId)) {
+                qDebug() << "Job" << jobId << "passed its deadline, cancelling";
+                this->cancel(jobId, State::DeadlineExceeded);
+            }
+        });
+    }
+
+    qDebug() << "Started job" << job.id << "for" << method;
+    prune();
+    return job.id;
+}
+
+void MCPJobRegistry::finish(int jobId, bool success, const QJsonObject &details)
+{
+    auto it = m_jobs.find(jobId);
+    if (it == m_jobs.end() || it->state != State::Running) {
+        return;
+    }
+
+    if (it->cancelReason != State::Running) {
+        it->state = it->cancelReason;
+    } else {
+        it->state = success ? State::Succeeded : State::Failed;
+    }
+    it->durationMs = it->elapsed.elapsed();
+    it->details = details;
+    it->cancel = CancelFunction();
+
+    qDebug() << "Job" << jobId << "finished:" << stateName(it->state);
+    emit jobFinished(jobId, status(jobId));
+}
+
+void MCPJobRegistry::finishAll(const QStringList &methods, bool success, const QJsonObject &details)
+{
+    QList<int> finished;
+    for (const Job &job : std::as_const(m_jobs)) {
+        if (job.state == State::Running && methods.contains(job.method)) {
+            finished.append(job.id);
+        }
+    }
+
+    for (int jobId : finished) {
+        finish(jobId, success, details);
+    }
+}
+
+void MCPJobRegistry::discard(int jobId)
+{
+    m_jobs.remove(jobId);
+}
+
+bool MCPJobRegistry::cancel(int jobId, State reason)
+{
+    auto it = m_jobs.find(jobId);
+    if (it == m_jobs.end() || it->state != State::Running || !it->cancel) {
+        return false;
+    }
+
+    // The job is reported once the underlying work has actually stopped
+    if (it->cancelReason == State::Running) {
+        it->cancelReason = reason;
+        CancelFunction cancelFunction = it->cancel;
+        cancelFunction();
+    }
+    return true;
+}
+
+int MCPJobRegistry::findByRequest(QTcpSocket *client, const QJsonValue &requestId) const
+{
+    // Newest first, in case a client reuses the id of a request whose job still runs
+    for (auto it = m_jobs.crbegin(); it != m_jobs.crend(); ++it) {
+        if (it->state == State::Running && it->owner == client && it->requestId == requestId) {
+            return it->id;
+        }
+    }
+    return -1;
+}
+
+bool MCPJobRegistry::contains(int jobId) const
+{
+    return m_jobs.contains(jobId);
+}
+
+bool MCPJobRegistry::isRunning(int jobId) const
+{
+    auto it = m_jobs.constFind(jobId);
+    return it != m_jobs.cend() && it->state == State::Running;
+}
+
+QJsonObject MCPJobRegistry::status(int jobId) const
+{
+    QJsonObject result;
+    auto it = m_jobs.constFind(jobId);
+    if (it == m_jobs.cend()) {
+        return result;
+    }
+
+    result["jobId"] = it->id;
+    result["method"] = it->method;
+    result["state"] = stateName(it->state);
+    result["elapsedMs"] = it->durationMs >= 0 ? it->durationMs : it->elapsed.elapsed();
+    result["cancellable"] = it->state == State::Running && bool(it->cancel);
+    if (!it->details.isEmpty()) {
+        result["details"] = it->details;
+    }
+
+    if (it->state == State::Cancelled || it->state == State::DeadlineExceeded) {
+        QJsonObject error;
+        error["code"] = MCPProtocol::RequestCancelled;
+        error["message"] = it->state == State::Cancelled ? QString("Request cancelled")
+                                                         : QString("Request deadline exceeded");
+        result["error"] = error;
+    }
+
+    return result;
+}
+
+QString MCPJobRegistry::stateName(State state)
+{
+    switch (state) {
+    case State::Running:
+        return "running";
+    case State::Succeeded:
+        return "succeeded";
+    case State::Failed:
+        return "failed";
+    case State::Cancelled:
+        return "cancelled";
+    case State::DeadlineExceeded:
+        return "deadlineExceeded";
+    }
+    return QString();
+}
+
+void MCPJobRegistry::prune()
+{
+    // Keep the most recent finished jobs around for getJobStatus
+    int finishedCount = 0;
+    for (const Job &job : m_jobs) {
+        if (job.state != State::Running) {
+            ++finishedCount;
+        }
+    }
+
+    for (auto it = m_jobs.begin(); it != m_jobs.end() && finishedCount > MaxFinishedJobs; ) {
+        if (it->state != State::Running) {
+            it = m_jobs.erase(it);
+            --finishedCount;
+        } else {
+            ++it;
+        }
+    }
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
@@ -0,0 +1,120 @@
+#ifndef MCPJOBS_H
+#define MCPJOBS_H
+
+#include <QObject>
+#include <QPointer>
+#include <QTcpSocket>
+#include <QElapsedTimer>
+#include <QDeadlineTimer>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QMap>
+#include <QStringList>
+
+#include <functional>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+/**
+ * @brief Tracks MCP operations that keep running after their request was answered
+ *
+ * Methods like build or cleanProject reply as soon as the work has started.
+ * The registry gives each such operation a job id, remembers which request
+ * started it so `$/cancelRequest` can reach it, and records the final state.
+ */
+class MCPJobRegistry : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class State {
+        Running,
+        Succeeded,
+        Failed,
+        Cancelled,
+        DeadlineExceeded
+    };
+
+    using CancelFunction = std::function<void()>;
+
+    explicit MCPJobRegistry(QObject *parent = nullptr);
+
+    /**
+     * @brief Registers a running job
+     * @param method The method that started the job
+     * @param client The client that sent the request
+     * @param requestId The id of the request
+     * @param cancel Stops the underlying work, may be empty if it cannot be stopped
+     * @param deadline The job is cancelled when the deadline passes
+     * @return The new job id
+     */
+    int start(const QString &method, QTcpSocket *client, const QJsonValue &requestId,
+              const CancelFunction &cancel, const QDeadlineTimer &deadline = QDeadlineTimer::Forever);
+
+    /**
+     * @brief Records the outcome of a job and emits jobFinished()
+     *
+     * A job whose cancellation was requested is reported as cancelled (or
+     * deadline exceeded) no matter how the underlying work ended.
+     */
+    void finish(int jobId, bool success, const QJsonObject &details = QJsonObject());
+
+    /**
+     * @brief Finishes all running jobs started by one of the given methods
+     */
+    void finishAll(const QStringList &methods, bool success, const QJsonObject &details = QJsonObject());
+
+    /**
+     * @brief Forgets a job whose work could not be started after all
+     */
+    void discard(int jobId);
+
+    /**
+     * @brief Requests cancellation of a running job
+     * @return false if the job is unknown, already finished or cannot be cancelled
+     */
+    bool cancel(int jobId, State reason = State::Cancelled);
+
+    /**
+     * @brief Finds the running job started by a request
+     * @return The job id, or -1 if there is none
+     */
+    int findByRequest(QTcpSocket *client, const QJsonValue &requestId) const;
+
+    bool contains(int jobId) const;
+    bool isRunning(int jobId) const;
+    QJsonObject status(int jobId) const;
+
+    static QString stateName(State state);
+
+signals:
+    void jobFinished(int jobId, const QJsonObject &status);
+
+private:
+    struct Job
+    {
+        int id = 0;
+        QString method;
+        QTcpSocket *owner = nullptr;
+        QJsonValue requestId;
+        State state = State::Running;
+        State cancelReason = State::Running;   // Running means no cancellation requested
+        CancelFunction cancel;
+        QElapsedTimer elapsed;
+        qint64 durationMs = -1;
+        QJsonObject details;
+    };
+
+    void prune();
+
+    QMap<int, Job> m_jobs;
+    int m_nextJobId = 1;
+
+    static constexpr int MaxFinishedJobs = 64;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPJOBS_H
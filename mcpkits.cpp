@@ -0,0 +1,336 @@
+#include "mcpkits.h"
+#include "mcpparsetracker.h"
+
+#include <cppeditor/compileroptionsbuilder.h>
+#include <cppeditor/cppmodelmanager.h>
+#include <cppeditor/projectinfo.h>
+#include <cppeditor/projectpart.h>
+#include <projectexplorer/buildconfiguration.h>
+#include <projectexplorer/kit.h>
+#include <projectexplorer/kitaspects.h>
+#include <projectexplorer/kitmanager.h>
+#include <projectexplorer/project.h>
+#include <projectexplorer/projectmanager.h>
+#include <projectexplorer/target.h>
+#include <projectexplorer/toolchain.h>
+
+#include <QTimer>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+namespace {
+
+QJsonObject toolchainInfo(const ProjectExplorer::Toolchain *toolchain)
+{
+    QJsonObject info;
+    info["name"] = toolchain->displayName();
+    info["compiler"] = toolchain->compilerCommand().toUserOutput();
+    info["abi"] = toolchain->targetAbi().toString();
+    return info;
+}
+
+QString buildDirectoryOf(const ProjectExplorer::Project *project)
+{
+    const ProjectExplorer::Target *target = project ? project->activeTarget() : nullptr;
+    const ProjectExplorer::BuildConfiguration *bc = target ? target->activeBuildConfiguration() : nullptr;
+    return bc ? bc->buildDirectory().toFSPathString() : QString();
+}
+
+// One compile_commands.json entry, with the options Qt Creator's own database
+// generator writes: no bundled clang headers or clangd tweaks, and only the
+// build system's own defines and warnings
+QJsonObject compileEntry(const CppEditor::ProjectPart &part, const Utils::FilePath &file, const QString &directory)
+{
+    CppEditor::CompilerOptionsBuilder builder(part,
+                                              CppEditor::UseSystemHeader::No,
+                                              CppEditor::UseTweakedHeaderPaths::Tools,
+                                              CppEditor::UseLanguageDefines::No,
+                                              CppEditor::UseBuildSystemWarnings::No);
+    const QStringList options = builder.build(CppEditor::ProjectFile::classify(file),
+                                              CppEditor::UsePrecompiledHeaders::No);
+
+    QJsonArray arguments;
+    arguments.append(part.compilerFilePath.toUserOutput());
+    for (const QString &option : options) {
+        arguments.append(option);
+    }
+    arguments.append(file.toFSPathString());
+
+    QJsonObject entry;
+    entry["directory"] = directory;
+    entry["file"] = file.toFSPathString();
+    entry["arguments"] = arguments;
+    return entry;
+}
+
+} // namespace
+
+MCPKits::MCPKits(MCPParseTracker *parseTracker, QObject *parent)
+    : QObject(parent)
+    , m_parseTracker(parseTracker)
+    , m_flagsCache(parseTracker->generation())
+    , m_databaseCache(parseTracker->generation())
+{
+    connect(ProjectExplorer::ProjectManager::instance(), &ProjectExplorer::ProjectManager::projectRemoved,
+            this, [this](ProjectExplorer::Project *project) {
+        m_databaseCache.remove(project);
+        for (auto it = m_exports.begin(); it != m_exports.end();) {
+            if (it->project == project) {
+                const int exportId = it.key();
+                QJsonObject report;
+                report["count"] = it->fromCacheB ? 0 : it->entries.size();
+                report["error"] = "Project was closed";
+                it = m_exports.erase(it);
+                emit finished(exportId, false, report);
+            } else {
+                ++it;
+            }
+        }
+    });
+}
+
+QJsonArray MCPKits::kits() const
+{
+    QJsonArray result;
+    const ProjectExplorer::Kit *defaultKit = ProjectExplorer::KitManager::defaultKit();
+    for (ProjectExplorer::Kit *kit : ProjectExplorer::KitManager::kits()) {
+        QJsonObject info;
+        info["name"] = kit->displayName();
+        info["id"] = kit->id().toString();
+        info["valid"] = kit->isValid();
+        info["default"] = kit == defaultKit;
+        info["deviceType"] = ProjectExplorer::DeviceTypeKitAspect::deviceTypeId(kit).toString();
+
+        const Utils::FilePath sysRoot = ProjectExplorer::SysRootKitAspect::sysRoot(kit);
+        if (!sysRoot.isEmpty()) {
+            info["sysRoot"] = sysRoot.toUserOutput();
+        }
+        if (const ProjectExplorer::Toolchain *toolchain = ProjectExplorer::ToolchainKitAspect::cToolchain(kit)) {
+            info["cToolchain"] = toolchainInfo(toolchain);
+        }
+        if (const ProjectExplorer::Toolchain *toolchain = ProjectExplorer::ToolchainKitAspect::cxxToolchain(kit)) {
+            info["cxxToolchain"] = toolchainInfo(toolchain);
+        }
+        result.append(info);
+    }
+    return result;
+}
+
+ProjectExplorer::Project *MCPKits::findProject(const QString &projectName, QString &errorMessage) const
+{
+    if (projectName.isEmpty()) {
+        ProjectExplorer::Project *project = ProjectExplorer::ProjectManager::startupProject();
+        if (!project) {
+            errorMessage = "No current project";
+        }
+        return project;
+    }
+
+    for (ProjectExplorer::Project *project : ProjectExplorer::ProjectManager::projects()) {
+        if (project->displayName() == projectName) {
+            return project;
+        }
+    }
+    errorMessage = QString("Project not found: %1").arg(projectName);
+    return nullptr;
+}
+
+QJsonArray MCPKits::targets(const QString &projectName, QString &errorMessage) const
+{
+    QJsonArray result;
+    ProjectExplorer::Project *project = findProject(projectName, errorMessage);
+    if (!project) {
+        return result;
+    }
+
+    for (ProjectExplorer::Target *target : project->targets()) {
+        QJsonObject info;
+        info["kit"] = target->kit()->displayName();
+        info["kitId"] = target->kit()->id().toString();
+        info["active"] = target == project->activeTarget();
+        info["buildConfigs"] = int(target->buildConfigurations().size());
+        if (target->activeBuildConfiguration()) {
+            info["activeBuildConfig"] = target->activeBuildConfiguration()->displayName();
+            info["buildDirectory"] = target->activeBuildConfiguration()->buildDirectory().toUserOutput();
+        }
+        result.append(info);
+    }
+    return result;
+}
+
+bool MCPKits::switchKit(const QString &kitName, QString &errorMessage)
+{
+    ProjectExplorer::Project *project = findProject(QString(), errorMessage);
+    if (!project) {
+        return false;
+    }
+
+    ProjectExplorer::Kit *kit = nullptr;
+    QStringList available;
+    for (ProjectExplorer::Kit *candidate : ProjectExplorer::KitManager::kits()) {
+        available.append(candidate->displayName());
+        if (candidate->displayName() == kitName || candidate->id().toString() == kitName) {
+            kit = candidate;
+        }
+    }
+    if (!kit) {
+        errorMessage = QString("Kit not found: %1 (available: %2)").arg(kitName, available.join(", "));
+        return false;
+    }
+
+    ProjectExplorer::Target *target = project->target(kit);
+    if (!target) {
+        if (!kit->isValid()) {
+            errorMessage = QString("Kit %1 is not valid").arg(kitName);
+            return false;
+        }
+        target = project->addTargetForKit(kit);
+        if (!target) {
+            errorMessage = QString("Could not set up %1 for kit %2").arg(project->displayName(), kitName);
+            return false;
+        }
+    }
+
+    project->setActiveTarget(target, ProjectExplorer::SetActive::Cascade);
+    return true;
+}
+
+void MCPKits::invalidateIfReparsed()
+{
+    // Project parts only change when a project is parsed
+    m_flagsCache.update(m_parseTracker->generation());
+    m_databaseCache.update(m_parseTracker->generation());
+}
+
+QJsonObject MCPKits::compileFlags(const QString &path, QString &errorMessage)
+{
+    invalidateIfReparsed();
+    if (const QJsonObject *cached = m_flagsCache.find(path)) {
+        return *cached;
+    }
+
+    const Utils::FilePath filePath = Utils::FilePath::fromString(path);
+    const QList<CppEditor::ProjectPart::ConstPtr> parts = CppEditor::CppModelManager::projectPart(filePath);
+    if (parts.isEmpty()) {
+        errorMessage = QString("%1 is not part of a parsed C/C++ project").arg(path);
+        return QJsonObject();
+    }
+
+    // A file in several parts (e.g. a library and its test) uses the first, as the editor does
+    const CppEditor::ProjectPart::ConstPtr part = parts.first();
+    QJsonObject result = compileEntry(*part, filePath,
+                                      buildDirectoryOf(ProjectExplorer::ProjectManager::projectForFile(filePath)));
+    result["projectPart"] = part->displayName;
+    result["generation"] = qint64(m_flagsCache.generation());
+    m_flagsCache.insert(path, result, m_flagsCache.generation());
+    return result;
+}
+
+int MCPKits::exportDatabase(const QString &projectName, QString &errorMessage)
+{
+    ProjectExplorer::Project *project = findProject(projectName, errorMessage);
+    if (!project) {
+        return -1;
+    }
+
+    invalidateIfReparsed();
+    const int exportId = m_nextExportId++;
+    Export &exp = m_exports[exportId];
+    exp.project = project;
+    exp.generation = m_databaseCache.generation();
+
+    // Take everything the export needs now, so a reparse or cache clear
+    // before the first slice cannot change what it sends
+    if (const QJsonArray *cached = m_databaseCache.find(project)) {
+        exp.fromCacheB = true;
+        exp.entries = *cached;
+    } else {
+        const CppEditor::ProjectInfo::ConstPtr info = CppEditor::CppModelManager::projectInfo(project);
+        if (!info) {
+            m_exports.remove(exportId);
+            errorMessage = QString("%1 has no C/C++ code model data (not parsed yet?)").arg(project->displayName());
+            return -1;
+        }
+        exp.parts = info->projectParts();
+        exp.directory = buildDirectoryOf(project);
+    }
+
+    QTimer::singleShot(0, this, [this, exportId] { exportSlice(exportId); });
+    return exportId;
+}
+
+void MCPKits::exportSlice(int exportId)
+{
+    auto it = m_exports.find(exportId);
+    if (it == m_exports.end()) {
+        return;
+    }
+
+    // A cached database only needs to be sent again
+    if (it->fromCacheB) {
+        const QJsonArray entries = it->entries;
+        for (int i = 0; i < entries.size(); i += SliceFiles) {
+            QJsonArray slice;
+            for (int j = i; j < qMin(i + SliceFiles, int(entries.size())); ++j) {
+                slice.append(entries.at(j));
+            }
+            emit chunk(exportId, slice);
+        }
+        m_exports.remove(exportId);
+        QJsonObject report;
+        report["count"] = entries.size();
+        report["cached"] = true;
+        emit finished(exportId, true, report);
+        return;
+    }
+
+    QJsonArray slice;
+    while (it->part < it->parts.size() && slice.size() < SliceFiles) {
+        const CppEditor::ProjectPart &part = *it->parts.at(it->part);
+        if (it->file >= part.files.size()) {
+            ++it->part;
+            it->file = 0;
+            continue;
+        }
+        const CppEditor::ProjectFile &file = part.files.at(it->file++);
+        if (file.active && CppEditor::ProjectFile::isSource(file.kind)) {
+            slice.append(compileEntry(part, file.path, it->directory));
+        }
+    }
+
+    for (const QJsonValue &entry : std::as_const(slice)) {
+        it->entries.append(entry);
+    }
+    if (!slice.isEmpty()) {
+        emit chunk(exportId, slice);
+    }
+
+    if (it->part < it->parts.size()) {
+        QTimer::singleShot(0, this, [this, exportId] { exportSlice(exportId); });
+        return;
+    }
+
+    // Only a database built from the current parse may be reused
+    Export exp = m_exports.take(exportId);
+    invalidateIfReparsed();
+    m_databaseCache.insert(exp.project, exp.entries, exp.generation);
+    QJsonObject report;
+    report["count"] = exp.entries.size();
+    report["cached"] = false;
+    emit finished(exportId, true, report);
+}
+
+void MCPKits::cancelExport(int exportId)
+{
+    if (!m_exports.contains(exportId)) {
+        return;
+    }
+    Export exp = m_exports.take(exportId);
+    QJsonObject report;
+    report["count"] = exp.fromCacheB ? 0 : exp.entries.size();   // a cached database is sent in one go
+    emit finished(exportId, false, report);
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
@@ -0,0 +1,109 @@
+#ifndef MCPKITS_H
+#define MCPKITS_H
+
+#include <QObject>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QSharedPointer>
+
+#include "mcpgenerationcache.h"
+
+namespace CppEditor {
+class ProjectPart;
+}
+
+namespace ProjectExplorer {
+class Project;
+}
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+class MCPParseTracker;
+
+/**
+ * @brief Kits, project targets and compiler flags from the code model
+ *
+ * Compile flags are built from the C++ code model's project parts the same
+ * way Qt Creator's "Generate Compilation Database" does, so no CMake run is
+ * needed. Flags and compilation databases are cached until the parse
+ * generation changes; an export only fills the cache if no parse finished
+ * while it ran.
+ * A database export is produced in slices of SliceFiles files, one per
+ * event loop pass, and reported through chunk().
+ */
+class MCPKits : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MCPKits(MCPParseTracker *parseTracker, QObject *parent = nullptr);
+
+    QJsonArray kits() const;
+
+    /**
+     * @brief The kits a project is set up for, and which one is active
+     * @param projectName Display name, empty for the startup project
+     */
+    QJsonArray targets(const QString &projectName, QString &errorMessage) const;
+
+    /**
+     * @brief Makes the startup project build with another kit
+     *
+     * The project is set up for the kit first if it is not yet.
+     * @param kit Kit display name or id
+     */
+    bool switchKit(const QString &kit, QString &errorMessage);
+
+    /**
+     * @brief Compiler and arguments for one file, like a compile_commands.json entry
+     */
+    QJsonObject compileFlags(const QString &path, QString &errorMessage);
+
+    /**
+     * @brief Starts producing the compilation database of a project
+     * @param projectName Display name, empty for the startup project
+     * @return An export id, or -1 with errorMessage set
+     */
+    int exportDatabase(const QString &projectName, QString &errorMessage);
+
+    /**
+     * @brief Stops an export; finished() follows with success false
+     */
+    void cancelExport(int exportId);
+
+    static constexpr int SliceFiles = 200;
+
+signals:
+    void chunk(int exportId, const QJsonArray &entries);
+    void finished(int exportId, bool success, const QJsonObject &report);
+
+private:
+    struct Export
+    {
+        ProjectExplorer::Project *project = nullptr;
+        quint64 generation = 0;   // parse generation the parts were taken from
+        bool fromCacheB = false;  // entries hold a cached database to send again
+        QList<QSharedPointer<const CppEditor::ProjectPart>> parts;
+        int part = 0;      // position of the next file to do
+        int file = 0;
+        QString directory;
+        QJsonArray entries;
+    };
+
+    ProjectExplorer::Project *findProject(const QString &projectName, QString &errorMessage) const;
+    void invalidateIfReparsed();
+    void exportSlice(int exportId);
+
+    MCPParseTracker *m_parseTracker;
+    MCPGenerationCache<QString, QJsonObject> m_flagsCache;
+    MCPGenerationCache<ProjectExplorer::Project *, QJsonArray> m_databaseCache;
+    QHash<int, Export> m_exports;
+    int m_nextExportId = 1;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPKITS_H
@@ -0,0 +1,47 @@
+#include "mcpoutputbuffer.h"
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+qint64 MCPOutputBuffer::append(const QString &stream, const QString &text)
+{
+    const qint64 seq = m_nextSeq++;
+    m_chunks.append({seq, stream, text});
+    m_bytes += text.size();
+    while (m_bytes > m_maxBytes && m_chunks.size() > 1) {
+        m_bytes -= m_chunks.first().text.size();
+        m_chunks.removeFirst();
+    }
+    return seq;
+}
+
+QList<MCPOutputBuffer::Chunk> MCPOutputBuffer::since(qint64 sinceSeq) const
+{
+    if (m_chunks.isEmpty()) {
+        return {};
+    }
+    // Sequence numbers are consecutive, so the first wanted chunk can be found directly
+    const qint64 first = qBound<qint64>(0, sinceSeq - m_chunks.first().seq, m_chunks.size());
+    return m_chunks.mid(first);
+}
+
+qint64 MCPOutputBuffer::dropped(qint64 sinceSeq) const
+{
+    const qint64 firstSeq = m_chunks.isEmpty() ? m_nextSeq : m_chunks.first().seq;
+    return qMax<qint64>(0, firstSeq - qMax<qint64>(sinceSeq, 1));
+}
+
+QString MCPOutputBuffer::text(bool &truncated) const
+{
+    truncated = !m_chunks.isEmpty() && m_chunks.first().seq > 1;
+    QString text;
+    for (const Chunk &chunk : m_chunks) {
+        if (chunk.stream != "system") {
+            text += chunk.text;
+        }
+    }
+    return text;
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
@@ -0,0 +1,69 @@
+#ifndef MCPOUTPUTBUFFER_H
+#define MCPOUTPUTBUFFER_H
+
+#include <QList>
+#include <QString>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+/**
+ * @brief A bounded buffer of sequence-numbered output chunks
+ *
+ * Chunks are numbered from 1 in the order they are appended. Once the
+ * buffer holds more than maxBytes characters the oldest chunks are dropped,
+ * but the newest chunk is always kept, so a reader asking for chunks since
+ * a sequence number can tell exactly how many it missed.
+ *
+ * This class only depends on QtCore; MCPRunRegistry keeps one per run.
+ */
+class MCPOutputBuffer
+{
+public:
+    struct Chunk
+    {
+        qint64 seq = 0;
+        QString stream;   // stdout, stderr or system
+        QString text;
+    };
+
+    explicit MCPOutputBuffer(qint64 maxBytes = 1024 * 1024)
+        : m_maxBytes(maxBytes)
+    {}
+
+    /**
+     * @brief Appends a chunk and drops the oldest ones that no longer fit
+     * @return The sequence number of the new chunk
+     */
+    qint64 append(const QString &stream, const QString &text);
+
+    /**
+     * @brief Returns the chunks with a sequence number of at least sinceSeq
+     */
+    QList<Chunk> since(qint64 sinceSeq) const;
+
+    /**
+     * @brief Counts the chunks from sinceSeq on that were already dropped
+     */
+    qint64 dropped(qint64 sinceSeq) const;
+
+    /**
+     * @brief Returns the stdout and stderr text that is still buffered, in order
+     * @param truncated Set if older output was already dropped
+     */
+    QString text(bool &truncated) const;
+
+    qint64 nextSeq() const { return m_nextSeq; }
+    qint64 bytes() const { return m_bytes; }
+
+private:
+    QList<Chunk> m_chunks;
+    qint64 m_maxBytes;
+    qint64 m_bytes = 0;
+    qint64 m_nextSeq = 1;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPOUTPUTBUFFER_H
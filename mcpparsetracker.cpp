@@ -0,0 +1,155 @@
+#include "mcpparsetracker.h"
+#include "mcpdurations.h"
+
+#include <projectexplorer/buildconfiguration.h>
+#include <projectexplorer/buildsystem.h>
+#include <projectexplorer/project.h>
+#include <projectexplorer/projectmanager.h>
+#include <projectexplorer/target.h>
+
+#include <QDebug>
+#include <QJsonArray>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+MCPParseTracker::MCPParseTracker(QObject *parent)
+    : QObject(parent)
+{
+    ProjectExplorer::ProjectManager *projectManager = ProjectExplorer::ProjectManager::instance();
+    connect(projectManager, &ProjectExplorer::ProjectManager::projectAdded,
+            this, &MCPParseTracker::addProject);
+    connect(projectManager, &ProjectExplorer::ProjectManager::projectRemoved,
+            this, &MCPParseTracker::removeProject);
+
+    for (ProjectExplorer::Project *project : ProjectExplorer::ProjectManager::projects()) {
+        addProject(project);
+    }
+}
+
+void MCPParseTracker::addProject(ProjectExplorer::Project *project)
+{
+    if (!project || m_projects.contains(project)) {
+        return;
+    }
+
+    ProjectState &state = m_projects[project];
+
+    // A project may already be parsing when it is first seen
+    ProjectExplorer::Target *target = project->activeTarget();
+    if (target && target->buildSystem() && target->buildSystem()->isParsing()) {
+        state.parsing = true;
+        state.timer.start();
+    }
+
+    connect(project, &ProjectExplorer::Project::anyParsingStarted, this, [this, project] {
+        onParsingStarted(project);
+    });
+    connect(project, &ProjectExplorer::Project::anyParsingFinished, this, [this, project](bool success) {
+        onParsingFinished(project, success);
+    });
+}
+
+void MCPParseTracker::removeProject(ProjectExplorer::Project *project)
+{
+    const bool wasParsingB = isParsing();
+    disconnect(project, nullptr, this, nullptr);
+    m_projects.remove(project);
+
+    if (wasParsingB && !isParsing()) {
+        emit idle();
+    }
+}
+
+void MCPParseTracker::onParsingStarted(ProjectExplorer::Project *project)
+{
+    ProjectState &state = m_projects[project];
+    if (state.parsing) {
+        return;
+    }
+
+    state.parsing = true;
+    state.timer.start();
+    qDebug() << "Parsing started:" << project->displayName();
+    emit parsingStarted(project->displayName());
+}
+
+void MCPParseTracker::onParsingFinished(ProjectExplorer::Project *project, bool success)
+{
+    ProjectState &state = m_projects[project];
+    if (!state.parsing) {
+        return;
+    }
+
+    state.parsing = false;
+    state.lastDurationMs = state.timer.elapsed();
+    state.lastSuccess = success;
+    state.generation = ++m_generation;
+
+    QString buildConfig;
+    ProjectExplorer::Target *target = project->activeTarget();
+    if (target && target->activeBuildConfiguration()) {
+        buildConfig = target->activeBuildConfiguration()->displayName();
+    }
+    if (success) {
+        MCPDurationHistory::instance().record("parse", project->displayName(), buildConfig, state.lastDurationMs);
+    }
+
+    qDebug() << "Parsing finished:" << project->displayName() << (success ? "successfully" : "with errors")
+             << "in" << state.lastDurationMs << "ms";
+    emit parsingFinished(project->displayName(), success, state.lastDurationMs);
+
+    if (!isParsing()) {
+        emit idle();
+    }
+}
+
+bool MCPParseTracker::isParsing() const
+{
+    for (auto it = m_projects.cbegin(); it != m_projects.cend(); ++it) {
+        if (it->parsing || isWaitingForParse(it.key())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MCPParseTracker::isWaitingForParse(ProjectExplorer::Project *project)
+{
+    ProjectExplorer::Target *target = project->activeTarget();
+    return target && target->buildSystem() && target->buildSystem()->isWaitingForParse();
+}
+
+quint64 MCPParseTracker::generation() const
+{
+    return m_generation;
+}
+
+QJsonObject MCPParseTracker::state() const
+{
+    QJsonArray projects;
+    for (auto it = m_projects.cbegin(); it != m_projects.cend(); ++it) {
+        QJsonObject entry;
+        entry["project"] = it.key()->displayName();
+        entry["parsing"] = it->parsing;
+        entry["waitingForParse"] = isWaitingForParse(it.key());
+        if (it->parsing) {
+            entry["parsingForMs"] = it->timer.elapsed();
+        }
+        if (it->lastDurationMs >= 0) {
+            entry["lastDurationMs"] = it->lastDurationMs;
+            entry["lastSuccess"] = it->lastSuccess;
+        }
+        entry["generation"] = qint64(it->generation);
+        projects.append(entry);
+    }
+
+    QJsonObject result;
+    result["parsing"] = isParsing();
+    result["generation"] = qint64(m_generation);
+    result["projects"] = projects;
+    return result;
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
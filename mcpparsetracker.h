@@ -0,0 +1,79 @@
+#ifndef MCPPARSETRACKER_H
+#define MCPPARSETRACKER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+
+namespace ProjectExplorer {
+class Project;
+}
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+/**
+ * @brief Follows the CMake/qmake/... parse state of all open projects
+ *
+ * Every project reports when any of its build systems starts and finishes
+ * parsing. The tracker keeps the state per project, counts finished parses
+ * in a generation number that callers can use to invalidate cached code
+ * model data, and records successful parse durations in the duration
+ * history under the method name "parse".
+ */
+class MCPParseTracker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MCPParseTracker(QObject *parent = nullptr);
+
+    /**
+     * @brief True while any open project is parsing or has a parse scheduled
+     *
+     * Switching the build configuration or kit only schedules a parse, so a
+     * build system that is waiting for its parse counts as parsing.
+     */
+    bool isParsing() const;
+
+    /**
+     * @brief Increases whenever a parse finishes in any project
+     */
+    quint64 generation() const;
+
+    QJsonObject state() const;
+
+signals:
+    void parsingStarted(const QString &projectName);
+    void parsingFinished(const QString &projectName, bool success, qint64 durationMs);
+
+    /**
+     * @brief Emitted when the last running parse has finished
+     */
+    void idle();
+
+private:
+    struct ProjectState
+    {
+        bool parsing = false;
+        QElapsedTimer timer;
+        qint64 lastDurationMs = -1;
+        bool lastSuccess = false;
+        quint64 generation = 0;
+    };
+
+    void addProject(ProjectExplorer::Project *project);
+    void removeProject(ProjectExplorer::Project *project);
+    void onParsingStarted(ProjectExplorer::Project *project);
+    void onParsingFinished(ProjectExplorer::Project *project, bool success);
+    static bool isWaitingForParse(ProjectExplorer::Project *project);
+
+    QHash<ProjectExplorer::Project *, ProjectState> m_projects;
+    quint64 m_generation = 0;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPPARSETRACKER_H
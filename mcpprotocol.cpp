@@ -0,0 +1,256 @@
+#include "mcpprotocol.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonParseError>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+void MCPFrameBuffer::append(const QByteArray &data)
+{
+    if (m_discarding) {
+        // Still inside an oversized message, drop everything up to its end
+        const qsizetype newline = data.indexOf('\n');
+        if (newline < 0) {
+            return;
+        }
+        m_discarding = false;
+        m_buffer.append(data.constData() + newline + 1, data.size() - newline - 1);
+    } else {
+        m_buffer.append(data);
+    }
+
+    enforceLimit();
+}
+
+bool MCPFrameBuffer::takeMessage(QByteArray &message)
+{
+    while (true) {
+        const qsizetype newline = m_buffer.indexOf('\n', m_scanOffset);
+        if (newline < 0) {
+            m_scanOffset = m_buffer.size();
+            compact();
+            return false;
+        }
+
+        const qsizetype start = m_readOffset;
+        m_readOffset = newline + 1;
+        m_scanOffset = m_readOffset;
+
+        if (newline - start > MaxMessageSize) {
+            ++m_overflowCount;
+            continue;
+        }
+
+        QByteArray line = m_buffer.mid(start, newline - start).trimmed();
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        message = line;
+        return true;
+    }
+}
+
+int MCPFrameBuffer::takeOverflowCount()
+{
+    const int count = m_overflowCount;
+    m_overflowCount = 0;
+    return count;
+}
+
+qsizetype MCPFrameBuffer::bufferedSize() const
+{
+    return m_buffer.size() - m_readOffset;
+}
+
+void MCPFrameBuffer::clear()
+{
+    m_buffer.clear();
+    m_readOffset = 0;
+    m_scanOffset = 0;
+    m_discarding = false;
+    m_overflowCount = 0;
+}
+
+void MCPFrameBuffer::compact()
+{
+    if (m_readOffset == 0) {
+        return;
+    }
+
+    m_buffer.remove(0, m_readOffset);
+    m_scanOffset -= m_readOffset;
+    m_readOffset = 0;
+}
+
+void MCPFrameBuffer::enforceLimit()
+{
+    if (bufferedSize() <= MaxMessageSize) {
+        return;
+    }
+
+    // Complete messages in front of the limit are still delivered by takeMessage()
+    const qsizetype newline = m_buffer.lastIndexOf('\n');
+    if (newline >= m_readOffset && m_buffer.size() - (newline + 1) <= MaxMessageSize) {
+        return;
+    }
+
+    // The unterminated tail can never become a valid message: drop it and
+    // skip input until the client sends the next line terminator
+    if (newline >= m_readOffset) {
+        m_buffer.truncate(newline + 1);
+        m_scanOffset = qMin(m_scanOffset, m_buffer.size());
+    } else {
+        m_buffer.clear();
+        m_readOffset = 0;
+        m_scanOffset = 0;
+    }
+    m_discarding = true;
+    ++m_overflowCount;
+}
+
+namespace MCPProtocol {
+
+bool decodeRequest(const QByteArray &message, MCPRequest &request,
+                   int &errorCode, QString &errorMessage)
+{
+    request = MCPRequest();
+
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(message, &error);
+
+    if (error.error != QJsonParseError::NoError) {
+        errorCode = ParseError;
+        errorMessage = "Parse error";
+        return false;
+    }
+
+    if (!doc.isObject()) {
+        errorCode = InvalidRequest;
+        errorMessage = "Invalid Request";
+        return false;
+    }
+
+    const QJsonObject object = doc.object();
+    request.method = object.value("method").toString();
+    request.params = object.value("params");
+    request.id = object.value("id");
+
+    QJsonValue deadline = object.value("deadlineMs");
+    if (deadline.isUndefined()) {
+        deadline = request.params.toObject().value("deadlineMs");
+    }
+    if (deadline.isDouble() && deadline.toDouble() >= 0) {
+        request.deadlineMs = qint64(qMin(deadline.toDouble(), 1e12));
+    }
+
+    QJsonValue afterParse = object.value("afterParse");
+    if (afterParse.isUndefined()) {
+        afterParse = request.params.toObject().value("afterParse");
+    }
+    request.afterParse = afterParse.toBool();
+
+    if (object.value("jsonrpc").toString() != "2.0") {
+        errorCode = InvalidRequest;
+        errorMessage = "Invalid Request: jsonrpc must be '2.0'";
+        return false;
+    }
+
+    if (request.method.isEmpty()) {
+        errorCode = InvalidRequest;
+        errorMessage = "Invalid Request: method is required";
+        return false;
+    }
+
+    return true;
+}
+
+QJsonObject errorResponse(int code, const QString &message, const QJsonValue &id)
+{
+    QJsonObject response;
+    response["jsonrpc"] = "2.0";
+    response["id"] = id;
+
+    QJsonObject error;
+    error["code"] = code;
+    error["message"] = message;
+    response["error"] = error;
+
+    return response;
+}
+
+QJsonObject successResponse(const QJsonValue &result, const QJsonValue &id)
+{
+    QJsonObject response;
+    response["jsonrpc"] = "2.0";
+    response["id"] = id;
+    response["result"] = result;
+
+    return response;
+}
+
+QByteArray encodeMessage(const QJsonObject &message)
+{
+    return QJsonDocument(message).toJson(QJsonDocument::Compact) + "\n";
+}
+
+QByteArray encodeNotification(const QString &method, const QJsonObject &params)
+{
+    QJsonObject notification;
+    notification["jsonrpc"] = "2.0";
+    notification["method"] = method;
+    notification["params"] = params;
+
+    return encodeMessage(notification);
+}
+
+QByteArray singleFlightKey(const MCPRequest &request)
+{
+    // deadlineMs and afterParse only control when the request runs, not what
+    // it returns; decodeRequest() has already read them into the request
+    QJsonValue params = request.params;
+    if (params.isObject()) {
+        QJsonObject object = params.toObject();
+        object.remove("deadlineMs");
+        object.remove("afterParse");
+        params = object;
+    }
+
+    // QJsonObject keeps its keys sorted, so compact JSON is canonical
+    QJsonObject canonical;
+    canonical["method"] = request.method;
+    canonical["params"] = params;
+    return QJsonDocument(canonical).toJson(QJsonDocument::Compact);
+}
+
+QByteArray encodeSharedResult(const QJsonValue &result)
+{
+    return encodeMessage(successResponse(result, QJsonValue::Undefined));
+}
+
+QByteArray withId(const QByteArray &sharedResult, const QJsonValue &id)
+{
+    // Assigning an undefined id to a QJsonObject removes the key, mirror that
+    if (id.isUndefined() || !sharedResult.startsWith('{')) {
+        return sharedResult;
+    }
+
+    // "id" sorts before "jsonrpc" and "result", so it always comes first
+    QByteArray idJson = QJsonDocument(QJsonArray{id}).toJson(QJsonDocument::Compact);
+    idJson = idJson.mid(1, idJson.size() - 2);
+
+    QByteArray patched;
+    patched.reserve(sharedResult.size() + idJson.size() + 6);
+    patched.append("{\"id\":");
+    patched.append(idJson);
+    patched.append(',');
+    patched.append(sharedResult.constData() + 1, sharedResult.size() - 1);
+    return patched;
+}
+
+} // namespace MCPProtocol
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
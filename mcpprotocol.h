@@ -0,0 +1,137 @@
+#ifndef MCPPROTOCOL_H
+#define MCPPROTOCOL_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QString>
+
+// This header only depends on QtCore so the framing and decoding code can be
+// exercised outside Qt Creator (see fuzz/mcpprotocol_fuzzer.cpp).
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+/**
+ * @brief A decoded JSON-RPC 2.0 request envelope
+ */
+struct MCPRequest
+{
+    QString method;
+    QJsonValue params;
+    QJsonValue id;           // undefined for notifications
+    qint64 deadlineMs = -1;  // optional client deadline, relative to receipt
+    bool afterParse = false; // hold the request until no project is parsing
+};
+
+/**
+ * @brief Splits the byte stream of one client into newline-delimited messages
+ *
+ * Data is appended as it arrives from the socket and complete lines are taken
+ * out one at a time, so a message split across several reads is reassembled
+ * instead of being reported as a parse error. A line that grows beyond
+ * MaxMessageSize is dropped up to its terminating newline so a misbehaving
+ * client cannot make the buffer grow without bound.
+ */
+class MCPFrameBuffer
+{
+public:
+    static constexpr qsizetype MaxMessageSize = 16 * 1024 * 1024;
+
+    /**
+     * @brief Appends raw bytes received from the client
+     * @param data The bytes read from the socket
+     */
+    void append(const QByteArray &data);
+
+    /**
+     * @brief Takes the next complete, non-empty message from the buffer
+     * @param message Receives the message without its line terminator
+     * @return true if a message was available, false otherwise
+     */
+    bool takeMessage(QByteArray &message);
+
+    /**
+     * @brief Returns and resets the number of messages dropped for exceeding MaxMessageSize
+     */
+    int takeOverflowCount();
+
+    qsizetype bufferedSize() const;
+    void clear();
+
+private:
+    void compact();
+    void enforceLimit();
+
+    QByteArray m_buffer;
+    qsizetype m_readOffset = 0;   // start of the first unconsumed message
+    qsizetype m_scanOffset = 0;   // everything before this is known to contain no newline
+    bool m_discarding = false;    // skipping the rest of an oversized message
+    int m_overflowCount = 0;
+};
+
+namespace MCPProtocol {
+
+// JSON-RPC 2.0 error codes
+const int ParseError = -32700;
+const int InvalidRequest = -32600;
+const int MethodNotFound = -32601;
+const int InvalidParams = -32602;
+const int RequestCancelled = -32800;   // LSP/MCP: request cancelled or past its deadline
+const int ContentModified = -32801;    // LSP: document changed since the client read it
+
+/**
+ * @brief Decodes and validates one framed message
+ * @param message A single message as returned by MCPFrameBuffer::takeMessage()
+ * @param request Receives the envelope; id is filled in as soon as it is known.
+ *        deadlineMs is read from the envelope or, failing that, from params.
+ * @param errorCode Receives the JSON-RPC error code on failure
+ * @param errorMessage Receives the error text on failure
+ * @return true if the message is a valid JSON-RPC 2.0 request
+ */
+bool decodeRequest(const QByteArray &message, MCPRequest &request,
+                   int &errorCode, QString &errorMessage);
+
+QJsonObject errorResponse(int code, const QString &message, const QJsonValue &id = QJsonValue::Null);
+QJsonObject successResponse(const QJsonValue &result, const QJsonValue &id = QJsonValue::Null);
+
+/**
+ * @brief Serializes a message in the wire format (compact JSON plus newline)
+ */
+QByteArray encodeMessage(const QJsonObject &message);
+
+/**
+ * @brief Serializes a notification (a request without id) in the wire format
+ */
+QByteArray encodeNotification(const QString &method, const QJsonObject &params);
+
+/**
+ * @brief Returns the key under which identical read-only requests share one result
+ *
+ * The key covers method and params only; two requests with equal params get
+ * the same key whatever order their members were sent in. The deadlineMs and
+ * afterParse controls are left out, a blocked or expired request is never
+ * handed a shared result by the scheduler.
+ */
+QByteArray singleFlightKey(const MCPRequest &request);
+
+/**
+ * @brief Serializes a success response without an id so it can be sent to several requesters
+ * @see withId()
+ */
+QByteArray encodeSharedResult(const QJsonValue &result);
+
+/**
+ * @brief Patches a request id into a response produced by encodeSharedResult()
+ *
+ * The output is byte-for-byte what encodeMessage(successResponse(result, id))
+ * would produce, without serializing the result again.
+ */
+QByteArray withId(const QByteArray &sharedResult, const QJsonValue &id);
+
+} // namespace MCPProtocol
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPPROTOCOL_H
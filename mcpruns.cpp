@@ -0,0 +1,300 @@
+#include "mcpruns.h"
+
+#include <projectexplorer/projectexplorer.h>
+#include <projectexplorer/projectexplorerconstants.h>
+#include <projectexplorer/project.h>
+#include <projectexplorer/projectmanager.h>
+#include <projectexplorer/runconfiguration.h>
+#include <projectexplorer/runcontrol.h>
+#include <projectexplorer/target.h>
+#include <utils/commandline.h>
+#include <utils/environment.h>
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QRegularExpression>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+namespace {
+
+// A pattern for a process runner message as the current UI language shows it
+QRegularExpression runnerMessagePattern(const char *sourceText)
+{
+    QString pattern = QRegularExpression::escape(QCoreApplication::translate("QtC::ProjectExplorer", sourceText));
+    pattern.replace(QRegularExpression::escape("%1"), "(?<executable>.*)");
+    pattern.replace(QRegularExpression::escape("%2"), "(?<exitCode>-?\\d+)");
+    return QRegularExpression(pattern);
+}
+
+} // namespace
+
+MCPRunRegistry::MCPRunRegistry(QObject *parent)
+    : QObject(parent)
+{
+    connect(ProjectExplorer::ProjectExplorerPlugin::instance(), &ProjectExplorer::ProjectExplorerPlugin::runControlStarted,
+            this, &MCPRunRegistry::addRunControl);
+}
+
+int MCPRunRegistry::start(const std::optional<QStringList> &arguments, const QJsonObject &environment,
+                          const QString &workingDirectory, QString &errorMessage)
+{
+    ProjectExplorer::Project *project = ProjectExplorer::ProjectManager::startupProject();
+    ProjectExplorer::Target *target = project ? project->activeTarget() : nullptr;
+    ProjectExplorer::RunConfiguration *runConfig = target ? target->activeRunConfiguration() : nullptr;
+    if (!runConfig) {
+        errorMessage = "No active run configuration";
+        return -1;
+    }
+
+    // A run control of its own carries the overrides, the run configuration stays untouched
+    auto runControl = new ProjectExplorer::RunControl(ProjectExplorer::Constants::NORMAL_RUN_MODE);
+    runControl->copyDataFromRunConfiguration(runConfig);
+
+    if (arguments) {
+        runControl->setCommandLine(Utils::CommandLine(runControl->commandLine().executable(), *arguments));
+    }
+    if (!environment.isEmpty()) {
+        Utils::Environment env = runControl->environment();
+        for (auto it = environment.constBegin(); it != environment.constEnd(); ++it) {
+            if (it.value().isNull()) {
+                env.unset(it.key());
+            } else {
+                env.set(it.key(), it.value().toVariant().toString());
+            }
+        }
+        runControl->setEnvironment(env);
+    }
+    if (!workingDirectory.isEmpty()) {
+        runControl->setWorkingDirectory(Utils::FilePath::fromUserInput(workingDirectory));
+    }
+
+    if (!runControl->createMainWorker()) {
+        errorMessage = QString("Cannot run %1").arg(runConfig->displayName());
+        delete runControl;
+        return -1;
+    }
+
+    // Track it before it starts so the caller gets the run id right away
+    const int runId = addRunControl(runControl);
+    qDebug() << "Starting run" << runId << "of" << runConfig->displayName() << "with overrides";
+    ProjectExplorer::ProjectExplorerPlugin::startRunControl(runControl);
+    return runId;
+}
+
+bool MCPRunRegistry::stop(int runId)
+{
+    auto it = m_runs.constFind(runId);
+    if (it == m_runs.cend() || !it->running || !it->runControl) {
+        return false;
+    }
+
+    it->runControl->initiateStop();
+    return true;
+}
+
+QString MCPRunRegistry::collectOutput(int runId, bool &truncated) const
+{
+    auto it = m_runs.constFind(runId);
+    if (it == m_runs.cend()) {
+        truncated = false;
+        return QString();
+    }
+    return it->output.text(truncated);
+}
+
+int MCPRunRegistry::addRunControl(ProjectExplorer::RunControl *runControl)
+{
+    for (const Run &existing : std::as_const(m_runs)) {
+        if (existing.runControl == runControl) {
+            return existing.id;
+        }
+    }
+
+    Run run;
+    run.id = m_nextRunId++;
+    run.runControl = runControl;
+    run.name = runControl->displayName();
+    run.mode = runControl->runMode().toString();
+    run.startMs = QDateTime::currentMSecsSinceEpoch();
+    run.elapsed.start();
+    run.pid = runControl->applicationProcessHandle().pid();
+    m_runs.insert(run.id, run);
+
+    const int runId = run.id;
+    connect(runControl, &ProjectExplorer::RunControl::appendMessage,
+            this, [this, runId](const QString &text, Utils::OutputFormat format) {
+        appendOutput(runId, text, format);
+    });
+    connect(runControl, &ProjectExplorer::RunControl::started, this, [this, runId] {
+        auto it = m_runs.find(runId);
+        if (it != m_runs.end()) {
+            it->started = true;
+        }
+    });
+    connect(runControl, &ProjectExplorer::RunControl::applicationProcessHandleChanged, this, [this, runId] {
+        auto it = m_runs.find(runId);
+        if (it != m_runs.end() && it->runControl) {
+            it->pid = it->runControl->applicationProcessHandle().pid();
+        }
+    });
+    connect(runControl, &ProjectExplorer::RunControl::stopped, this, [this, runId] {
+        runStopped(runId);
+    });
+    // A run control deleted without stopping properly still ends the run
+    connect(runControl, &QObject::destroyed, this, [this, runId] {
+        runStopped(runId);
+    });
+
+    qDebug() << "Tracking run" << runId << ":" << run.name << run.mode;
+    prune();
+    emit runStarted(runId, statusFor(m_runs.value(runId)));
+    return runId;
+}
+
+void MCPRunRegistry::appendOutput(int runId, const QString &text, Utils::OutputFormat format)
+{
+    auto it = m_runs.find(runId);
+    if (it == m_runs.end()) {
+        return;
+    }
+
+    QString stream;
+    switch (format) {
+    case Utils::StdOutFormat:
+        stream = "stdout";
+        break;
+    case Utils::StdErrFormat:
+        stream = "stderr";
+        break;
+    default: {
+        stream = "system";
+
+        // The process runner reports how the application ended
+        static const QRegularExpression exitPattern = runnerMessagePattern("%1 exited with code %2");
+        static const QRegularExpression crashPattern = runnerMessagePattern("%1 crashed.");
+        const QRegularExpressionMatch match = exitPattern.match(text);
+        if (match.hasMatch()) {
+            it->exitCode = match.captured("exitCode").toInt();
+        } else if (crashPattern.match(text).hasMatch()) {
+            it->crashed = true;
+        }
+        break;
+    }
+    }
+
+    it->output.append(stream, text);
+}
+
+void MCPRunRegistry::runStopped(int runId)
+{
+    auto it = m_runs.find(runId);
+    if (it == m_runs.end() || !it->running) {
+        return;
+    }
+
+    it->running = false;
+    it->durationMs = it->elapsed.elapsed();
+    qDebug() << "Run" << runId << "stopped, exit code" << it->exitCode << (it->crashed ? "(crashed)" : "");
+    emit runExited(runId, statusFor(*it));
+}
+
+int MCPRunRegistry::resolve(int runId) const
+{
+    if (runId < 0) {
+        return m_runs.isEmpty() ? -1 : m_runs.lastKey();
+    }
+    return m_runs.contains(runId) ? runId : -1;
+}
+
+QJsonObject MCPRunRegistry::statusFor(const Run &run) const
+{
+    QJsonObject result;
+    result["runId"] = run.id;
+    result["name"] = run.name;
+    result["mode"] = run.mode;
+    if (run.running) {
+        result["state"] = run.started ? QString("running") : QString("starting");
+    } else {
+        result["state"] = run.crashed ? QString("crashed") : QString("exited");
+    }
+    if (run.pid > 0) {
+        result["pid"] = run.pid;
+    }
+    result["startMs"] = run.startMs;
+    result["elapsedMs"] = run.durationMs >= 0 ? run.durationMs : run.elapsed.elapsed();
+    if (!run.running) {
+        result["exitCode"] = run.exitCode;
+    }
+    result["outputSeq"] = run.output.nextSeq() - 1;
+    return result;
+}
+
+QJsonObject MCPRunRegistry::status(int runId, QString &errorMessage) const
+{
+    const int resolved = resolve(runId);
+    if (resolved < 0) {
+        errorMessage = runId < 0 ? QString("No application has been run yet") : QString("Unknown run: %1").arg(runId);
+        return QJsonObject();
+    }
+    return statusFor(m_runs.value(resolved));
+}
+
+QJsonArray MCPRunRegistry::runningApplications() const
+{
+    QJsonArray applications;
+    for (const Run &run : m_runs) {
+        if (run.running) {
+            applications.append(statusFor(run));
+        }
+    }
+    return applications;
+}
+
+QJsonObject MCPRunRegistry::readOutput(int runId, qint64 sinceSeq, QString &errorMessage) const
+{
+    const int resolved = resolve(runId);
+    if (resolved < 0) {
+        errorMessage = runId < 0 ? QString("No application has been run yet") : QString("Unknown run: %1").arg(runId);
+        return QJsonObject();
+    }
+
+    const Run &run = m_runs[resolved];
+    QJsonArray chunks;
+    for (const MCPOutputBuffer::Chunk &chunk : run.output.since(sinceSeq)) {
+        QJsonObject entry;
+        entry["seq"] = chunk.seq;
+        entry["stream"] = chunk.stream;
+        entry["text"] = chunk.text;
+        chunks.append(entry);
+    }
+
+    QJsonObject result = statusFor(run);
+    result["chunks"] = chunks;
+    result["nextSeq"] = run.output.nextSeq();
+    // Chunks the client asked for that the buffer no longer holds
+    result["dropped"] = run.output.dropped(sinceSeq);
+    return result;
+}
+
+void MCPRunRegistry::prune()
+{
+    int finishedCount = 0;
+    for (const Run &run : std::as_const(m_runs)) {
+        finishedCount += run.running ? 0 : 1;
+    }
+
+    for (auto it = m_runs.begin(); it != m_runs.end() && finishedCount > MaxFinishedRuns; ) {
+        if (!it->running) {
+            it = m_runs.erase(it);
+            --finishedCount;
+        } else {
+            ++it;
+        }
+    }
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
@@ -0,0 +1,131 @@
+#ifndef MCPRUNS_H
+#define MCPRUNS_H
+
+#include <QObject>
+#include <QPointer>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QList>
+#include <QMap>
+#include <QStringList>
+
+#include <optional>
+
+#include <utils/outputformat.h>
+
+#include "mcpoutputbuffer.h"
+
+namespace ProjectExplorer {
+class RunControl;
+}
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+/**
+ * @brief Follows every application run started in Qt Creator
+ *
+ * Each RunControl that ProjectExplorer starts gets a run id, and the
+ * registry keeps its process id, state and start time, so running
+ * applications (including debuggees) are known without asking the OS.
+ * Its output is
+ * kept in an MCPOutputBuffer of sequence-numbered chunks: once the buffer
+ * holds more than MaxOutputBytes the oldest chunks are dropped, so a client
+ * reading with sinceSeq can tell exactly what it missed.
+ *
+ * RunControl does not expose the exit code, so it is taken from the
+ * message the process runner appends to the output when the process ends.
+ * That message is matched against ProjectExplorer's own translation of it,
+ * so this works in any UI language.
+ */
+class MCPRunRegistry : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MCPRunRegistry(QObject *parent = nullptr);
+
+    /**
+     * @brief Starts the active run configuration of the startup project
+     *
+     * The overrides apply to this run only; the run configuration itself is
+     * not modified. The project is not built first.
+     *
+     * @param arguments Replace the configured arguments if set
+     * @param environment Variables to set, a null value removes the variable
+     * @param workingDirectory Replaces the configured working directory if not empty
+     * @return The run id, or -1 with errorMessage set
+     */
+    int start(const std::optional<QStringList> &arguments, const QJsonObject &environment,
+              const QString &workingDirectory, QString &errorMessage);
+
+    /**
+     * @brief Asks a running application to stop
+     */
+    bool stop(int runId);
+
+    /**
+     * @brief Returns the buffered stdout and stderr text of a run in order
+     * @param truncated Set if older output was already dropped
+     */
+    QString collectOutput(int runId, bool &truncated) const;
+
+    /**
+     * @brief Returns output chunks with a sequence number of at least sinceSeq
+     * @param runId The run, or -1 for the most recent one
+     * @param errorMessage Set if the run is unknown
+     */
+    QJsonObject readOutput(int runId, qint64 sinceSeq, QString &errorMessage) const;
+
+    /**
+     * @brief Returns state, exit code and timing of a run
+     * @param runId The run, or -1 for the most recent one
+     */
+    QJsonObject status(int runId, QString &errorMessage) const;
+
+    /**
+     * @brief Lists the applications that are still running, served from memory
+     */
+    QJsonArray runningApplications() const;
+
+    static constexpr qint64 MaxOutputBytes = 1024 * 1024;
+    static constexpr int MaxFinishedRuns = 16;
+
+signals:
+    void runStarted(int runId, const QJsonObject &status);
+    void runExited(int runId, const QJsonObject &status);
+
+private:
+    struct Run
+    {
+        int id = 0;
+        QPointer<ProjectExplorer::RunControl> runControl;
+        QString name;
+        QString mode;
+        qint64 startMs = 0;
+        QElapsedTimer elapsed;
+        qint64 durationMs = -1;
+        qint64 pid = 0;           // 0 until the process runner reports it
+        bool started = false;     // RunControl finished starting its workers
+        bool running = true;
+        int exitCode = -1;
+        bool crashed = false;
+        MCPOutputBuffer output{MaxOutputBytes};
+    };
+
+    int addRunControl(ProjectExplorer::RunControl *runControl);
+    void appendOutput(int runId, const QString &text, Utils::OutputFormat format);
+    void runStopped(int runId);
+    int resolve(int runId) const;
+    QJsonObject statusFor(const Run &run) const;
+    void prune();
+
+    QMap<int, Run> m_runs;
+    int m_nextRunId = 1;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPRUNS_H
@@ -0,0 +1,428 @@
+#include "mcpscheduler.h"
+
+#include <QDebug>
+#include <QHash>
+#include <QJsonArray>
+#include <QTimer>
+
+#include <algorithm>
+#include <limits>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+MCPScheduler::MCPScheduler(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void MCPScheduler::setRunner(const Runner &runner)
+{
+    m_runner = runner;
+}
+
+void MCPScheduler::setExpiredHandler(const ExpiredHandler &handler)
+{
+    m_expiredHandler = handler;
+}
+
+void MCPScheduler::setBlocker(const Blocker &blocker)
+{
+    m_blocker = blocker;
+}
+
+void MCPScheduler::unblocked()
+{
+    scheduleDrain();
+}
+
+MCPScheduler::Priority MCPScheduler::priorityFor(const QString &method)
+{
+    static const QHash<QString, Priority> priorities = {
+        // Protocol housekeeping, never waits behind IDE work
+        {"listMethods", Priority::Control},
+        {"getVersion", Priority::Control},
+        {"getMethodMetadata", Priority::Control},
+        {"setMethodMetadata", Priority::Control},
+        {"subscribe", Priority::Control},
+        {"unsubscribe", Priority::Control},
+        {"getSchedulerStats", Priority::Control},
+        {"getJobStatus", Priority::Control},
+        {"waitForJob", Priority::Control},
+
+        // Cheap reads of IDE state
+        {"getCurrentProject", Priority::CheapQuery},
+        {"getCurrentBuildConfig", Priority::CheapQuery},
+        {"getCurrentSession", Priority::CheapQuery},
+        {"listProjects", Priority::CheapQuery},
+        {"listBuildConfigs", Priority::CheapQuery},
+        {"listOpenFiles", Priority::CheapQuery},
+        {"listSessions", Priority::CheapQuery},
+        {"listIssues", Priority::CheapQuery},
+        {"getParseState", Priority::CheapQuery},
+        {"readRunOutput", Priority::CheapQuery},
+        {"getRunStatus", Priority::CheapQuery},
+        {"listRunningApplications", Priority::CheapQuery},
+        {"listActions", Priority::CheapQuery},
+        {"listBreakpoints", Priority::CheapQuery},
+        {"getDiagnostics", Priority::CheapQuery},
+        {"getWorkspaceSnapshot", Priority::CheapQuery},
+        {"listKits", Priority::CheapQuery},
+        {"listTargets", Priority::CheapQuery},
+        {"getCompileFlags", Priority::CheapQuery},
+        {"getBuildHistory", Priority::CheapQuery},
+        {"compareBuilds", Priority::CheapQuery},
+
+        // Reads that can take a while on large inputs
+        {"getDebuggerSnapshot", Priority::HeavyQuery},
+        {"readDocument", Priority::HeavyQuery},
+        {"findFiles", Priority::HeavyQuery},
+        {"findSymbol", Priority::HeavyQuery},
+        {"findReferences", Priority::HeavyQuery},
+        {"searchInFiles", Priority::HeavyQuery},
+        {"exportCompilationDatabase", Priority::HeavyQuery},
+    };
+
+    // Anything not listed may change IDE state
+    return priorities.value(method, Priority::Mutation);
+}
+
+QString MCPScheduler::priorityName(Priority priority)
+{
+    switch (priority) {
+    case Priority::Control:
+        return "control";
+    case Priority::CheapQuery:
+        return "cheapQuery";
+    case Priority::HeavyQuery:
+        return "heavyQuery";
+    case Priority::Mutation:
+        return "mutation";
+    }
+    return QString();
+}
+
+void MCPScheduler::enqueue(QTcpSocket *client, const MCPRequest &request, const QByteArray &key)
+{
+    Job job;
+    job.serial = m_nextSerial++;
+    job.owner = client;
+    job.client = client;
+    job.request = request;
+    job.key = key;
+    job.priority = priorityFor(request.method);
+    job.queued.start();
+    if (request.deadlineMs >= 0) {
+        job.deadline = QDeadlineTimer(request.deadlineMs);
+    }
+
+    QList<ClientQueue> &queues = m_queues[int(job.priority)];
+    auto it = std::find_if(queues.begin(), queues.end(), [client](const ClientQueue &queue) {
+        return queue.client == client;
+    });
+    if (it == queues.end()) {
+        ClientQueue queue;
+        queue.client = client;
+        queue.jobs.append(job);
+        queues.append(queue);
+    } else {
+        it->jobs.append(job);
+    }
+
+    scheduleDrain();
+}
+
+QList<MCPScheduler::Job> MCPScheduler::takeIdentical(const Job &job)
+{
+    QList<Job> identical;
+    if (job.key.isEmpty()) {
+        return identical;
+    }
+
+    const int priority = int(job.priority);
+    QList<ClientQueue> &queues = m_queues[priority];
+    for (int q = 0; q < queues.size(); ) {
+        QList<Job> &jobs = queues[q].jobs;
+        for (int i = 0; i < jobs.size(); ) {
+            if (jobs.at(i).key == job.key && isEligible(jobs.at(i))) {
+                recordWait(jobs.at(i));
+                identical.append(jobs.takeAt(i));
+            } else {
+                ++i;
+            }
+        }
+
+        if (jobs.isEmpty()) {
+            removeQueue(priority, q);
+        } else {
+            ++q;
+        }
+    }
+
+    return identical;
+}
+
+bool MCPScheduler::cancel(QTcpSocket *client, const QJsonValue &requestId, Job &job)
+{
+    for (int priority = 0; priority < PriorityCount; ++priority) {
+        QList<ClientQueue> &queues = m_queues[priority];
+        for (int q = 0; q < queues.size(); ++q) {
+            if (queues.at(q).client != client) {
+                continue;
+            }
+
+            QList<Job> &jobs = queues[q].jobs;
+            for (int i = 0; i < jobs.size(); ++i) {
+                if (jobs.at(i).request.id == requestId) {
+                    job = jobs.takeAt(i);
+                    if (jobs.isEmpty()) {
+                        removeQueue(priority, q);
+                    }
+                    return true;
+                }
+            }
+            break;
+        }
+    }
+
+    return false;
+}
+
+void MCPScheduler::removeQueue(int priority, int index)
+{
+    m_queues[priority].removeAt(index);
+    if (m_cursor[priority] > index) {
+        --m_cursor[priority];
+    }
+    if (m_cursor[priority] >= m_queues[priority].size()) {
+        m_cursor[priority] = 0;
+    }
+}
+
+void MCPScheduler::dropExpired()
+{
+    for (int priority = 0; priority < PriorityCount; ++priority) {
+        QList<ClientQueue> &queues = m_queues[priority];
+        for (int q = 0; q < queues.size(); ) {
+            QList<Job> &jobs = queues[q].jobs;
+            for (int i = 0; i < jobs.size(); ) {
+                if (!jobs.at(i).deadline.hasExpired()) {
+                    ++i;
+                    continue;
+                }
+
+                Job expired = jobs.takeAt(i);
+                ++m_expiredCount;
+                qDebug() << "Dropping" << expired.request.method << "request, deadline passed after"
+                         << expired.queued.elapsed() << "ms in queue";
+                if (m_expiredHandler) {
+                    m_expiredHandler(expired);
+                }
+            }
+
+            if (jobs.isEmpty()) {
+                removeQueue(priority, q);
+            } else {
+                ++q;
+            }
+        }
+    }
+}
+
+void MCPScheduler::jobFinished()
+{
+    if (m_runningHeavyJobs > 0) {
+        --m_runningHeavyJobs;
+    }
+    scheduleDrain();
+}
+
+void MCPScheduler::removeClient(QTcpSocket *client)
+{
+    for (int priority = 0; priority < PriorityCount; ++priority) {
+        QList<ClientQueue> &queues = m_queues[priority];
+        for (int q = 0; q < queues.size(); ++q) {
+            if (queues.at(q).client == client) {
+                removeQueue(priority, q);
+                break;
+            }
+        }
+    }
+}
+
+void MCPScheduler::scheduleDrain()
+{
+    if (m_drainScheduled) {
+        return;
+    }
+    m_drainScheduled = true;
+    QTimer::singleShot(0, this, &MCPScheduler::drain);
+}
+
+void MCPScheduler::drain()
+{
+    m_drainScheduled = false;
+    if (!m_runner || m_draining) {
+        return;
+    }
+    m_draining = true;
+
+    // Work nobody is waiting for anymore is answered without running it
+    dropExpired();
+
+    QElapsedTimer slice;
+    slice.start();
+
+    Job job;
+    bool yieldB = false;
+    while (!yieldB && takeNext(job)) {
+        recordWait(job);
+
+        const bool completedB = m_runner(job);
+        if (!completedB && job.priority == Priority::HeavyQuery) {
+            ++m_runningHeavyJobs;
+        }
+
+        // Expensive jobs end the slice so queued cheap work runs next
+        yieldB = job.priority == Priority::HeavyQuery
+                 || job.priority == Priority::Mutation
+                 || slice.elapsed() >= SliceMs;
+    }
+
+    m_draining = false;
+
+    // Jobs held back by the heavy-job cap are picked up in jobFinished()
+    int priority = 0;
+    int index = 0;
+    if (findNext(priority, index)) {
+        scheduleDrain();
+    }
+}
+
+bool MCPScheduler::findNext(int &priority, int &index) const
+{
+    for (priority = 0; priority < PriorityCount; ++priority) {
+        if (priority == int(Priority::HeavyQuery) && m_runningHeavyJobs >= MaxConcurrentHeavyJobs) {
+            continue;
+        }
+
+        const QList<ClientQueue> &queues = m_queues[priority];
+        const int count = queues.size();
+        for (int k = 0; k < count; ++k) {
+            index = (m_cursor[priority] + k) % count;
+            if (isEligible(queues.at(index).jobs.first())) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+bool MCPScheduler::takeNext(Job &job)
+{
+    int priority = 0;
+    int index = 0;
+    if (!findNext(priority, index)) {
+        return false;
+    }
+
+    QList<ClientQueue> &queues = m_queues[priority];
+    const int count = queues.size();
+    job = queues[index].jobs.takeFirst();
+    if (queues.at(index).jobs.isEmpty()) {
+        queues.removeAt(index);
+        m_cursor[priority] = queues.isEmpty() ? 0 : index % queues.size();
+    } else {
+        m_cursor[priority] = (index + 1) % count;
+    }
+    return true;
+}
+
+bool MCPScheduler::isEligible(const Job &job) const
+{
+    if (m_blocker && m_blocker(job)) {
+        return false;
+    }
+    if (job.priority == Priority::Mutation) {
+        return oldestSerial(job.owner) == job.serial;
+    }
+    return job.serial < oldestMutationSerial(job.owner);
+}
+
+quint64 MCPScheduler::oldestMutationSerial(QTcpSocket *client) const
+{
+    for (const ClientQueue &queue : m_queues[int(Priority::Mutation)]) {
+        if (queue.client == client) {
+            return queue.jobs.first().serial;
+        }
+    }
+    return std::numeric_limits<quint64>::max();
+}
+
+quint64 MCPScheduler::oldestSerial(QTcpSocket *client) const
+{
+    quint64 oldest = std::numeric_limits<quint64>::max();
+    for (int priority = 0; priority < PriorityCount; ++priority) {
+        for (const ClientQueue &queue : m_queues[priority]) {
+            if (queue.client == client) {
+                oldest = qMin(oldest, queue.jobs.first().serial);
+                break;
+            }
+        }
+    }
+    return oldest;
+}
+
+void MCPScheduler::recordWait(const Job &job)
+{
+    ClassStats &stats = m_stats[int(job.priority)];
+    const qint64 waitUs = job.queued.nsecsElapsed() / 1000;
+
+    stats.count++;
+    stats.totalWaitUs += waitUs;
+    stats.maxWaitUs = qMax(stats.maxWaitUs, waitUs);
+    if (stats.recentWaitsUs.size() < RecentSamples) {
+        stats.recentWaitsUs.append(waitUs);
+    } else {
+        stats.recentWaitsUs[stats.nextSample] = waitUs;
+    }
+    stats.nextSample = (stats.nextSample + 1) % RecentSamples;
+}
+
+QJsonObject MCPScheduler::statistics() const
+{
+    QJsonArray classes;
+    for (int priority = 0; priority < PriorityCount; ++priority) {
+        const ClassStats &stats = m_stats[priority];
+
+        int queued = 0;
+        for (const ClientQueue &queue : m_queues[priority]) {
+            queued += queue.jobs.size();
+        }
+
+        QList<qint64> recent = stats.recentWaitsUs;
+        std::sort(recent.begin(), recent.end());
+        const qint64 p99 = recent.isEmpty() ? 0 : recent.at((recent.size() - 1) * 99 / 100);
+
+        QJsonObject entry;
+        entry["class"] = priorityName(Priority(priority));
+        entry["completed"] = qint64(stats.count);
+        entry["queued"] = queued;
+        entry["avgWaitUs"] = stats.count ? stats.totalWaitUs / qint64(stats.count) : 0;
+        entry["maxWaitUs"] = stats.maxWaitUs;
+        entry["p99WaitUs"] = p99;
+        classes.append(entry);
+    }
+
+    QJsonObject result;
+    result["classes"] = classes;
+    result["runningHeavyJobs"] = m_runningHeavyJobs;
+    result["maxConcurrentHeavyJobs"] = MaxConcurrentHeavyJobs;
+    result["sliceMs"] = SliceMs;
+    result["expiredBeforeRun"] = m_expiredCount;
+    return result;
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
@@ -0,0 +1,168 @@
+#ifndef MCPSCHEDULER_H
+#define MCPSCHEDULER_H
+
+#include <QObject>
+#include <QPointer>
+#include <QTcpSocket>
+#include <QElapsedTimer>
+#include <QDeadlineTimer>
+#include <QJsonObject>
+#include <QList>
+
+#include <functional>
+
+#include "mcpprotocol.h"
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+/**
+ * @brief Orders queued MCP requests by priority class with per-client fairness
+ *
+ * Requests are grouped into four classes that are served strictly in order:
+ * control, cheap query, heavy query and mutation. Inside a class clients are
+ * served round-robin so one busy agent cannot starve the others. A client's
+ * requests never overtake one of its own earlier mutations, and a mutation
+ * waits for everything the same client queued before it.
+ *
+ * Jobs run on the GUI thread. Cheap jobs are drained in slices of at most
+ * SliceMs before control returns to the event loop, and the scheduler always
+ * yields after a heavy query or mutation so newly arrived cheap queries are
+ * read from the sockets before the next expensive job starts.
+ *
+ * A blocked job (for example one waiting for project parsing) stays queued;
+ * a blocked mutation keeps holding back its client's later requests.
+ */
+class MCPScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Priority {
+        Control,
+        CheapQuery,
+        HeavyQuery,
+        Mutation
+    };
+    static constexpr int PriorityCount = 4;
+
+    struct Job
+    {
+        quint64 serial = 0;
+        QTcpSocket *owner = nullptr;        // identity of the client, may be dangling
+        QPointer<QTcpSocket> client;        // for sending the response
+        MCPRequest request;
+        QByteArray key;            // single-flight key, empty if results cannot be shared
+        Priority priority = Priority::Mutation;
+        QElapsedTimer queued;
+        QDeadlineTimer deadline = QDeadlineTimer::Forever;
+    };
+
+    /**
+     * @brief Runs a job
+     * @return false if the job continues asynchronously; heavy jobs then count
+     *         against the concurrency cap until jobFinished() is called
+     */
+    using Runner = std::function<bool(Job &job)>;
+
+    /**
+     * @brief Answers a job that passed its deadline before it could run
+     */
+    using ExpiredHandler = std::function<void(Job &job)>;
+
+    /**
+     * @brief Tells whether a job has to wait for an external condition
+     */
+    using Blocker = std::function<bool(const Job &job)>;
+
+    explicit MCPScheduler(QObject *parent = nullptr);
+
+    void setRunner(const Runner &runner);
+    void setExpiredHandler(const ExpiredHandler &handler);
+    void setBlocker(const Blocker &blocker);
+
+    /**
+     * @brief Reconsiders blocked jobs after the blocker's condition changed
+     */
+    void unblocked();
+
+    void enqueue(QTcpSocket *client, const MCPRequest &request, const QByteArray &key);
+
+    /**
+     * @brief Removes and returns queued jobs that can share the result of job
+     *
+     * Only jobs with the same non-empty key that are allowed to run right now
+     * are returned.
+     */
+    QList<Job> takeIdentical(const Job &job);
+
+    /**
+     * @brief Removes a queued job by its request id
+     * @param job Receives the removed job
+     * @return false if no such job is queued
+     */
+    bool cancel(QTcpSocket *client, const QJsonValue &requestId, Job &job);
+
+    /**
+     * @brief Reports the end of a heavy job that continued asynchronously
+     */
+    void jobFinished();
+
+    /**
+     * @brief Drops all queued jobs of a client
+     */
+    void removeClient(QTcpSocket *client);
+
+    static Priority priorityFor(const QString &method);
+    static QString priorityName(Priority priority);
+
+    QJsonObject statistics() const;
+
+    static constexpr int SliceMs = 2;
+    static constexpr int MaxConcurrentHeavyJobs = 2;
+
+private:
+    struct ClientQueue
+    {
+        QTcpSocket *client = nullptr;
+        QList<Job> jobs;
+    };
+
+    struct ClassStats
+    {
+        quint64 count = 0;
+        qint64 totalWaitUs = 0;
+        qint64 maxWaitUs = 0;
+        QList<qint64> recentWaitsUs;   // ring of the last RecentSamples waits
+        int nextSample = 0;
+    };
+    static constexpr int RecentSamples = 256;
+
+    void scheduleDrain();
+    void drain();
+    void dropExpired();
+    void removeQueue(int priority, int index);
+    bool findNext(int &priority, int &index) const;
+    bool takeNext(Job &job);
+    bool isEligible(const Job &job) const;
+    quint64 oldestMutationSerial(QTcpSocket *client) const;
+    quint64 oldestSerial(QTcpSocket *client) const;
+    void recordWait(const Job &job);
+
+    Runner m_runner;
+    ExpiredHandler m_expiredHandler;
+    Blocker m_blocker;
+    QList<ClientQueue> m_queues[PriorityCount];
+    int m_cursor[PriorityCount] = {};
+    ClassStats m_stats[PriorityCount];
+    quint64 m_nextSerial = 1;
+    int m_runningHeavyJobs = 0;
+    bool m_drainScheduled = false;
+    bool m_draining = false;   // a job can spin a nested event loop (modal dialogs)
+    qint64 m_expiredCount = 0;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPSCHEDULER_H
@@ -1,7 +1,9 @@
 #include "mcpserver.h"
+#include "mcpactions.h"
 
 #include <QDebug>
 #include <QHostAddress>
+#include <QSet>
 
 namespace Qt_MCP_Plugin {
 namespace Internal {
@@ -11,9 +13,319 @@ MCPServer::MCPServer(QObject *parent)
     , m_serverP(new QTcpServer(this))
     , m_commandsP(new MCPCommands(this))
     , m_port(3001)
+    , m_schedulerP(new MCPScheduler(this))
+    , m_jobsP(new MCPJobRegistry(this))
+    , m_buildHistoryP(new MCPBuildHistory(this))
+    , m_parseTrackerP(new MCPParseTracker(this))
+    , m_buildMatrixP(new MCPBuildMatrix(m_parseTrackerP, this))
+    , m_runsP(new MCPRunRegistry(this))
+    , m_debuggerP(new MCPDebuggerInspector(this))
+    , m_breakpointsP(new MCPBreakpoints(this))
+    , m_documentsP(new MCPDocuments(this))
+    , m_fileIndexP(new MCPFileIndex(this))
+    , m_symbolsP(new MCPSymbolSearch(this))
+    , m_diagnosticsP(new MCPDiagnostics(this))
+    , m_textSearchP(new MCPTextSearch(m_fileIndexP, this))
+    , m_kitsP(new MCPKits(m_parseTrackerP, this))
+    , m_issuesTimerP(new QTimer(this))
 {
     connect(m_serverP, &QTcpServer::newConnection,
             this, &MCPServer::handleNewConnection);
+    
+    m_schedulerP->setRunner([this](MCPScheduler::Job &job) {
+        return runJob(job);
+    });
+    m_schedulerP->setExpiredHandler([this](MCPScheduler::Job &job) {
+        sendResponse(job.client, createErrorResponse(MCPProtocol::RequestCancelled,
+                                                     "Request deadline exceeded", job.request.id));
+    });
+    
+    // Requests sent with afterParse wait in the queue while a session loads
+    // or a project parses
+    m_schedulerP->setBlocker([this](const MCPScheduler::Job &job) {
+        return job.request.afterParse
+               && (m_commandsP->isSessionLoadPending() || m_parseTrackerP->isParsing());
+    });
+    connect(m_parseTrackerP, &MCPParseTracker::idle, m_schedulerP, &MCPScheduler::unblocked);
+    connect(m_commandsP, &MCPCommands::sessionLoadFinished, m_schedulerP, &MCPScheduler::unblocked);
+    
+    connect(m_jobsP, &MCPJobRegistry::jobFinished, this, &MCPServer::handleJobFinished);
+    
+    connect(m_buildMatrixP, &MCPBuildMatrix::progress, this, [this](const QJsonObject &entry) {
+        QJsonObject params = entry;
+        params["jobId"] = m_matrixJobId;
+        publish(NotificationTopic::Build, "notifications/buildMatrixProgress", params);
+    });
+    connect(m_buildMatrixP, &MCPBuildMatrix::finished, this, [this](bool success, const QJsonObject &report) {
+        m_jobsP->finish(m_matrixJobId, success, report);
+    });
+    
+    connectCommandEvents();
+}
+
+void MCPServer::connectCommandEvents()
+{
+    connect(m_commandsP, &MCPCommands::buildStarted, this, [this](const QString &projectName) {
+        QJsonObject params;
+        params["project"] = projectName;
+        publish(NotificationTopic::Build, "notifications/buildStarted", params);
+    });
+    connect(m_commandsP, &MCPCommands::buildFinished, this, [this](bool success) {
+        QJsonObject params;
+        params["success"] = success;
+        publish(NotificationTopic::Build, "notifications/buildFinished", params);
+        
+        // BuildManager runs one queue, so its end finishes every build-type job
+        m_jobsP->finishAll({"build", "cleanProject", "compileFile", "buildTarget"}, success);
+    });
+    connect(m_commandsP, &MCPCommands::startupProjectChanged, this, [this](const QString &projectName) {
+        QJsonObject params;
+        params["project"] = projectName;
+        publish(NotificationTopic::Project, "notifications/startupProjectChanged", params);
+    });
+    connect(m_parseTrackerP, &MCPParseTracker::parsingStarted, this, [this](const QString &projectName) {
+        QJsonObject params;
+        params["project"] = projectName;
+        publish(NotificationTopic::Project, "notifications/parseStarted", params);
+    });
+    connect(m_parseTrackerP, &MCPParseTracker::parsingFinished,
+            this, [this](const QString &projectName, bool success, qint64 durationMs) {
+        QJsonObject params;
+        params["project"] = projectName;
+        params["success"] = success;
+        params["durationMs"] = durationMs;
+        params["generation"] = qint64(m_parseTrackerP->generation());
+        publish(NotificationTopic::Project, "notifications/parseFinished", params);
+    });
+    connect(m_runsP, &MCPRunRegistry::runStarted, this, [this](int, const QJsonObject &status) {
+        publish(NotificationTopic::Run, "notifications/runStarted", status);
+    });
+    connect(m_runsP, &MCPRunRegistry::runExited, this, [this](int runId, const QJsonObject &status) {
+        publish(NotificationTopic::Run, "notifications/runExited", status);
+        finishRunWait(runId);
+    });
+    // Queued, so a search that ends inside its start call is already mapped to its job
+    connect(m_symbolsP, &MCPSymbolSearch::results, this, [this](int searchId, const QJsonArray &batch) {
+        QJsonObject params;
+        params["jobId"] = m_symbolJobs.value(searchId);
+        params["results"] = batch;
+        publish(NotificationTopic::Search, "notifications/searchResults", params);
+    }, Qt::QueuedConnection);
+    connect(m_symbolsP, &MCPSymbolSearch::finished,
+            this, [this](int searchId, bool success, const QJsonObject &report) {
+        m_jobsP->finish(m_symbolJobs.take(searchId), success, report);
+    }, Qt::QueuedConnection);
+    connect(m_textSearchP, &MCPTextSearch::results, this, [this](int searchId, const QJsonArray &batch) {
+        QJsonObject params;
+        params["jobId"] = m_textSearchJobs.value(searchId);
+        params["results"] = batch;
+        publish(NotificationTopic::Search, "notifications/searchResults", params);
+    }, Qt::QueuedConnection);
+    connect(m_textSearchP, &MCPTextSearch::finished,
+            this, [this](int searchId, bool success, const QJsonObject &report) {
+        m_jobsP->finish(m_textSearchJobs.take(searchId), success, report);
+    }, Qt::QueuedConnection);
+    connect(m_kitsP, &MCPKits::chunk, this, [this](int exportId, const QJsonArray &entries) {
+        QJsonObject params;
+        params["jobId"] = m_exportJobs.value(exportId);
+        params["entries"] = entries;
+        publish(NotificationTopic::Project, "notifications/compilationDatabase", params);
+    }, Qt::QueuedConnection);
+    connect(m_kitsP, &MCPKits::finished,
+            this, [this](int exportId, bool success, const QJsonObject &report) {
+        m_jobsP->finish(m_exportJobs.take(exportId), success, report);
+    }, Qt::QueuedConnection);
+    connect(m_diagnosticsP, &MCPDiagnostics::diagnosticsChanged, this, [this](const QJsonObject &delta) {
+        publish(NotificationTopic::Diagnostics, "notifications/diagnosticsChanged", delta);
+    });
+    connect(m_debuggerP, &MCPDebuggerInspector::paused, this, [this](const QJsonObject &snapshot) {
+        publish(NotificationTopic::Debugger, "notifications/debuggerPaused", snapshot);
+    });
+    connect(m_debuggerP, &MCPDebuggerInspector::resumed, this, [this]() {
+        publish(NotificationTopic::Debugger, "notifications/debuggerResumed");
+    });
+    connect(m_commandsP, &MCPCommands::sessionLoaded, this, [this](const QString &sessionName) {
+        QJsonObject params;
+        params["session"] = sessionName;
+        publish(NotificationTopic::Session, "notifications/sessionLoaded", params);
+    });
+    
+    // A build adds tasks one by one, so collapse bursts into one notification
+    m_issuesTimerP->setSingleShot(true);
+    m_issuesTimerP->setInterval(100);
+    connect(m_commandsP, &MCPCommands::issuesChanged, this, [this](int errorCount, int warningCount) {
+        m_issueErrors = errorCount;
+        m_issueWarnings = warningCount;
+        if (!m_issuesTimerP->isActive()) {
+            m_issuesTimerP->start();
+        }
+    });
+    connect(m_issuesTimerP, &QTimer::timeout, this, [this] {
+        QJsonObject params;
+        params["errors"] = m_issueErrors;
+        params["warnings"] = m_issueWarnings;
+        publish(NotificationTopic::Issues, "notifications/issuesChanged", params);
+    });
+}
+
+void MCPServer::publish(NotificationTopic topic, const QString &method, QJsonObject params)
+{
+    const int bit = int(topic);
+    params["seq"] = qint64(++m_notificationSeq);
+    
+    // Encode once; QIODevice::write() appends large implicitly shared buffers
+    // to the socket's write queue without copying them
+    QByteArray data;
+    int subscribers = 0;
+    for (auto it = m_clientStates.cbegin(); it != m_clientStates.cend(); ++it) {
+        if (!it.value().topics.test(bit)) {
+            continue;
+        }
+        if (data.isEmpty()) {
+            data = MCPProtocol::encodeNotification(method, params);
+        }
+        sendEncoded(it.key(), data);
+        ++subscribers;
+    }
+    
+    if (subscribers > 0) {
+        qDebug() << "Published" << method << "to" << subscribers << "subscriber(s)";
+    }
+}
+
+QString MCPServer::topicName(NotificationTopic topic)
+{
+    switch (topic) {
+    case NotificationTopic::Build:
+        return "build";
+    case NotificationTopic::Issues:
+        return "issues";
+    case NotificationTopic::Project:
+        return "project";
+    case NotificationTopic::Session:
+        return "session";
+    case NotificationTopic::Jobs:
+        return "jobs";
+    case NotificationTopic::Run:
+        return "run";
+    case NotificationTopic::Debugger:
+        return "debugger";
+    case NotificationTopic::Search:
+        return "search";
+    case NotificationTopic::Diagnostics:
+        return "diagnostics";
+    case NotificationTopic::Count:
+        break;
+    }
+    return QString();
+}
+
+QJsonObject MCPServer::workspaceSnapshot(const QJsonArray &fields, QString &errorMessage)
+{
+    static const QStringList allFields = {
+        "version", "session", "projects", "currentProject", "buildConfigs",
+        "currentBuildConfig", "openFiles", "issues", "parseState", "runningApplications"
+    };
+    
+    QStringList wanted;
+    for (const QJsonValue &field : fields) {
+        if (!allFields.contains(field.toString())) {
+            errorMessage = QString("Unknown field '%1' (available: %2)").arg(field.toString(), allFields.join(", "));
+            return QJsonObject();
+        }
+        wanted.append(field.toString());
+    }
+    if (wanted.isEmpty()) {
+        wanted = allFields;
+    }
+    
+    // Everything is read in this one call without returning to the event
+    // loop, so no IDE event can land between two sections
+    QJsonObject snapshot;
+    for (const QString &field : std::as_const(wanted)) {
+        if (field == "version") {
+            snapshot[field] = m_commandsP->getVersion();
+        } else if (field == "session") {
+            snapshot[field] = m_commandsP->getCurrentSession();
+        } else if (field == "projects") {
+            snapshot[field] = QJsonArray::fromStringList(m_commandsP->listProjects());
+        } else if (field == "currentProject") {
+            snapshot[field] = m_commandsP->getCurrentProject();
+        } else if (field == "buildConfigs") {
+            snapshot[field] = QJsonArray::fromStringList(m_commandsP->listBuildConfigs());
+        } else if (field == "currentBuildConfig") {
+            snapshot[field] = m_commandsP->getCurrentBuildConfig();
+        } else if (field == "openFiles") {
+            snapshot[field] = QJsonArray::fromStringList(m_commandsP->listOpenFiles());
+        } else if (field == "issues") {
+            snapshot[field] = QJsonArray::fromStringList(m_commandsP->listIssues());
+        } else if (field == "parseState") {
+            snapshot[field] = m_parseTrackerP->state();
+        } else if (field == "runningApplications") {
+            snapshot[field] = m_runsP->runningApplications();
+        }
+    }
+    
+    // A cursor into the notification stream, not a version of the workspace:
+    // a notification with a higher seq was sent after this snapshot, but
+    // changes that publish nothing (build config switches, opened files,
+    // editor changes) never move it
+    snapshot["stateVersion"] = qint64(m_notificationSeq);
+    return snapshot;
+}
+
+QJsonValue MCPServer::updateSubscriptions(QTcpSocket *client, const QJsonValue &params, bool subscribe, QString &errorMessage)
+{
+    if (!client || !m_clientStates.contains(client)) {
+        errorMessage = "Client is no longer connected";
+        return QJsonValue();
+    }
+    
+    const QJsonArray topics = params.toObject().value("topics").toArray();
+    if (!params.isObject() || topics.isEmpty()) {
+        errorMessage = QString("Invalid parameters for %1: topics must be a non-empty array")
+                           .arg(subscribe ? "subscribe" : "unsubscribe");
+        return QJsonValue();
+    }
+    
+    std::bitset<TopicCount> mask;
+    for (const QJsonValue &topic : topics) {
+        const QString name = topic.toString();
+        int bit = 0;
+        while (bit < TopicCount && topicName(NotificationTopic(bit)) != name) {
+            ++bit;
+        }
+        if (bit == TopicCount) {
+            errorMessage = QString("Unknown notification topic: %1").arg(name);
+            return QJsonValue();
+        }
+        mask.set(bit);
+    }
+    
+    std::bitset<TopicCount> &current = m_clientStates[client].topics;
+    current = subscribe ? (current | mask) : (current & ~mask);
+    updateTopicSources();
+    
+    QJsonArray subscribed;
+    for (int bit = 0; bit < TopicCount; ++bit) {
+        if (current.test(bit)) {
+            subscribed.append(topicName(NotificationTopic(bit)));
+        }
+    }
+    
+    QJsonObject result;
+    result["subscribed"] = subscribed;
+    return result;
+}
+
+void MCPServer::updateTopicSources()
+{
+    // Sources that cost work while idle only run while someone listens
+    bool diagnosticsB = false;
+    for (const ClientState &state : std::as_const(m_clientStates)) {
+        diagnosticsB = diagnosticsB || state.topics.test(int(NotificationTopic::Diagnostics));
+    }
+    m_diagnosticsP->setActive(diagnosticsB);
 }
 
 MCPServer::~MCPServer()
@@ -59,6 +371,8 @@ void MCPServer::stop()
         client->deleteLater();
     }
     m_clients.clear();
+    m_clientStates.clear();
+    updateTopicSources();
     
     if (m_serverP->isListening()) {
         m_serverP->close();
@@ -82,8 +396,13 @@ void MCPServer::handleNewConnection()
     if (!client) {
         return;
     }
-    
+    attachClient(client);
+}
+
+void MCPServer::attachClient(QTcpSocket *client)
+{
     m_clients.append(client);
+    m_clientStates.insert(client, ClientState());
     
     connect(client, &QTcpSocket::readyRead,
             this, &MCPServer::handleClientData);
@@ -99,34 +418,33 @@ void MCPServer::handleClientData()
     if (!client) {
         return;
     }
-    
-    QByteArray data = client->readAll();
-    QString dataStr = QString::fromUtf8(data);
-    
-    // Split by newlines to handle multiple JSON-RPC messages
-    QStringList messages = dataStr.split('\n', Qt::SkipEmptyParts);
-    
-    for (const QString &message : messages) {
-        if (message.trimmed().isEmpty()) {
-            continue;
-        }
-        
-        QJsonParseError error;
-        QJsonDocument doc = QJsonDocument::fromJson(message.toUtf8(), &error);
-        
-        if (error.error != QJsonParseError::NoError) {
-            qDebug() << "JSON parse error:" << error.errorString();
-            sendResponse(client, createErrorResponse(-32700, "Parse error"));
-            continue;
-        }
-        
-        if (!doc.isObject()) {
-            qDebug() << "Invalid JSON-RPC message: not an object";
-            sendResponse(client, createErrorResponse(-32600, "Invalid Request"));
+    receive(client, client->readAll());
+}
+
+void MCPServer::receive(QTcpSocket *client, const QByteArray &data)
+{
+    MCPFrameBuffer &frames = m_clientStates[client].frames;
+    frames.append(data);
+
+    // Handle every complete newline-delimited JSON-RPC message; a partial
+    // message stays buffered until the rest of it arrives
+    QByteArray message;
+    while (frames.takeMessage(message)) {
+        MCPRequest request;
+        int errorCode = 0;
+        QString errorMessage;
+        if (!MCPProtocol::decodeRequest(message, request, errorCode, errorMessage)) {
+            qDebug() << "Invalid JSON-RPC message:" << errorMessage;
+            sendResponse(client, createErrorResponse(errorCode, errorMessage, request.id));
             continue;
         }
-        
-        processRequest(client, doc.object());
+
+        processRequest(client, request);
+    }
+
+    for (int dropped = frames.takeOverflowCount(); dropped > 0; --dropped) {
+        qDebug() << "Dropped JSON-RPC message larger than" << MCPFrameBuffer::MaxMessageSize << "bytes";
+        sendResponse(client, createErrorResponse(MCPProtocol::ParseError, "Parse error: message too large"));
     }
 }
 
@@ -135,6 +453,28 @@ void MCPServer::handleClientDisconnected()
     QTcpSocket *client = qobject_cast<QTcpSocket*>(sender());
     if (client) {
         m_clients.removeAll(client);
+        m_clientStates.remove(client);
+        updateTopicSources();
+        m_schedulerP->removeClient(client);
+        for (int i = m_longPolls.size() - 1; i >= 0; --i) {
+            if (m_longPolls.at(i).owner == client) {
+                m_longPolls.takeAt(i).timerP->deleteLater();
+            }
+        }
+        
+        // Nobody is left to answer a runAndWait, so its run is stopped and
+        // its job ends as cancelled
+        for (int i = m_runWaits.size() - 1; i >= 0; --i) {
+            if (m_runWaits.at(i).owner == client) {
+                RunWait wait = m_runWaits.takeAt(i);
+                wait.timerP->deleteLater();
+                m_jobsP->cancel(wait.jobId);
+                
+                QJsonObject details;
+                details["runId"] = wait.runId;
+                m_jobsP->finish(wait.jobId, false, details);
+            }
+        }
         client->deleteLater();
         qDebug() << "MCP client disconnected";
     }
@@ -146,36 +486,108 @@ void MCPServer::sendResponse(QTcpSocket *client, const QJsonObject &response)
         return;
     }
     
-    QJsonDocument doc(response);
-    QByteArray data = doc.toJson(QJsonDocument::Compact) + "\n";
+    sendEncoded(client, MCPProtocol::encodeMessage(response));
+}
+
+void MCPServer::sendEncoded(QTcpSocket *client, const QByteArray &data)
+{
+    if (!client || client->state() != QAbstractSocket::ConnectedState) {
+        return;
+    }
     
     client->write(data);
     client->flush();
 }
 
-void MCPServer::processRequest(QTcpSocket *client, const QJsonObject &request)
+void MCPServer::processRequest(QTcpSocket *client, const MCPRequest &request)
 {
-    // Extract method and parameters
-    QString method = request.value("method").toString();
-    QJsonValue params = request.value("params");
-    QJsonValue id = request.value("id");
-    
-    // Validate JSON-RPC version
-    QString jsonrpc = request.value("jsonrpc").toString();
-    if (jsonrpc != "2.0") {
-        sendResponse(client, createErrorResponse(-32600, "Invalid Request: jsonrpc must be '2.0'", id));
+    // Cancellation must not wait behind the work it is meant to stop
+    if (request.method == "$/cancelRequest") {
+        handleCancelRequest(client, request);
         return;
     }
     
-    if (method.isEmpty()) {
-        sendResponse(client, createErrorResponse(-32600, "Invalid Request: method is required", id));
-        return;
+    qDebug() << "Queueing MCP request:" << request.method << "with id:" << request.id;
+    
+    QByteArray key;
+    if (isReadOnlyMethod(request.method)) {
+        key = MCPProtocol::singleFlightKey(request);
     }
+    m_schedulerP->enqueue(client, request, key);
+}
+
+bool MCPServer::runJob(MCPScheduler::Job &job)
+{
+    const MCPRequest &request = job.request;
     
-    qDebug() << "Processing MCP request:" << method << "with id:" << id;
+    qDebug() << "Processing MCP request:" << request.method << "with id:" << request.id;
     
-    QJsonValue result;
     QString errorMessage;
+    int errorCode = MCPProtocol::MethodNotFound;
+    bool deferredB = false;
+    QJsonValue result = executeMethod(job, errorMessage, errorCode, deferredB);
+    
+    // A heavy query that handed its work to the job registry keeps its
+    // scheduler slot until handleJobFinished() sees the job end
+    bool completedB = true;
+    if (job.priority == MCPScheduler::Priority::HeavyQuery) {
+        const int jobId = m_jobsP->findByRequest(job.owner, request.id);
+        if (jobId > 0 && !m_heavyJobs.contains(jobId)) {
+            m_heavyJobs.insert(jobId);
+            completedB = false;
+        }
+    }
+    
+    if (deferredB) {
+        return completedB;
+    }
+    
+    if (!errorMessage.isEmpty()) {
+        sendResponse(job.client, createErrorResponse(errorCode, errorMessage, request.id));
+        return completedB;
+    }
+    
+    if (job.key.isEmpty()) {
+        sendResponse(job.client, createSuccessResponse(result, request.id));
+        return completedB;
+    }
+    
+    // Single-flight: identical read-only requests still waiting in the
+    // scheduler get the same result, serialized only once
+    const QByteArray shared = MCPProtocol::encodeSharedResult(result);
+    sendEncoded(job.client, MCPProtocol::withId(shared, request.id));
+    
+    const QList<MCPScheduler::Job> waiters = m_schedulerP->takeIdentical(job);
+    for (const MCPScheduler::Job &waiter : waiters) {
+        sendEncoded(waiter.client, MCPProtocol::withId(shared, waiter.request.id));
+    }
+    
+    if (!waiters.isEmpty()) {
+        qDebug() << "Answered" << waiters.size() << "identical" << request.method << "request(s) from one result";
+    }
+    return completedB;
+}
+
+bool MCPServer::isReadOnlyMethod(const QString &method)
+{
+    static const QSet<QString> readOnlyMethods = {
+        "getVersion", "listProjects", "listBuildConfigs", "getCurrentProject",
+        "getCurrentBuildConfig", "listOpenFiles", "listSessions", "getCurrentSession",
+        "listIssues", "listMethods", "getMethodMetadata", "getBuildHistory", "compareBuilds",
+        "getParseState", "readRunOutput", "getRunStatus",
+        "listRunningApplications", "listActions", "getDebuggerSnapshot",
+        "listBreakpoints", "readDocument", "findFiles", "getWorkspaceSnapshot",
+        "listKits", "listTargets", "getCompileFlags"
+    };
+    return readOnlyMethods.contains(method);
+}
+
+QJsonValue MCPServer::executeMethod(const MCPScheduler::Job &job, QString &errorMessage, int &errorCode, bool &deferredB)
+{
+    QTcpSocket *client = job.client;
+    const QString &method = job.request.method;
+    const QJsonValue &params = job.request.params;
+    QJsonValue result;
     
     // Route the method to appropriate handler
     if (method == "build") {
@@ -186,6 +598,10 @@ void MCPServer::processRequest(QTcpSocket *client, const QJsonObject &request)
         int timeout = m_commandsP->getMethodTimeout("build");
         buildResult["message"] = QString("Build started. This operation may take up to %1 seconds.").arg(timeout);
         buildResult["timeoutInfo"] = "Call getMethodMetadata() for expected operation durations";
+        if (successB) {
+            buildResult["jobId"] = m_jobsP->start("build", job.owner, job.request.id,
+                                                  [this] { m_commandsP->cancelBuild(); }, job.deadline);
+        }
         result = buildResult;
     }
     else if (method == "debug") {
@@ -194,6 +610,7 @@ void MCPServer::processRequest(QTcpSocket *client, const QJsonObject &request)
         QJsonObject debugResult;
         debugResult["output"] = debugResults;
         debugResult["timeoutInfo"] = "Call getMethodMetadata() for expected operation durations";
+        debugResult["runInfo"] = "Call listRunningApplications() to see whether the debuggee is running";
         result = debugResult;
     }
     else if (method == "getVersion") {
@@ -212,6 +629,24 @@ void MCPServer::processRequest(QTcpSocket *client, const QJsonObject &request)
             result = successB;
         }
     }
+    else if (method == "openFiles") {
+        const QJsonObject query = params.toObject();
+        const QJsonArray files = query.value("files").toArray();
+        if (files.isEmpty()) {
+            errorMessage = "Invalid parameters for openFiles: files is required";
+        } else {
+            const QJsonArray opened = m_commandsP->openFiles(files, query.value("activateLast").toBool(true));
+            int failed = 0;
+            for (const QJsonValue &entry : opened) {
+                failed += entry.toObject().value("success").toBool() ? 0 : 1;
+            }
+            QJsonObject openResult;
+            openResult["results"] = opened;
+            openResult["opened"] = opened.size() - failed;
+            openResult["failed"] = failed;
+            result = openResult;
+        }
+    }
     else if (method == "listProjects") {
         QStringList projects = m_commandsP->listProjects();
         QJsonArray projectArray;
@@ -256,6 +691,8 @@ void MCPServer::processRequest(QTcpSocket *client, const QJsonObject &request)
         int timeout = m_commandsP->getMethodTimeout("runProject");
         runResult["message"] = QString("Project run started. This operation may take up to %1 seconds.").arg(timeout);
         runResult["timeoutInfo"] = "Call getMethodMetadata() for expected operation durations";
+        runResult["outputInfo"] = "The run gets a runId once it starts (notifications/runStarted on the run topic); "
+                                  "readRunOutput and getRunStatus default to the most recent run";
         result = runResult;
     }
     else if (method == "cleanProject") {
@@ -265,8 +702,51 @@ void MCPServer::processRequest(QTcpSocket *client, const QJsonObject &request)
         int timeout = m_commandsP->getMethodTimeout("cleanProject");
         cleanResult["message"] = QString("Project clean started. This operation may take up to %1 seconds.").arg(timeout);
         cleanResult["timeoutInfo"] = "Call getMethodMetadata() for expected operation durations";
+        if (successB) {
+            cleanResult["jobId"] = m_jobsP->start("cleanProject", job.owner, job.request.id,
+                                                  [this] { m_commandsP->cancelBuild(); }, job.deadline);
+        }
         result = cleanResult;
     }
+    else if (method == "compileFile" || method == "buildTarget") {
+        const QString argument = params.toObject().value(method == "compileFile" ? "path" : "name").toString();
+        QString failure;
+        bool successB = method == "compileFile" ? m_commandsP->compileFile(argument, failure)
+                                                : m_commandsP->buildTarget(argument, failure);
+        QJsonObject buildResult;
+        buildResult["success"] = successB;
+        if (successB) {
+            buildResult["message"] = QString("%1 started for %2").arg(method, argument);
+            buildResult["jobId"] = m_jobsP->start(method, job.owner, job.request.id,
+                                                  [this] { m_commandsP->cancelBuild(); }, job.deadline);
+        } else {
+            buildResult["message"] = failure;
+        }
+        result = buildResult;
+    }
+    else if (method == "buildMatrix") {
+        QStringList configs;
+        for (const QJsonValue &config : params.toObject().value("configs").toArray()) {
+            configs.append(config.toString());
+        }
+        
+        // The job must exist before the first progress notification goes out
+        const int previousJobId = m_matrixJobId;
+        m_matrixJobId = m_jobsP->start("buildMatrix", job.owner, job.request.id,
+                                       [this] { m_buildMatrixP->cancel(); }, job.deadline);
+        QString failure;
+        if (!m_buildMatrixP->start(configs, failure)) {
+            m_jobsP->discard(m_matrixJobId);
+            m_matrixJobId = previousJobId;
+            errorMessage = failure;
+        } else {
+            QJsonObject matrixResult;
+            matrixResult["jobId"] = m_matrixJobId;
+            matrixResult["configs"] = QJsonArray::fromStringList(configs);
+            matrixResult["message"] = "Build matrix started. Progress is sent as notifications/buildMatrixProgress on the build topic";
+            result = matrixResult;
+        }
+    }
     else if (method == "listOpenFiles") {
         QStringList files = m_commandsP->listOpenFiles();
         QJsonArray fileArray;
@@ -305,16 +785,230 @@ void MCPServer::processRequest(QTcpSocket *client, const QJsonObject &request)
         bool successB = m_commandsP->saveSession();
         result = successB;
     }
+    else if (method == "getWorkspaceSnapshot") {
+        result = workspaceSnapshot(params.toObject().value("fields").toArray(), errorMessage);
+    }
     else if (method == "listIssues") {
         QStringList issues = m_commandsP->listIssues();
         result = QJsonArray::fromStringList(issues);
     }
+    else if (method == "subscribe") {
+        result = updateSubscriptions(client, params, true, errorMessage);
+    }
+    else if (method == "unsubscribe") {
+        result = updateSubscriptions(client, params, false, errorMessage);
+    }
+    else if (method == "getJobStatus") {
+        const int jobId = params.toObject().value("jobId").toInt(-1);
+        if (!m_jobsP->contains(jobId)) {
+            errorMessage = QString("Unknown job: %1").arg(jobId);
+        } else {
+            result = m_jobsP->status(jobId);
+        }
+    }
+    else if (method == "waitForJob") {
+        const int jobId = params.toObject().value("jobId").toInt(-1);
+        const int timeoutMs = params.toObject().value("timeoutMs").toInt(30000);
+        if (!m_jobsP->contains(jobId)) {
+            errorMessage = QString("Unknown job: %1").arg(jobId);
+        } else if (!m_jobsP->isRunning(jobId)) {
+            result = m_jobsP->status(jobId);
+        } else {
+            startLongPoll(job, jobId, timeoutMs);
+            deferredB = true;
+        }
+    }
+    else if (method == "runAndWait") {
+        const QJsonObject query = params.toObject();
+        std::optional<QStringList> arguments;
+        if (query.contains("args")) {
+            QStringList list;
+            for (const QJsonValue &argument : query.value("args").toArray()) {
+                list.append(argument.toString());
+            }
+            arguments = list;
+        }
+        
+        QString failure;
+        const int runId = m_runsP->start(arguments, query.value("env").toObject(),
+                                         query.value("workingDir").toString(), failure);
+        if (runId < 0) {
+            errorMessage = failure;
+        } else {
+            startRunWait(job, runId, query.value("timeoutMs").toInt(60000));
+            deferredB = true;
+        }
+    }
+    else if (method == "readRunOutput") {
+        const QJsonObject query = params.toObject();
+        result = m_runsP->readOutput(query.value("runId").toInt(-1),
+                                     query.value("sinceSeq").toInteger(0), errorMessage);
+    }
+    else if (method == "listRunningApplications") {
+        result = m_runsP->runningApplications();
+    }
+    else if (method == "getRunStatus") {
+        result = m_runsP->status(params.toObject().value("runId").toInt(-1), errorMessage);
+    }
+    else if (method == "listActions" || method == "triggerAction") {
+        MCPActionIndex *actions = MCPActionIndex::instance();
+        const QJsonObject query = params.toObject();
+        if (!actions) {
+            errorMessage = "Action index not available yet";
+        } else if (method == "listActions") {
+            result = actions->list(query.value("filter").toString(), qBound(1, query.value("limit").toInt(200), 5000));
+        } else if (actions->trigger(query.value("id").toString(), errorMessage)) {
+            QJsonObject triggerResult;
+            triggerResult["success"] = true;
+            triggerResult["id"] = query.value("id");
+            result = triggerResult;
+        }
+    }
+    else if (method == "getDebuggerSnapshot") {
+        const QJsonObject query = params.toObject();
+        MCPDebuggerInspector::Limits limits;
+        limits.maxFrames = qBound(1, query.value("maxFrames").toInt(limits.maxFrames), 500);
+        limits.maxDepth = qBound(1, query.value("maxDepth").toInt(limits.maxDepth), 8);
+        limits.varFilter = query.value("varFilter").toString();
+        result = m_debuggerP->snapshot(limits);
+    }
+    else if (method == "setBreakpoints") {
+        const QJsonValue items = params.isArray() ? params : params.toObject().value("breakpoints");
+        result = m_breakpointsP->set(items.toArray(), errorMessage);
+    }
+    else if (method == "clearBreakpoints") {
+        result = m_breakpointsP->clear(params.toObject(), errorMessage);
+    }
+    else if (method == "listBreakpoints") {
+        result = m_breakpointsP->list(errorMessage);
+    }
+    else if (method == "readDocument") {
+        result = m_documentsP->read(params.toObject(), errorMessage);
+    }
+    else if (method == "applyEdits") {
+        result = m_documentsP->applyEdits(params.toObject(), errorMessage, errorCode);
+    }
+    else if (method == "findFiles") {
+        const QJsonObject query = params.toObject();
+        const QString pattern = query.value("pattern").toString();
+        if (pattern.isEmpty()) {
+            errorMessage = "pattern is required";
+        } else {
+            result = m_fileIndexP->find(pattern, query.value("fuzzy").toBool(false),
+                                        qBound(1, query.value("limit").toInt(50), 5000),
+                                        query.value("project").toString());
+        }
+    }
+    else if (method == "findSymbol" || method == "findReferences") {
+        const QJsonObject query = params.toObject();
+        const int limit = qBound(1, query.value("limit").toInt(100), 2000);
+        const int searchId = method == "findSymbol"
+            ? m_symbolsP->findSymbol(query.value("name").toString(), query.value("kind").toString(),
+                                     limit, errorMessage)
+            : m_symbolsP->findReferences(query.value("path").toString(), query.value("line").toInt(),
+                                         query.value("column").toInt(), limit, errorMessage);
+        if (searchId >= 0) {
+            const int jobId = m_jobsP->start(method, job.owner, job.request.id,
+                                             [this, searchId] { m_symbolsP->cancel(searchId); }, job.deadline);
+            m_symbolJobs.insert(searchId, jobId);
+            
+            QJsonObject searchResult;
+            searchResult["jobId"] = jobId;
+            searchResult["message"] = "Search started. Matches are sent as notifications/searchResults on the search topic";
+            result = searchResult;
+        }
+    }
+    else if (method == "searchInFiles") {
+        const QJsonObject query = params.toObject();
+        MCPTextSearch::Query search;
+        search.pattern = query.value("pattern").toString();
+        search.regex = query.value("regex").toBool(false);
+        search.caseSensitive = query.value("caseSensitive").toBool(false);
+        search.scope = query.value("scope").toString("project");
+        search.project = query.value("project").toString();
+        search.directory = query.value("directory").toString();
+        for (const QJsonValue &filePattern : query.value("filePatterns").toArray()) {
+            search.filePatterns.append(filePattern.toString());
+        }
+        search.limit = qBound(1, query.value("limit").toInt(1000), 100000);
+        
+        const int searchId = m_textSearchP->start(search, errorMessage);
+        if (searchId >= 0) {
+            const int jobId = m_jobsP->start(method, job.owner, job.request.id,
+                                             [this, searchId] { m_textSearchP->cancel(searchId); }, job.deadline);
+            m_textSearchJobs.insert(searchId, jobId);
+            
+            QJsonObject searchResult;
+            searchResult["jobId"] = jobId;
+            searchResult["message"] = "Search started. Matches are sent as notifications/searchResults on the search topic";
+            result = searchResult;
+        }
+    }
+    else if (method == "getDiagnostics") {
+        QStringList paths;
+        for (const QJsonValue &path : params.toObject().value("paths").toArray()) {
+            paths.append(path.toString());
+        }
+        result = m_diagnosticsP->diagnostics(paths);
+    }
+    else if (method == "listKits") {
+        result = m_kitsP->kits();
+    }
+    else if (method == "listTargets") {
+        result = m_kitsP->targets(params.toObject().value("project").toString(), errorMessage);
+    }
+    else if (method == "switchKit") {
+        const QString kit = params.toObject().value("kit").toString();
+        if (kit.isEmpty()) {
+            errorMessage = "kit is required";
+        } else {
+            bool successB = m_kitsP->switchKit(kit, errorMessage);
+            result = successB;
+        }
+    }
+    else if (method == "getCompileFlags") {
+        const QString path = params.toObject().value("path").toString();
+        if (path.isEmpty()) {
+            errorMessage = "path is required";
+        } else {
+            result = m_kitsP->compileFlags(path, errorMessage);
+        }
+    }
+    else if (method == "exportCompilationDatabase") {
+        const int exportId = m_kitsP->exportDatabase(params.toObject().value("project").toString(), errorMessage);
+        if (exportId >= 0) {
+            const int jobId = m_jobsP->start(method, job.owner, job.request.id,
+                                             [this, exportId] { m_kitsP->cancelExport(exportId); }, job.deadline);
+            m_exportJobs.insert(exportId, jobId);
+            
+            QJsonObject exportResult;
+            exportResult["jobId"] = jobId;
+            exportResult["message"] = "Export started. Entries are sent as notifications/compilationDatabase on the project topic";
+            result = exportResult;
+        }
+    }
+    else if (method == "getParseState") {
+        result = m_parseTrackerP->state();
+    }
+    else if (method == "getBuildHistory") {
+        const QJsonObject query = params.toObject();
+        const int limit = qBound(1, query.value("limit").toInt(20), 500);
+        result = m_buildHistoryP->history(query.value("project").toString(),
+                                          query.value("buildConfig").toString(), limit);
+    }
+    else if (method == "compareBuilds") {
+        result = m_buildHistoryP->compare(params.toObject(), errorMessage);
+    }
+    else if (method == "getSchedulerStats") {
+        result = m_schedulerP->statistics();
+    }
     else if (method == "listMethods") {
         QJsonArray methods;
         methods.append("build");
         methods.append("debug");
         methods.append("getVersion");
         methods.append("openFile");
+        methods.append("openFiles");
         methods.append("listProjects");
         methods.append("listBuildConfigs");
         methods.append("switchToBuildConfig");
@@ -332,6 +1026,41 @@ void MCPServer::processRequest(QTcpSocket *client, const QJsonObject &request)
         methods.append("listMethods");
         methods.append("getMethodMetadata");
         methods.append("setMethodMetadata");
+        methods.append("subscribe");
+        methods.append("unsubscribe");
+        methods.append("getSchedulerStats");
+        methods.append("compileFile");
+        methods.append("buildTarget");
+        methods.append("buildMatrix");
+        methods.append("getJobStatus");
+        methods.append("runAndWait");
+        methods.append("readRunOutput");
+        methods.append("getRunStatus");
+        methods.append("listRunningApplications");
+        methods.append("listActions");
+        methods.append("triggerAction");
+        methods.append("getDebuggerSnapshot");
+        methods.append("setBreakpoints");
+        methods.append("clearBreakpoints");
+        methods.append("listBreakpoints");
+        methods.append("readDocument");
+        methods.append("applyEdits");
+        methods.append("findFiles");
+        methods.append("findSymbol");
+        methods.append("findReferences");
+        methods.append("getDiagnostics");
+        methods.append("searchInFiles");
+        methods.append("getWorkspaceSnapshot");
+        methods.append("listKits");
+        methods.append("listTargets");
+        methods.append("switchKit");
+        methods.append("getCompileFlags");
+        methods.append("exportCompilationDatabase");
+        methods.append("getParseState");
+        methods.append("getBuildHistory");
+        methods.append("compareBuilds");
+        methods.append("waitForJob");
+        methods.append("$/cancelRequest");
         result = methods;
     }
     else if (method == "getMethodMetadata") {
@@ -347,9 +1076,21 @@ void MCPServer::processRequest(QTcpSocket *client, const QJsonObject &request)
             }
         }
         
+        // Measured durations, for the current project unless another one is asked for
+        const QJsonObject query = params.toObject();
+        const QString project = query.value("project").toString();
+        const QString buildConfig = query.value("buildConfig").toString();
+        QJsonObject predictions;
+        for (const QString &methodName : {QString("build"), QString("cleanProject"), QString("runProject"), QString("parse")}) {
+            predictions[methodName] = m_commandsP->getDurationPrediction(methodName, project, buildConfig);
+        }
+        predictions["loadSession"] = m_commandsP->getDurationPrediction("loadSession", query.value("session").toString());
+        
         metadata["expectedDurations"] = methodDurations;
+        metadata["predictedDurations"] = predictions;
         metadata["description"] = "Provides metadata about MCP methods, including expected operation durations in seconds";
-        metadata["note"] = "Use setMethodMetadata() to customize timeout values";
+        metadata["note"] = "expectedDurations follow the measured p90 once a method has a few samples. "
+                           "Use setMethodMetadata() to pin a timeout value";
         
         result = metadata;
     }
@@ -371,35 +1112,183 @@ void MCPServer::processRequest(QTcpSocket *client, const QJsonObject &request)
         errorMessage = QString("Unknown method: %1").arg(method);
     }
     
-    if (!errorMessage.isEmpty()) {
-        sendResponse(client, createErrorResponse(-32601, errorMessage, id));
+    return result;
+}
+
+void MCPServer::handleCancelRequest(QTcpSocket *client, const MCPRequest &request)
+{
+    const QJsonObject params = request.params.toObject();
+    const QJsonValue targetId = params.value("id");
+    bool cancelledB = false;
+    
+    MCPScheduler::Job queued;
+    if (params.contains("jobId")) {
+        // Any client may stop a job it knows the id of
+        cancelledB = m_jobsP->cancel(params.value("jobId").toInt(-1));
+    } else if (m_schedulerP->cancel(client, targetId, queued)) {
+        sendResponse(client, createErrorResponse(MCPProtocol::RequestCancelled, "Request cancelled", targetId));
+        cancelledB = true;
+    } else if (finishLongPoll(client, targetId)) {
+        sendResponse(client, createErrorResponse(MCPProtocol::RequestCancelled, "Request cancelled", targetId));
+        cancelledB = true;
     } else {
-        sendResponse(client, createSuccessResponse(result, id));
+        const int jobId = m_jobsP->findByRequest(client, targetId);
+        cancelledB = jobId > 0 && m_jobsP->cancel(jobId);
+    }
+    
+    qDebug() << "Cancel request for" << (params.contains("jobId") ? params.value("jobId") : targetId)
+             << (cancelledB ? "succeeded" : "found nothing to cancel");
+    
+    // $/cancelRequest is a notification; answer only if the client sent an id
+    if (!request.id.isUndefined()) {
+        QJsonObject result;
+        result["cancelled"] = cancelledB;
+        sendResponse(client, createSuccessResponse(result, request.id));
     }
 }
 
-QJsonObject MCPServer::createErrorResponse(int code, const QString &message, const QJsonValue &id)
+void MCPServer::startLongPoll(const MCPScheduler::Job &job, int jobId, int timeoutMs)
 {
-    QJsonObject response;
-    response["jsonrpc"] = "2.0";
-    response["id"] = id;
+    qint64 waitMs = qMax(0, timeoutMs);
+    if (!job.deadline.isForever()) {
+        waitMs = qMin(waitMs, job.deadline.remainingTime());
+    }
     
-    QJsonObject error;
-    error["code"] = code;
-    error["message"] = message;
-    response["error"] = error;
+    LongPoll poll;
+    poll.owner = job.owner;
+    poll.client = job.client;
+    poll.requestId = job.request.id;
+    poll.jobId = jobId;
+    poll.deadline = job.deadline;
+    poll.timerP = new QTimer(this);
+    poll.timerP->setSingleShot(true);
     
-    return response;
+    QTcpSocket *owner = job.owner;
+    const QJsonValue requestId = job.request.id;
+    connect(poll.timerP, &QTimer::timeout, this, [this, owner, requestId] {
+        for (const LongPoll &poll : std::as_const(m_longPolls)) {
+            if (poll.owner != owner || poll.requestId != requestId) {
+                continue;
+            }
+            if (poll.deadline.hasExpired()) {
+                sendResponse(poll.client, createErrorResponse(MCPProtocol::RequestCancelled,
+                                                              "Request deadline exceeded", requestId));
+            } else {
+                sendResponse(poll.client, createSuccessResponse(m_jobsP->status(poll.jobId), requestId));
+            }
+            break;
+        }
+        finishLongPoll(owner, requestId);
+    });
+    poll.timerP->start(int(waitMs));
+    m_longPolls.append(poll);
 }
 
-QJsonObject MCPServer::createSuccessResponse(const QJsonValue &result, const QJsonValue &id)
+bool MCPServer::finishLongPoll(QTcpSocket *client, const QJsonValue &requestId)
 {
-    QJsonObject response;
-    response["jsonrpc"] = "2.0";
-    response["id"] = id;
-    response["result"] = result;
+    for (int i = 0; i < m_longPolls.size(); ++i) {
+        if (m_longPolls.at(i).owner == client && m_longPolls.at(i).requestId == requestId) {
+            m_longPolls.takeAt(i).timerP->deleteLater();
+            return true;
+        }
+    }
+    return false;
+}
+
+void MCPServer::startRunWait(const MCPScheduler::Job &job, int runId, int timeoutMs)
+{
+    RunWait wait;
+    wait.owner = job.owner;
+    wait.client = job.client;
+    wait.requestId = job.request.id;
+    wait.runId = runId;
+    wait.jobId = m_jobsP->start("runAndWait", job.owner, job.request.id,
+                                [this, runId] { m_runsP->stop(runId); }, job.deadline);
+    wait.timerP = new QTimer(this);
+    wait.timerP->setSingleShot(true);
     
-    return response;
+    // On timeout the application is stopped; if it does not react, answer anyway
+    connect(wait.timerP, &QTimer::timeout, this, [this, runId] {
+        for (RunWait &wait : m_runWaits) {
+            if (wait.runId != runId) {
+                continue;
+            }
+            if (wait.timedOutB) {
+                finishRunWait(runId);
+            } else {
+                qDebug() << "runAndWait timed out, stopping run" << runId;
+                wait.timedOutB = true;
+                m_runsP->stop(runId);
+                wait.timerP->start(RunStopGraceMs);
+            }
+            return;
+        }
+    });
+    wait.timerP->start(qMax(0, timeoutMs));
+    m_runWaits.append(wait);
+}
+
+void MCPServer::finishRunWait(int runId)
+{
+    for (int i = 0; i < m_runWaits.size(); ++i) {
+        if (m_runWaits.at(i).runId != runId) {
+            continue;
+        }
+        
+        RunWait wait = m_runWaits.takeAt(i);
+        wait.timerP->deleteLater();
+        
+        QString ignored;
+        QJsonObject result = m_runsP->status(runId, ignored);
+        bool truncatedB = false;
+        result["output"] = m_runsP->collectOutput(runId, truncatedB);
+        result["truncated"] = truncatedB;
+        result["timedOut"] = wait.timedOutB;
+        
+        QJsonObject details;
+        details["runId"] = runId;
+        details["exitCode"] = result.value("exitCode");
+        details["timedOut"] = wait.timedOutB;
+        const bool successB = !wait.timedOutB && result.value("exitCode").toInt(-1) == 0;
+        m_jobsP->finish(wait.jobId, successB, details);
+        
+        // A cancelled or expired request gets the error, not the result
+        const QJsonObject error = m_jobsP->status(wait.jobId).value("error").toObject();
+        if (!error.isEmpty()) {
+            sendResponse(wait.client, createErrorResponse(error.value("code").toInt(),
+                                                          error.value("message").toString(), wait.requestId));
+        } else {
+            sendResponse(wait.client, createSuccessResponse(result, wait.requestId));
+        }
+        return;
+    }
+}
+
+void MCPServer::handleJobFinished(int jobId, const QJsonObject &status)
+{
+    if (m_heavyJobs.remove(jobId)) {
+        m_schedulerP->jobFinished();
+    }
+    
+    publish(NotificationTopic::Jobs, "notifications/jobFinished", status);
+    
+    for (int i = m_longPolls.size() - 1; i >= 0; --i) {
+        if (m_longPolls.at(i).jobId == jobId) {
+            LongPoll poll = m_longPolls.takeAt(i);
+            poll.timerP->deleteLater();
+            sendResponse(poll.client, createSuccessResponse(status, poll.requestId));
+        }
+    }
+}
+
+QJsonObject MCPServer::createErrorResponse(int code, const QString &message, const QJsonValue &id)
+{
+    return MCPProtocol::errorResponse(code, message, id);
+}
+
+QJsonObject MCPServer::createSuccessResponse(const QJsonValue &result, const QJsonValue &id)
+{
+    return MCPProtocol::successResponse(result, id);
 }
 
 } // namespace Internal
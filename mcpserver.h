@@ -8,12 +8,47 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QTimer>
+#include <QHash>
+#include <QPointer>
+#include <QSet>
+
+#include <bitset>
+#include <optional>
 
 #include "mcpcommands.h"
+#include "mcpprotocol.h"
+#include "mcpscheduler.h"
+#include "mcpjobs.h"
+#include "mcpbuildhistory.h"
+#include "mcpbuildmatrix.h"
+#include "mcpparsetracker.h"
+#include "mcpruns.h"
+#include "mcpdebugger.h"
+#include "mcpbreakpoints.h"
+#include "mcpdocuments.h"
+#include "mcpfileindex.h"
+#include "mcpsymbols.h"
+#include "mcpdiagnostics.h"
+#include "mcptextsearch.h"
+#include "mcpkits.h"
 
 namespace Qt_MCP_Plugin {
 namespace Internal {
 
+// Topics a client can subscribe to; each one is a bit in ClientState::topics
+enum class NotificationTopic {
+    Build,
+    Issues,
+    Project,
+    Session,
+    Jobs,
+    Run,
+    Debugger,
+    Search,
+    Diagnostics,
+    Count
+};
+
 class MCPServer : public QObject
 {
     Q_OBJECT
@@ -27,22 +62,104 @@ public:
     bool isRunning() const;
     quint16 getPort() const;
 
+    // Sends one notification to every client subscribed to the topic
+    void publish(NotificationTopic topic, const QString &method, QJsonObject params = QJsonObject());
+
+    // Takes over a connected client socket; the server deletes it on disconnect
+    void attachClient(QTcpSocket *client);
+
+    // Handles bytes read from a client, as readyRead does (also used by the fuzz target)
+    void receive(QTcpSocket *client, const QByteArray &data);
+
 private slots:
     void handleNewConnection();
     void handleClientData();
     void handleClientDisconnected();
+    void handleJobFinished(int jobId, const QJsonObject &status);
 
 private:
+    static constexpr int RunStopGraceMs = 5000;
+    static constexpr int TopicCount = int(NotificationTopic::Count);
+
+    struct ClientState
+    {
+        MCPFrameBuffer frames;
+        std::bitset<TopicCount> topics;
+    };
+
+    // A waitForJob request that is answered when its job finishes
+    struct LongPoll
+    {
+        QTcpSocket *owner = nullptr;
+        QPointer<QTcpSocket> client;
+        QJsonValue requestId;
+        int jobId = 0;
+        QDeadlineTimer deadline;
+        QTimer *timerP = nullptr;
+    };
+
+    // A runAndWait request that is answered when its run exits
+    struct RunWait
+    {
+        QTcpSocket *owner = nullptr;
+        QPointer<QTcpSocket> client;
+        QJsonValue requestId;
+        int runId = 0;
+        int jobId = 0;
+        bool timedOutB = false;
+        QTimer *timerP = nullptr;
+    };
+
     void sendResponse(QTcpSocket *client, const QJsonObject &response);
-    void processRequest(QTcpSocket *client, const QJsonObject &request);
+    void sendEncoded(QTcpSocket *client, const QByteArray &data);
+    void processRequest(QTcpSocket *client, const MCPRequest &request);
+    bool runJob(MCPScheduler::Job &job);
+    QJsonValue executeMethod(const MCPScheduler::Job &job, QString &errorMessage, int &errorCode, bool &deferredB);
+    void handleCancelRequest(QTcpSocket *client, const MCPRequest &request);
+    void startLongPoll(const MCPScheduler::Job &job, int jobId, int timeoutMs);
+    bool finishLongPoll(QTcpSocket *client, const QJsonValue &requestId);
+    void startRunWait(const MCPScheduler::Job &job, int runId, int timeoutMs);
+    void finishRunWait(int runId);
+    QJsonObject workspaceSnapshot(const QJsonArray &fields, QString &errorMessage);
+    QJsonValue updateSubscriptions(QTcpSocket *client, const QJsonValue &params, bool subscribe, QString &errorMessage);
+    void updateTopicSources();
+    void connectCommandEvents();
+    static QString topicName(NotificationTopic topic);
+    static bool isReadOnlyMethod(const QString &method);
     QJsonObject createErrorResponse(int code, const QString &message, const QJsonValue &id = QJsonValue::Null);
     QJsonObject createSuccessResponse(const QJsonValue &result, const QJsonValue &id = QJsonValue::Null);
 
 private:
     QTcpServer *m_serverP;
     QList<QTcpSocket*> m_clients;
+    QHash<QTcpSocket*, ClientState> m_clientStates;
     MCPCommands *m_commandsP;
     quint16 m_port;
+    MCPScheduler *m_schedulerP;
+    MCPJobRegistry *m_jobsP;
+    QSet<int> m_heavyJobs;   // registry jobs holding one of the scheduler's heavy-query slots
+    MCPBuildHistory *m_buildHistoryP;
+    MCPParseTracker *m_parseTrackerP;
+    MCPBuildMatrix *m_buildMatrixP;
+    int m_matrixJobId = 0;
+    MCPRunRegistry *m_runsP;
+    QList<RunWait> m_runWaits;
+    MCPDebuggerInspector *m_debuggerP;
+    MCPBreakpoints *m_breakpointsP;
+    MCPDocuments *m_documentsP;
+    MCPFileIndex *m_fileIndexP;
+    MCPSymbolSearch *m_symbolsP;
+    QHash<int, int> m_symbolJobs;   // symbol search id -> job id
+    MCPDiagnostics *m_diagnosticsP;
+    MCPTextSearch *m_textSearchP;
+    QHash<int, int> m_textSearchJobs;   // text search id -> job id
+    MCPKits *m_kitsP;
+    QHash<int, int> m_exportJobs;   // compilation database export id -> job id
+    QList<LongPoll> m_longPolls;
+    QTimer *m_issuesTimerP;
+    quint64 m_notificationSeq = 0;
+    int m_issueErrors = 0;
+    int m_issueWarnings = 0;
 };
 
 } // namespace Internal
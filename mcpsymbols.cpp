@@ -0,0 +1,274 @@
+#include "mcpsymbols.h"
+#include "mcpdocuments.h"
+
+#include <coreplugin/editormanager/documentmodel.h>
+#include <coreplugin/locator/ilocatorfilter.h>
+#include <cplusplus/CppDocument.h>
+#include <cplusplus/FindUsages.h>
+#include <cplusplus/LookupContext.h>
+#include <cppeditor/cppcanonicalsymbol.h>
+#include <cppeditor/cppmodelmanager.h>
+#include <texteditor/textdocument.h>
+#include <utils/async.h>
+
+#include <QDebug>
+#include <QFile>
+#include <QFutureWatcher>
+#include <QTextBlock>
+#include <QTextCursor>
+#include <QTextDocument>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+using Usages = QList<CPlusPlus::Usage>;
+
+MCPSymbolSearch::MCPSymbolSearch(QObject *parent)
+    : QObject(parent)
+{
+}
+
+MCPSymbolSearch::~MCPSymbolSearch()
+{
+    for (Search &search : m_searches) {
+        if (search.stop) {
+            search.stop();
+        }
+    }
+}
+
+int MCPSymbolSearch::addSearch(int limit)
+{
+    const int searchId = m_nextId++;
+    m_searches[searchId].limit = limit;
+    return searchId;
+}
+
+int MCPSymbolSearch::findSymbol(const QString &name, const QString &kind, int limit, QString &errorMessage)
+{
+    if (name.isEmpty()) {
+        errorMessage = "name is required";
+        return -1;
+    }
+
+    Core::MatcherType type = Core::MatcherType::AllSymbols;
+    if (kind == "class") {
+        type = Core::MatcherType::Classes;
+    } else if (kind == "function") {
+        type = Core::MatcherType::Functions;
+    } else if (!kind.isEmpty() && kind != "all") {
+        errorMessage = QString("Unknown kind '%1' (use class, function or all)").arg(kind);
+        return -1;
+    }
+
+    const Core::LocatorMatcherTasks tasks = Core::LocatorMatcher::matchers(type);
+    if (tasks.isEmpty()) {
+        errorMessage = "No symbol index available (is the C++ plugin enabled?)";
+        return -1;
+    }
+
+    const int searchId = addSearch(limit);
+    auto matcher = new Core::LocatorMatcher;
+    matcher->setParent(this);
+    matcher->setTasks(tasks);
+    matcher->setInputData(name);
+
+    connect(matcher, &Core::LocatorMatcher::serialOutputDataReady,
+            this, [this, searchId](const Core::LocatorFilterEntries &entries) {
+        QJsonArray batch;
+        for (const Core::LocatorFilterEntry &entry : entries) {
+            QJsonObject match;
+            match["name"] = entry.displayName;
+            if (!entry.extraInfo.isEmpty()) {
+                match["info"] = entry.extraInfo;
+            }
+            if (entry.linkForEditor) {
+                match["file"] = entry.linkForEditor->targetFilePath.toFSPathString();
+                match["line"] = entry.linkForEditor->target.line;
+                match["column"] = entry.linkForEditor->target.column;
+            } else if (!entry.filePath.isEmpty()) {
+                match["file"] = entry.filePath.toFSPathString();
+            }
+            batch.append(match);
+        }
+        addMatches(searchId, batch);
+    });
+    connect(matcher, &Core::LocatorMatcher::done, this, [this, searchId] {
+        finish(searchId);
+    });
+
+    Search &search = m_searches[searchId];
+    search.stop = [this, matcher] {
+        disconnect(matcher, nullptr, this, nullptr);
+        matcher->deleteLater();
+    };
+
+    qDebug() << "Symbol search" << searchId << "for" << name << "kind" << kind;
+    matcher->start();
+    return searchId;
+}
+
+int MCPSymbolSearch::findReferences(const QString &path, int line, int column, int limit, QString &errorMessage)
+{
+    const Utils::FilePath filePath = Utils::FilePath::fromString(path);
+    const CPlusPlus::Snapshot snapshot = CppEditor::CppModelManager::snapshot();
+    const CPlusPlus::Document::Ptr document = snapshot.document(filePath);
+    if (!document) {
+        errorMessage = QString("%1 is not known to the C++ code model").arg(path);
+        return -1;
+    }
+
+    // Resolve the position against what the user sees, unsaved changes included
+    QTextDocument fileText;
+    QTextDocument *text = MCPDocuments::openBuffer(path);
+    if (!text) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            errorMessage = QString("Cannot read %1: %2").arg(path, file.errorString());
+            return -1;
+        }
+        fileText.setPlainText(QString::fromUtf8(file.readAll()));
+        text = &fileText;
+    }
+    const QTextBlock block = text->findBlockByNumber(line - 1);
+    if (!block.isValid() || column < 0 || column >= block.length()) {
+        errorMessage = QString("Position %1:%2 is outside of %3").arg(line).arg(column).arg(path);
+        return -1;
+    }
+    QTextCursor cursor(text);
+    cursor.setPosition(block.position() + column);
+
+    CppEditor::CanonicalSymbol canonicalSymbol(document, snapshot);
+    CPlusPlus::Symbol *symbol = canonicalSymbol(cursor);
+    if (!symbol || !symbol->identifier()) {
+        errorMessage = QString("No symbol at %1:%2:%3").arg(path).arg(line).arg(column);
+        return -1;
+    }
+
+    // Modified editors are searched as they are, not as saved
+    QHash<Utils::FilePath, QByteArray> buffers;
+    for (Core::IDocument *openDocument : Core::DocumentModel::openedDocuments()) {
+        auto textDocument = qobject_cast<TextEditor::TextDocument *>(openDocument);
+        if (textDocument && textDocument->isModified()) {
+            buffers.insert(textDocument->filePath(), textDocument->plainText().toUtf8());
+        }
+    }
+
+    // The lookup context keeps the documents the symbol lives in alive
+    const CPlusPlus::LookupContext context = canonicalSymbol.context();
+    QFuture<Usages> future = Utils::asyncRun([snapshot, context, symbol, buffers](QPromise<Usages> &promise) {
+        const CPlusPlus::Identifier *identifier = symbol->identifier();
+        for (auto it = snapshot.begin(); it != snapshot.end(); ++it) {
+            if (promise.isCanceled()) {
+                return;
+            }
+            const CPlusPlus::Document::Ptr candidate = it.value();
+            if (!candidate->control()->findIdentifier(identifier->chars(), identifier->size())) {
+                continue;
+            }
+
+            QByteArray source = buffers.value(candidate->filePath());
+            if (source.isEmpty()) {
+                QFile file(candidate->filePath().toFSPathString());
+                if (file.open(QIODevice::ReadOnly)) {
+                    source = file.readAll();
+                }
+            }
+
+            CPlusPlus::FindUsages process(source, candidate, snapshot, false);
+            process(symbol);
+            const Usages usages = process.usages();
+            if (!usages.isEmpty()) {
+                promise.addResult(usages);
+            }
+        }
+    });
+
+    const int searchId = addSearch(limit);
+    auto watcher = new QFutureWatcher<Usages>(this);
+    connect(watcher, &QFutureWatcherBase::resultReadyAt, this, [this, searchId, watcher](int index) {
+        QJsonArray batch;
+        for (const CPlusPlus::Usage &usage : watcher->resultAt(index)) {
+            QJsonObject match;
+            match["file"] = usage.path.toFSPathString();
+            match["line"] = usage.line;
+            match["column"] = usage.col;
+            match["length"] = usage.len;
+            match["text"] = usage.lineText.trimmed();
+            batch.append(match);
+        }
+        addMatches(searchId, batch);
+    });
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, searchId] {
+        finish(searchId);
+    });
+    watcher->setFuture(future);
+
+    Search &search = m_searches[searchId];
+    search.stop = [this, watcher] {
+        disconnect(watcher, nullptr, this, nullptr);
+        watcher->cancel();
+        watcher->deleteLater();
+    };
+
+    qDebug() << "References search" << searchId << "for" << symbol->identifier()->chars();
+    return searchId;
+}
+
+void MCPSymbolSearch::addMatches(int searchId, const QJsonArray &batch)
+{
+    auto it = m_searches.find(searchId);
+    if (it == m_searches.end() || batch.isEmpty()) {
+        return;
+    }
+
+    QJsonArray accepted;
+    for (const QJsonValue &match : batch) {
+        if (it->count >= it->limit) {
+            it->truncated = true;
+            break;
+        }
+        ++it->count;
+        accepted.append(match);
+    }
+    if (!accepted.isEmpty()) {
+        emit results(searchId, accepted);
+    }
+
+    // A match beyond the limit: no need to let the rest of the search run
+    if (it->truncated) {
+        finish(searchId);
+    }
+}
+
+void MCPSymbolSearch::cancel(int searchId)
+{
+    auto it = m_searches.find(searchId);
+    if (it == m_searches.end()) {
+        return;
+    }
+    it->cancelled = true;
+    finish(searchId);
+}
+
+void MCPSymbolSearch::finish(int searchId)
+{
+    auto it = m_searches.find(searchId);
+    if (it == m_searches.end()) {
+        return;
+    }
+
+    Search search = *it;
+    m_searches.erase(it);
+    if (search.stop) {
+        search.stop();
+    }
+
+    QJsonObject report;
+    report["count"] = search.count;
+    report["truncated"] = search.truncated;
+    emit finished(searchId, !search.cancelled, report);
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
@@ -0,0 +1,80 @@
+#ifndef MCPSYMBOLS_H
+#define MCPSYMBOLS_H
+
+#include <QObject>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+
+#include <functional>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+/**
+ * @brief Symbol and reference searches over the C++ code model
+ *
+ * findSymbol runs the Locator's symbol matchers (built-in index or clangd,
+ * whichever the C++ plugins registered) with the name as input.
+ * findReferences resolves the symbol under a position with the built-in
+ * code model and runs FindUsages over every document of the current
+ * snapshot that mentions its identifier, on a worker thread.
+ *
+ * Both run asynchronously. Matches are reported in batches through
+ * results() as they arrive, then finished() reports the count. A search
+ * stops by itself once a match beyond `limit` shows up.
+ */
+class MCPSymbolSearch : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MCPSymbolSearch(QObject *parent = nullptr);
+    ~MCPSymbolSearch() override;
+
+    /**
+     * @brief Starts a Locator symbol search
+     * @param kind "class", "function" or "all"
+     * @return A search id, or -1 with errorMessage set
+     */
+    int findSymbol(const QString &name, const QString &kind, int limit, QString &errorMessage);
+
+    /**
+     * @brief Starts a references search for the symbol at a position
+     * @param line 1-based line
+     * @param column 0-based column
+     * @return A search id, or -1 with errorMessage set
+     */
+    int findReferences(const QString &path, int line, int column, int limit, QString &errorMessage);
+
+    /**
+     * @brief Stops a search; finished() follows with cancelled set
+     */
+    void cancel(int searchId);
+
+signals:
+    void results(int searchId, const QJsonArray &batch);
+    void finished(int searchId, bool success, const QJsonObject &report);
+
+private:
+    struct Search
+    {
+        int limit = 0;
+        int count = 0;   // matches streamed through results()
+        bool cancelled = false;
+        bool truncated = false;
+        std::function<void()> stop;   // ends the LocatorMatcher or worker thread
+    };
+
+    int addSearch(int limit);
+    void addMatches(int searchId, const QJsonArray &batch);
+    void finish(int searchId);
+
+    QHash<int, Search> m_searches;
+    int m_nextId = 1;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPSYMBOLS_H
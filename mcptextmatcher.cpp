@@ -0,0 +1,88 @@
+#include "mcptextmatcher.h"
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+MCPTextMatcher::MCPTextMatcher(const QString &pattern, bool regex, bool caseSensitive,
+                               const QStringList &filePatterns)
+    : m_pattern(pattern)
+    , m_sensitivity(caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive)
+    , m_regexB(regex)
+{
+    if (regex) {
+        m_regex = QRegularExpression(pattern, caseSensitive ? QRegularExpression::NoPatternOption
+                                                            : QRegularExpression::CaseInsensitiveOption);
+    }
+    for (const QString &filePattern : filePatterns) {
+        m_filePatterns.append(QRegularExpression::fromWildcard(filePattern, Qt::CaseInsensitive));
+    }
+}
+
+bool MCPTextMatcher::matchesFileName(const QString &path) const
+{
+    if (m_filePatterns.isEmpty()) {
+        return true;
+    }
+    const QStringView name = QStringView(path).mid(path.lastIndexOf('/') + 1);
+    for (const QRegularExpression &filePattern : m_filePatterns) {
+        if (filePattern.matchView(name).hasMatch()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void MCPTextMatcher::searchLine(QStringView line, int lineNumber, const QString &path, Matches &matches) const
+{
+    auto addMatch = [&](qsizetype column, qsizetype length) {
+        Match match;
+        match.file = path;
+        match.line = lineNumber;
+        match.column = int(column);
+        match.length = int(length);
+        match.text = line.left(MaxLineLength).toString();
+        matches.append(match);
+    };
+
+    if (m_regexB) {
+        QRegularExpressionMatchIterator it = m_regex.globalMatchView(line);
+        while (it.hasNext()) {
+            const QRegularExpressionMatch match = it.next();
+            addMatch(match.capturedStart(), match.capturedLength());
+        }
+        return;
+    }
+
+    // An empty literal would match between every two characters forever
+    if (m_pattern.isEmpty()) {
+        return;
+    }
+    qsizetype from = 0;
+    qsizetype column;
+    while ((column = line.indexOf(m_pattern, from, m_sensitivity)) >= 0) {
+        addMatch(column, m_pattern.size());
+        from = column + m_pattern.size();
+    }
+}
+
+void MCPTextMatcher::searchText(QStringView text, const QString &path, Matches &matches) const
+{
+    int lineNumber = 1;
+    qsizetype start = 0;
+    while (start < text.size()) {
+        qsizetype end = text.indexOf('\n', start);
+        if (end < 0) {
+            end = text.size();
+        }
+        QStringView line = text.mid(start, end - start);
+        if (line.endsWith('\r')) {
+            line.chop(1);
+        }
+        searchLine(line, lineNumber, path, matches);
+        start = end + 1;
+        ++lineNumber;
+    }
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
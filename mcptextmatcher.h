@@ -0,0 +1,72 @@
+#ifndef MCPTEXTMATCHER_H
+#define MCPTEXTMATCHER_H
+
+#include <QList>
+#include <QRegularExpression>
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+/**
+ * @brief Finds the matches of a searchInFiles query in file contents
+ *
+ * Text is split into lines at '\n' with a trailing '\r' dropped, and every
+ * occurrence on a line is a match. Plain patterns are matched literally,
+ * regular expressions one line at a time. File patterns are wildcards on
+ * the file name and are always case insensitive.
+ *
+ * This class only depends on QtCore and is safe to use from several worker
+ * threads at once; MCPTextSearch runs it over the files of a search.
+ */
+class MCPTextMatcher
+{
+public:
+    struct Match
+    {
+        QString file;
+        int line = 0;     // 1-based
+        int column = 0;   // 0-based, in UTF-16 code units
+        int length = 0;
+        QString text;     // the line, cut at MaxLineLength
+    };
+
+    using Matches = QList<Match>;
+
+    MCPTextMatcher(const QString &pattern, bool regex, bool caseSensitive,
+                   const QStringList &filePatterns = QStringList());
+
+    /**
+     * @brief Checks the file name of path against the file patterns
+     * @return true if there are no file patterns
+     */
+    bool matchesFileName(const QString &path) const;
+
+    /**
+     * @brief Appends a match for every occurrence on one line
+     */
+    void searchLine(QStringView line, int lineNumber, const QString &path, Matches &matches) const;
+
+    /**
+     * @brief Appends the matches of every line of a file's text
+     *
+     * A trailing newline ends the last line; it does not start an empty one.
+     */
+    void searchText(QStringView text, const QString &path, Matches &matches) const;
+
+    static constexpr int MaxLineLength = 300;
+
+private:
+    QString m_pattern;
+    QRegularExpression m_regex;
+    QList<QRegularExpression> m_filePatterns;
+    Qt::CaseSensitivity m_sensitivity = Qt::CaseInsensitive;
+    bool m_regexB = false;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPTEXTMATCHER_H
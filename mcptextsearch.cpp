@@ -0,0 +1,266 @@
+#include "mcptextsearch.h"
+#include "mcpfileindex.h"
+#include "mcptextmatcher.h"
+
+#include <coreplugin/editormanager/documentmodel.h>
+#include <texteditor/textdocument.h>
+#include <utils/async.h>
+
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QPointer>
+#include <QRegularExpression>
+#include <QThread>
+
+#include <atomic>
+#include <memory>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+namespace {
+
+// One worker: takes the next file from the shared cursor until none are left
+void searchFiles(QPromise<MCPTextMatcher::Matches> &promise, const QStringList &files,
+                 const QHash<QString, QString> &buffers, const MCPTextMatcher &matcher,
+                 const std::shared_ptr<std::atomic_int> &cursor)
+{
+    for (;;) {
+        if (promise.isCanceled()) {
+            return;
+        }
+        const int index = cursor->fetch_add(1);
+        if (index >= files.size()) {
+            return;
+        }
+
+        const QString &path = files.at(index);
+        if (!matcher.matchesFileName(path)) {
+            continue;
+        }
+
+        QString text;
+        const auto buffer = buffers.constFind(path);
+        if (buffer != buffers.constEnd()) {
+            text = buffer.value();
+        } else {
+            QFile file(path);
+            if (file.size() > MCPTextSearch::MaxFileSize || !file.open(QIODevice::ReadOnly)) {
+                continue;
+            }
+            const QByteArray data = file.readAll();
+            if (data.left(8192).contains('\0')) {
+                continue;   // binary
+            }
+            text = QString::fromUtf8(data);
+        }
+
+        MCPTextMatcher::Matches matches;
+        matcher.searchText(text, path, matches);
+        if (!matches.isEmpty()) {
+            promise.addResult(matches);
+        }
+    }
+}
+
+} // namespace
+
+MCPTextSearch::MCPTextSearch(MCPFileIndex *fileIndex, QObject *parent)
+    : QObject(parent)
+    , m_fileIndex(fileIndex)
+{
+}
+
+MCPTextSearch::~MCPTextSearch()
+{
+    for (Search &search : m_searches) {
+        for (const std::function<void()> &stop : std::as_const(search.stops)) {
+            stop();
+        }
+    }
+}
+
+int MCPTextSearch::start(const Query &query, QString &errorMessage)
+{
+    if (query.pattern.isEmpty()) {
+        errorMessage = "pattern is required";
+        return -1;
+    }
+    if (query.regex && !QRegularExpression(query.pattern).isValid()) {
+        errorMessage = QString("Invalid regular expression: %1").arg(QRegularExpression(query.pattern).errorString());
+        return -1;
+    }
+    if (query.scope == "dir" && !QFileInfo(query.directory).isDir()) {
+        errorMessage = QString("Not a directory: %1").arg(query.directory);
+        return -1;
+    }
+    if (query.scope != "project" && query.scope != "openFiles" && query.scope != "dir") {
+        errorMessage = QString("Unknown scope '%1' (use project, openFiles or dir)").arg(query.scope);
+        return -1;
+    }
+
+    // Unsaved editor content wins over the file on disk
+    QHash<QString, QString> buffers;
+    QStringList openFiles;
+    for (Core::IDocument *document : Core::DocumentModel::openedDocuments()) {
+        auto textDocument = qobject_cast<TextEditor::TextDocument *>(document);
+        if (!textDocument) {
+            continue;
+        }
+        const QString path = textDocument->filePath().toFSPathString();
+        openFiles.append(path);
+        if (textDocument->isModified()) {
+            buffers.insert(path, textDocument->plainText());
+        }
+    }
+
+    const int searchId = m_nextId++;
+    Search &search = m_searches[searchId];
+    search.query = query;
+
+    if (query.scope != "dir") {
+        startWorkers(searchId, query.scope == "project" ? m_fileIndex->files(query.project) : openFiles, buffers);
+        return searchId;
+    }
+
+    // Walking a directory tree can take a while, so that runs on a worker too
+    QFuture<QStringList> listing = Utils::asyncRun([query](QPromise<QStringList> &promise) {
+        QStringList files;
+        QDirIterator it(query.directory, query.filePatterns, QDir::Files | QDir::NoDotAndDotDot,
+                        QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            if (promise.isCanceled()) {
+                return;
+            }
+            files.append(it.next());
+        }
+        promise.addResult(files);
+    });
+    auto watcher = new QFutureWatcher<QStringList>(this);
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, searchId, watcher, buffers] {
+        watcher->deleteLater();
+        if (!m_searches.contains(searchId)) {
+            return;
+        }
+        const QStringList files = watcher->future().resultCount() > 0 ? watcher->result() : QStringList();
+        startWorkers(searchId, files, buffers);
+    });
+    watcher->setFuture(listing);
+    search.stops.append([this, watcher = QPointer<QFutureWatcher<QStringList>>(watcher)] {
+        if (watcher) {
+            disconnect(watcher, nullptr, this, nullptr);
+            watcher->cancel();
+            watcher->deleteLater();
+        }
+    });
+    return searchId;
+}
+
+void MCPTextSearch::startWorkers(int searchId, const QStringList &files, const QHash<QString, QString> &buffers)
+{
+    Search &search = m_searches[searchId];
+    search.files = files.size();
+
+    const Query &query = search.query;
+    const MCPTextMatcher matcher(query.pattern, query.regex, query.caseSensitive, query.filePatterns);
+
+    const int workers = qMin(qMin(MaxWorkers, QThread::idealThreadCount()), int(files.size()));
+    if (workers <= 0) {
+        QMetaObject::invokeMethod(this, [this, searchId] { finish(searchId); }, Qt::QueuedConnection);
+        return;
+    }
+
+    auto cursor = std::make_shared<std::atomic_int>(0);
+    search.runningWorkers = workers;
+    for (int i = 0; i < workers; ++i) {
+        auto watcher = new QFutureWatcher<MCPTextMatcher::Matches>(this);
+        connect(watcher, &QFutureWatcherBase::resultReadyAt, this, [this, searchId, watcher](int index) {
+            QJsonArray batch;
+            for (const MCPTextMatcher::Match &match : watcher->resultAt(index)) {
+                QJsonObject entry;
+                entry["file"] = match.file;
+                entry["line"] = match.line;
+                entry["column"] = match.column;
+                entry["length"] = match.length;
+                entry["text"] = match.text;
+                batch.append(entry);
+            }
+            addMatches(searchId, batch);
+        });
+        connect(watcher, &QFutureWatcherBase::finished, this, [this, searchId] {
+            auto it = m_searches.find(searchId);
+            if (it != m_searches.end() && --it->runningWorkers == 0) {
+                finish(searchId);
+            }
+        });
+        watcher->setFuture(Utils::asyncRun(&searchFiles, files, buffers, matcher, cursor));
+        search.stops.append([this, watcher = QPointer<QFutureWatcher<MCPTextMatcher::Matches>>(watcher)] {
+            if (watcher) {
+                disconnect(watcher, nullptr, this, nullptr);
+                watcher->cancel();
+                watcher->deleteLater();
+            }
+        });
+    }
+}
+
+void MCPTextSearch::addMatches(int searchId, const QJsonArray &batch)
+{
+    auto it = m_searches.find(searchId);
+    if (it == m_searches.end() || batch.isEmpty()) {
+        return;
+    }
+
+    QJsonArray accepted;
+    for (const QJsonValue &match : batch) {
+        if (it->count >= it->query.limit) {
+            it->truncated = true;
+            break;
+        }
+        ++it->count;
+        accepted.append(match);
+    }
+    if (!accepted.isEmpty()) {
+        emit results(searchId, accepted);
+    }
+
+    // A match beyond the limit: stop the workers instead of reading the rest
+    if (it->truncated) {
+        finish(searchId);
+    }
+}
+
+void MCPTextSearch::cancel(int searchId)
+{
+    auto it = m_searches.find(searchId);
+    if (it == m_searches.end()) {
+        return;
+    }
+    it->cancelled = true;
+    finish(searchId);
+}
+
+void MCPTextSearch::finish(int searchId)
+{
+    auto it = m_searches.find(searchId);
+    if (it == m_searches.end()) {
+        return;
+    }
+
+    Search search = *it;
+    m_searches.erase(it);
+    for (const std::function<void()> &stop : std::as_const(search.stops)) {
+        stop();
+    }
+
+    QJsonObject report;
+    report["count"] = search.count;
+    report["files"] = search.files;
+    report["truncated"] = search.truncated;
+    emit finished(searchId, !search.cancelled, report);
+}
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
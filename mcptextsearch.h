@@ -0,0 +1,91 @@
+#ifndef MCPTEXTSEARCH_H
+#define MCPTEXTSEARCH_H
+
+#include <QObject>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QList>
+#include <QStringList>
+
+#include <functional>
+
+namespace Qt_MCP_Plugin {
+namespace Internal {
+
+class MCPFileIndex;
+
+/**
+ * @brief Text search over project files on worker threads
+ *
+ * The file set comes from the project file index, the open documents or a
+ * directory tree (walked on a worker thread). Files are handed out to one
+ * worker per core from a shared cursor. Open documents with unsaved
+ * changes are searched as they are in the editor. Matches are reported in
+ * batches through results() as files complete, and finished() only reports
+ * the totals. A search stops by itself once a match beyond `limit` shows up.
+ * The matching itself is done by MCPTextMatcher.
+ */
+class MCPTextSearch : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Query
+    {
+        QString pattern;
+        bool regex = false;
+        bool caseSensitive = false;
+        QString scope;          // "project", "openFiles" or "dir"
+        QString project;        // project scope: display name, empty for all
+        QString directory;      // dir scope
+        QStringList filePatterns;
+        int limit = 1000;
+    };
+
+    explicit MCPTextSearch(MCPFileIndex *fileIndex, QObject *parent = nullptr);
+    ~MCPTextSearch() override;
+
+    /**
+     * @brief Starts a search
+     * @return A search id, or -1 with errorMessage set
+     */
+    int start(const Query &query, QString &errorMessage);
+
+    /**
+     * @brief Stops a search; finished() follows with cancelled set
+     */
+    void cancel(int searchId);
+
+    static constexpr int MaxWorkers = 8;
+    static constexpr qint64 MaxFileSize = 8 * 1024 * 1024;
+
+signals:
+    void results(int searchId, const QJsonArray &batch);
+    void finished(int searchId, bool success, const QJsonObject &report);
+
+private:
+    struct Search
+    {
+        Query query;
+        int count = 0;   // matches streamed through results()
+        int files = 0;
+        int runningWorkers = 0;
+        bool cancelled = false;
+        bool truncated = false;
+        QList<std::function<void()>> stops;
+    };
+
+    void startWorkers(int searchId, const QStringList &files, const QHash<QString, QString> &buffers);
+    void addMatches(int searchId, const QJsonArray &batch);
+    void finish(int searchId);
+
+    MCPFileIndex *m_fileIndex;
+    QHash<int, Search> m_searches;
+    int m_nextId = 1;
+};
+
+} // namespace Internal
+} // namespace Qt_MCP_Plugin
+
+#endif // MCPTEXTSEARCH_H
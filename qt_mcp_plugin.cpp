@@ -2,6 +2,7 @@
 #include "qt_mcp_plugintr.h"
 #include "mcpserver.h"
 #include "mcpcommands.h"
+#include "mcpactions.h"
 #include "version.h"
 
 #include <coreplugin/actionmanager/actioncontainer.h>
@@ -167,6 +168,10 @@ public:
 
 	void initialize() final
 	{
+		// The action index is filled in extensionsInitialized(), once all
+		// plugins have registered their actions
+		m_actionIndexP = new MCPActionIndex(this);
+
 		// Create the MCP server and commands
 		m_serverP = new MCPServer(this);
 		m_commandsP = new MCPCommands(this);
@@ -302,6 +307,7 @@ public:
 		// In the extensionsInitialized function, a plugin can be sure that all
 		// plugins that depend on it have passed their initialize() and
 		// extensionsInitialized() phase.
+		m_actionIndexP->rebuild();
 	}
 
 	ShutdownFlag aboutToShutdown() final
@@ -457,6 +463,7 @@ private:
 
 	MCPServer *m_serverP = nullptr;
 	MCPCommands *m_commandsP = nullptr;
+	MCPActionIndex *m_actionIndexP = nullptr;
 };
 
 } // namespace Qt_MCP_Plugin::Internal
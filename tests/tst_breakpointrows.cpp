@@ -0,0 +1,203 @@
+#include "mcpbreakpointrows.h"
+
+#include <QTest>
+
+using namespace Qt_MCP_Plugin::Internal;
+
+namespace {
+
+// The columns of the debugger's breakpoint model, filled from a list
+class BreakpointModel : public QAbstractTableModel
+{
+public:
+    struct Breakpoint
+    {
+        QString function;
+        QString file;
+        int line = 0;
+        QString condition;
+        int ignoreCount = 0;
+        bool enabled = true;
+    };
+
+    explicit BreakpointModel(const QList<Breakpoint> &breakpoints)
+        : m_breakpoints(breakpoints)
+    {}
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : int(m_breakpoints.size());
+    }
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : MCPBreakpointRows::ColumnCount;
+    }
+
+    QVariant data(const QModelIndex &index, int role) const override
+    {
+        const Breakpoint &breakpoint = m_breakpoints.at(index.row());
+        if (role == Qt::CheckStateRole && index.column() == 0) {
+            return int(breakpoint.enabled ? Qt::Checked : Qt::Unchecked);
+        }
+        if (role != Qt::DisplayRole) {
+            return QVariant();
+        }
+        switch (index.column()) {
+        case MCPBreakpointRows::NumberColumn:
+            return index.row() + 1;
+        case MCPBreakpointRows::FunctionColumn:
+            return breakpoint.function;
+        case MCPBreakpointRows::FileColumn:
+            return breakpoint.file;
+        case MCPBreakpointRows::LineColumn:
+            return breakpoint.line > 0 ? QVariant(breakpoint.line) : QVariant(QString());
+        case MCPBreakpointRows::ConditionColumn:
+            return breakpoint.condition;
+        case MCPBreakpointRows::IgnoreCountColumn:
+            return breakpoint.ignoreCount > 0 ? QVariant(breakpoint.ignoreCount) : QVariant(QString());
+        default:
+            return QVariant();
+        }
+    }
+
+private:
+    QList<Breakpoint> m_breakpoints;
+};
+
+BreakpointModel::Breakpoint at(const QString &file, int line, const QString &condition = QString(),
+                               int ignoreCount = 0)
+{
+    BreakpointModel::Breakpoint breakpoint;
+    breakpoint.file = file;
+    breakpoint.line = line;
+    breakpoint.condition = condition;
+    breakpoint.ignoreCount = ignoreCount;
+    return breakpoint;
+}
+
+} // namespace
+
+class tst_BreakpointRows : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void matches_data();
+    void matches();
+    void findRowAmongSeveral();
+    void filterRows_data();
+    void filterRows();
+    void breakpointEntry();
+    void hasParameters();
+
+private:
+    static QList<BreakpointModel::Breakpoint> breakpoints();
+};
+
+QList<BreakpointModel::Breakpoint> tst_BreakpointRows::breakpoints()
+{
+    BreakpointModel::Breakpoint onFunction;
+    onFunction.function = "main";
+
+    return {at("/src/app/main.cpp", 10),
+            at("/src/app/main.cpp", 20, "i > 3"),
+            at("/src/lib/util.cpp", 10, QString(), 4),
+            onFunction,
+            at("app/main.cpp", 30)};
+}
+
+void tst_BreakpointRows::matches_data()
+{
+    QTest::addColumn<QString>("cell");
+    QTest::addColumn<QString>("file");
+    QTest::addColumn<bool>("result");
+
+    QTest::newRow("same") << "/src/main.cpp" << "/src/main.cpp" << true;
+    QTest::newRow("shortenedCell") << "app/main.cpp" << "/src/app/main.cpp" << true;
+    QTest::newRow("shortenedFilter") << "/src/app/main.cpp" << "main.cpp" << true;
+    QTest::newRow("partOfName") << "/src/app/mymain.cpp" << "main.cpp" << false;
+    QTest::newRow("otherFile") << "/src/app/main.cpp" << "/src/lib/main.cpp" << false;
+    QTest::newRow("emptyCell") << "" << "main.cpp" << false;
+}
+
+void tst_BreakpointRows::matches()
+{
+    QFETCH(QString, cell);
+    QFETCH(QString, file);
+    QFETCH(bool, result);
+
+    QCOMPARE(MCPBreakpointRows::matches(cell, file), result);
+}
+
+void tst_BreakpointRows::findRowAmongSeveral()
+{
+    const BreakpointModel model(breakpoints());
+
+    QCOMPARE(MCPBreakpointRows::findRow(&model, QModelIndex(), "/src/app/main.cpp", 10), 0);
+    QCOMPARE(MCPBreakpointRows::findRow(&model, QModelIndex(), "/src/app/main.cpp", 20), 1);
+    QCOMPARE(MCPBreakpointRows::findRow(&model, QModelIndex(), "/src/lib/util.cpp", 10), 2);
+    QCOMPARE(MCPBreakpointRows::findRow(&model, QModelIndex(), "/src/app/main.cpp", 30), 4);
+    QCOMPARE(MCPBreakpointRows::findRow(&model, QModelIndex(), "/src/app/main.cpp", 11), -1);
+    QCOMPARE(MCPBreakpointRows::findRow(&model, QModelIndex(), "/src/lib/other.cpp", 10), -1);
+}
+
+void tst_BreakpointRows::filterRows_data()
+{
+    QTest::addColumn<QString>("file");
+    QTest::addColumn<int>("line");
+    QTest::addColumn<QList<int>>("rows");
+
+    QTest::newRow("all") << QString() << -1 << QList<int>{0, 1, 2, 3, 4};
+    QTest::newRow("file") << "/src/app/main.cpp" << -1 << QList<int>{0, 1, 4};
+    QTest::newRow("line") << QString() << 10 << QList<int>{0, 2};
+    QTest::newRow("fileAndLine") << "main.cpp" << 20 << QList<int>{1};
+    QTest::newRow("none") << "/src/other.cpp" << -1 << QList<int>{};
+}
+
+void tst_BreakpointRows::filterRows()
+{
+    QFETCH(QString, file);
+    QFETCH(int, line);
+    QFETCH(QList<int>, rows);
+
+    const BreakpointModel model(breakpoints());
+    QCOMPARE(MCPBreakpointRows::filterRows(&model, QModelIndex(), file, line), rows);
+}
+
+void tst_BreakpointRows::breakpointEntry()
+{
+    QList<BreakpointModel::Breakpoint> list = breakpoints();
+    list[2].enabled = false;
+    const BreakpointModel model(list);
+
+    QJsonObject entry = MCPBreakpointRows::breakpoint(&model, QModelIndex(), 1);
+    QCOMPARE(entry.value("file").toString(), QString("/src/app/main.cpp"));
+    QCOMPARE(entry.value("line").toInt(), 20);
+    QCOMPARE(entry.value("condition").toString(), QString("i > 3"));
+    QVERIFY(!entry.contains("ignoreCount"));
+    QVERIFY(entry.value("enabled").toBool());
+
+    entry = MCPBreakpointRows::breakpoint(&model, QModelIndex(), 2);
+    QVERIFY(!entry.contains("condition"));
+    QCOMPARE(entry.value("ignoreCount").toInt(), 4);
+    QVERIFY(!entry.value("enabled").toBool());
+}
+
+void tst_BreakpointRows::hasParameters()
+{
+    const BreakpointModel model(breakpoints());
+
+    // Only the row the request was for counts, not the first one
+    QVERIFY(MCPBreakpointRows::hasParameters(&model, QModelIndex(), 1, QString("i > 3"), -1));
+    QVERIFY(!MCPBreakpointRows::hasParameters(&model, QModelIndex(), 0, QString("i > 3"), -1));
+    QVERIFY(MCPBreakpointRows::hasParameters(&model, QModelIndex(), 2, std::nullopt, 4));
+    QVERIFY(!MCPBreakpointRows::hasParameters(&model, QModelIndex(), 2, std::nullopt, 3));
+    QVERIFY(MCPBreakpointRows::hasParameters(&model, QModelIndex(), 2, QString(), 4));
+    QVERIFY(MCPBreakpointRows::hasParameters(&model, QModelIndex(), 0, QString(), 0));
+    QVERIFY(!MCPBreakpointRows::hasParameters(&model, QModelIndex(), 5, std::nullopt, -1));
+}
+
+QTEST_GUILESS_MAIN(tst_BreakpointRows)
+
+#include "tst_breakpointrows.moc"
@@ -0,0 +1,377 @@
+#include "mcpbuildlog.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QTemporaryDir>
+#include <QTest>
+
+using namespace Qt_MCP_Plugin::Internal;
+
+class tst_BuildLog : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    void appendAndQuery();
+    void reopenIndexesLog();
+    void unopenedLogKeepsIds();
+    void damagedRecordsAreSkipped();
+    void oversizedLogIsMovedAside();
+
+    void compareAgainstBaselineMedian();
+    void baselineSkipsOtherBuilds();
+    void thresholds_data();
+    void thresholds();
+    void explicitHeadAndBase();
+    void stepWithoutBaseline();
+    void nothingToCompare();
+
+private:
+    struct Step
+    {
+        QString key;
+        qint64 durationMs;
+    };
+
+    static QJsonObject record(qint64 id, const QList<Step> &steps, const QString &project = "app",
+                              const QString &buildConfig = "Debug", const QString &kind = "build",
+                              bool success = true);
+    static QList<qint64> ids(const QJsonArray &records);
+    static QJsonObject step(const QJsonObject &comparison, const QString &key);
+    QString logPath() const;
+
+    QScopedPointer<QTemporaryDir> m_dir;
+};
+
+void tst_BuildLog::init()
+{
+    m_dir.reset(new QTemporaryDir);
+    QVERIFY(m_dir->isValid());
+}
+
+QString tst_BuildLog::logPath() const
+{
+    return m_dir->filePath("qt_mcp_plugin/buildhistory.jsonl");
+}
+
+QJsonObject tst_BuildLog::record(qint64 id, const QList<Step> &steps, const QString &project,
+                                 const QString &buildConfig, const QString &kind, bool success)
+{
+    QJsonArray stepArray;
+    qint64 totalMs = 0;
+    for (const Step &step : steps) {
+        QJsonObject entry;
+        entry["key"] = step.key;
+        entry["name"] = step.key.section(':', 1).section('#', 0, 0);
+        entry["durationMs"] = step.durationMs;
+        stepArray.append(entry);
+        totalMs += qMax(step.durationMs, qint64(0));
+    }
+
+    QJsonObject result;
+    result["id"] = id;
+    result["project"] = project;
+    result["buildConfig"] = buildConfig;
+    result["kind"] = kind;
+    result["success"] = success;
+    result["durationMs"] = totalMs;
+    result["steps"] = stepArray;
+    return result;
+}
+
+QList<qint64> tst_BuildLog::ids(const QJsonArray &records)
+{
+    QList<qint64> result;
+    for (const QJsonValue &value : records) {
+        result.append(value.toObject().value("id").toInteger());
+    }
+    return result;
+}
+
+QJsonObject tst_BuildLog::step(const QJsonObject &comparison, const QString &key)
+{
+    for (const QJsonValue &value : comparison.value("steps").toArray()) {
+        if (value.toObject().value("key").toString() == key) {
+            return value.toObject();
+        }
+    }
+    return QJsonObject();
+}
+
+void tst_BuildLog::appendAndQuery()
+{
+    MCPBuildLog log;
+    QVERIFY(log.open(logPath()));
+    QCOMPARE(log.recordCount(), 0);
+    QCOMPARE(log.nextId(), qint64(1));
+
+    log.append(record(log.nextId(), {{"build:make#0", 100}}));
+    log.append(record(log.nextId(), {{"build:make#0", 200}}, "lib"));
+    log.append(record(log.nextId(), {{"build:make#0", 300}}, "app", "Release"));
+    QCOMPARE(log.recordCount(), 3);
+    QCOMPARE(log.nextId(), qint64(4));
+
+    QCOMPARE(ids(log.history("", "", 10)), (QList<qint64>{3, 2, 1}));
+    QCOMPARE(ids(log.history("", "", 2)), (QList<qint64>{3, 2}));
+    QCOMPARE(ids(log.history("app", "", 10)), (QList<qint64>{3, 1}));
+    QCOMPARE(ids(log.history("app", "Debug", 10)), QList<qint64>{1});
+    QCOMPARE(ids(log.history("", "Debug", 10)), (QList<qint64>{2, 1}));
+    QVERIFY(log.history("other", "", 10).isEmpty());
+    QVERIFY(log.history("", "", 0).isEmpty());
+
+    // Records come back as they were written
+    QCOMPARE(log.history("lib", "", 1).at(0).toObject(), record(2, {{"build:make#0", 200}}, "lib"));
+}
+
+void tst_BuildLog::reopenIndexesLog()
+{
+    {
+        MCPBuildLog log;
+        QVERIFY(log.open(logPath()));
+        log.append(record(1, {{"build:make#0", 100}}));
+        log.append(record(2, {{"build:make#0", 200}}, "lib"));
+    }
+
+    MCPBuildLog log;
+    QVERIFY(log.open(logPath()));
+    QCOMPARE(log.recordCount(), 2);
+    QCOMPARE(log.nextId(), qint64(3));
+    QCOMPARE(ids(log.history("", "", 10)), (QList<qint64>{2, 1}));
+    QCOMPARE(ids(log.history("lib", "", 10)), QList<qint64>{2});
+
+    log.append(record(log.nextId(), {{"build:make#0", 300}}));
+    QCOMPARE(ids(log.history("", "", 10)), (QList<qint64>{3, 2, 1}));
+}
+
+void tst_BuildLog::unopenedLogKeepsIds()
+{
+    MCPBuildLog log;
+    QVERIFY(!log.isOpen());
+    log.append(record(log.nextId(), {}));
+    log.append(record(log.nextId(), {}));
+    QCOMPARE(log.nextId(), qint64(3));
+    QCOMPARE(log.recordCount(), 0);
+    QVERIFY(log.history("", "", 10).isEmpty());
+}
+
+void tst_BuildLog::damagedRecordsAreSkipped()
+{
+    {
+        MCPBuildLog log;
+        QVERIFY(log.open(logPath()));
+    }
+
+    QFile file(logPath());
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(QJsonDocument(record(1, {})).toJson(QJsonDocument::Compact) + "\n");
+    file.write("not json\n\n");
+    file.write(QJsonDocument(record(5, {}, "lib")).toJson(QJsonDocument::Compact) + "\n");
+    file.write(R"({"id":9,"project":"app","kind")");   // cut short by a crash
+    file.close();
+
+    MCPBuildLog log;
+    QVERIFY(log.open(logPath()));
+    QCOMPARE(log.recordCount(), 2);
+    QCOMPARE(log.nextId(), qint64(6));
+    QCOMPARE(ids(log.history("", "", 10)), (QList<qint64>{5, 1}));
+
+    // The next record starts on a line of its own
+    log.append(record(log.nextId(), {}));
+    QCOMPARE(ids(log.history("", "", 10)), (QList<qint64>{6, 5, 1}));
+
+    MCPBuildLog reopened;
+    QVERIFY(reopened.open(logPath()));
+    QCOMPARE(ids(reopened.history("", "", 10)), (QList<qint64>{6, 5, 1}));
+}
+
+void tst_BuildLog::oversizedLogIsMovedAside()
+{
+    {
+        MCPBuildLog log;
+        QVERIFY(log.open(logPath()));
+        log.append(record(1, {}));
+    }
+
+    QFile file(logPath());
+    QVERIFY(file.open(QIODevice::Append));
+    file.write(QByteArray(MCPBuildLog::MaxLogSize, ' ') + "\n");
+    file.close();
+
+    MCPBuildLog log;
+    QVERIFY(log.open(logPath()));
+    QCOMPARE(log.recordCount(), 0);
+    QCOMPARE(QFileInfo(logPath()).size(), qint64(0));
+    QVERIFY(QFileInfo(logPath() + ".1").size() > MCPBuildLog::MaxLogSize);
+}
+
+void tst_BuildLog::compareAgainstBaselineMedian()
+{
+    MCPBuildLog log;
+    QVERIFY(log.open(logPath()));
+    log.append(record(1, {{"build:cmake#0", 1000}, {"build:make#0", 5000}}));
+    log.append(record(2, {{"build:cmake#0", 1100}, {"build:make#0", 5200}}));
+    log.append(record(3, {{"build:cmake#0", 1200}, {"build:make#0", 5100}}));
+    log.append(record(4, {{"build:cmake#0", 1150}, {"build:make#0", 8000}}));
+
+    QString errorMessage;
+    const QJsonObject result = log.compare(QJsonObject(), errorMessage);
+    QVERIFY(errorMessage.isEmpty());
+
+    QCOMPARE(result.value("head").toInteger(), qint64(4));
+    QCOMPARE(result.value("baseline").toArray(), (QJsonArray{3, 2, 1}));
+    QCOMPARE(result.value("project").toString(), QString("app"));
+    QCOMPARE(result.value("kind").toString(), QString("build"));
+
+    const QJsonObject cmake = step(result, "build:cmake#0");
+    QCOMPARE(cmake.value("baseMs").toInteger(), qint64(1100));
+    QCOMPARE(cmake.value("headMs").toInteger(), qint64(1150));
+    QCOMPARE(cmake.value("regression").toBool(), false);
+
+    // Median 5100, 2900 ms and 56.9 % slower
+    const QJsonObject make = step(result, "build:make#0");
+    QCOMPARE(make.value("baseMs").toInteger(), qint64(5100));
+    QCOMPARE(make.value("deltaMs").toInteger(), qint64(2900));
+    QCOMPARE(make.value("deltaPercent").toDouble(), 56.9);
+    QCOMPARE(make.value("regression").toBool(), true);
+
+    const QJsonObject total = result.value("total").toObject();
+    QCOMPARE(total.value("baseMs").toInteger(), qint64(6300));
+    QCOMPARE(total.value("headMs").toInteger(), qint64(9150));
+    QCOMPARE(total.value("regression").toBool(), true);
+
+    QCOMPARE(result.value("regressions").toArray(), QJsonArray{"make"});
+    QCOMPARE(result.value("regressed").toBool(), true);
+}
+
+void tst_BuildLog::baselineSkipsOtherBuilds()
+{
+    MCPBuildLog log;
+    QVERIFY(log.open(logPath()));
+    log.append(record(1, {{"build:make#0", 1000}}));
+    log.append(record(2, {{"build:make#0", 9000}}, "app", "Debug", "build", false));
+    log.append(record(3, {{"build:make#0", 9000}}, "app", "Debug", "rebuild"));
+    log.append(record(4, {{"build:make#0", 9000}}, "app", "Release"));
+    log.append(record(5, {{"build:make#0", 9000}}, "lib"));
+    log.append(record(6, {{"build:make#0", 1000}}));
+
+    QString errorMessage;
+    QJsonObject result = log.compare(QJsonObject{{"project", "app"}, {"buildConfig", "Debug"}},
+                                     errorMessage);
+    QCOMPARE(result.value("head").toInteger(), qint64(6));
+    QCOMPARE(result.value("baseline").toArray(), (QJsonArray{1}));
+    QCOMPARE(result.value("regressed").toBool(), false);
+
+    // At most BaselineBuilds earlier builds count
+    for (int i = 0; i < MCPBuildLog::BaselineBuilds + 2; ++i) {
+        log.append(record(log.nextId(), {{"build:make#0", 1000}}));
+    }
+    result = log.compare(QJsonObject{{"project", "app"}}, errorMessage);
+    QCOMPARE(result.value("baseline").toArray().size(), qsizetype(MCPBuildLog::BaselineBuilds));
+}
+
+void tst_BuildLog::thresholds_data()
+{
+    QTest::addColumn<QJsonObject>("params");
+    QTest::addColumn<qint64>("headMs");
+    QTest::addColumn<bool>("regression");
+
+    // The baseline step takes 10000 ms; defaults are 10 % and 500 ms
+    QTest::newRow("faster") << QJsonObject() << qint64(9000) << false;
+    QTest::newRow("just below percent") << QJsonObject() << qint64(10999) << false;
+    QTest::newRow("at percent") << QJsonObject() << qint64(11000) << true;
+    QTest::newRow("percent but small")
+        << QJsonObject{{"thresholdPercent", 1.0}} << qint64(10400) << false;
+    QTest::newRow("percent and delta")
+        << QJsonObject{{"thresholdPercent", 1.0}, {"minDeltaMs", 100}} << qint64(10400) << true;
+    QTest::newRow("delta but not percent")
+        << QJsonObject{{"thresholdPercent", 50.0}} << qint64(14000) << false;
+}
+
+void tst_BuildLog::thresholds()
+{
+    QFETCH(QJsonObject, params);
+    QFETCH(qint64, headMs);
+    QFETCH(bool, regression);
+
+    MCPBuildLog log;
+    QVERIFY(log.open(logPath()));
+    log.append(record(1, {{"build:make#0", 10000}}));
+    log.append(record(2, {{"build:make#0", headMs}}));
+
+    QString errorMessage;
+    const QJsonObject result = log.compare(params, errorMessage);
+    QVERIFY(errorMessage.isEmpty());
+    QCOMPARE(step(result, "build:make#0").value("regression").toBool(), regression);
+    QCOMPARE(result.value("total").toObject().value("regression").toBool(), regression);
+    QCOMPARE(result.value("regressed").toBool(), regression);
+}
+
+void tst_BuildLog::explicitHeadAndBase()
+{
+    MCPBuildLog log;
+    QVERIFY(log.open(logPath()));
+    log.append(record(1, {{"build:make#0", 1000}}));
+    log.append(record(2, {{"build:make#0", 5000}}, "app", "Debug", "build", false));
+    log.append(record(3, {{"build:make#0", 1000}}));
+
+    // A failed build can be named explicitly on either side
+    QString errorMessage;
+    QJsonObject result = log.compare(QJsonObject{{"head", 2}}, errorMessage);
+    QCOMPARE(result.value("head").toInteger(), qint64(2));
+    QCOMPARE(result.value("baseline").toArray(), (QJsonArray{1}));
+    QCOMPARE(result.value("regressed").toBool(), true);
+
+    result = log.compare(QJsonObject{{"head", 3}, {"base", 2}}, errorMessage);
+    QCOMPARE(result.value("baseline").toArray(), (QJsonArray{2}));
+    QCOMPARE(step(result, "build:make#0").value("deltaMs").toInteger(), qint64(-4000));
+    QCOMPARE(result.value("regressed").toBool(), false);
+}
+
+void tst_BuildLog::stepWithoutBaseline()
+{
+    MCPBuildLog log;
+    QVERIFY(log.open(logPath()));
+    log.append(record(1, {{"build:make#0", 1000}}));
+    log.append(record(2, {{"build:make#0", 1000}, {"build:deploy#0", 60000}, {"build:make#1", -1}}));
+
+    QString errorMessage;
+    const QJsonObject result = log.compare(QJsonObject(), errorMessage);
+    const QJsonObject deploy = step(result, "build:deploy#0");
+    QCOMPARE(deploy.value("headMs").toInteger(), qint64(60000));
+    QVERIFY(!deploy.contains("baseMs"));
+    QCOMPARE(deploy.value("regression").toBool(), false);
+
+    // A step that never reported a duration is not compared
+    QCOMPARE(step(result, "build:make#1").value("regression").toBool(), false);
+    QVERIFY(!step(result, "build:make#1").contains("baseMs"));
+}
+
+void tst_BuildLog::nothingToCompare()
+{
+    MCPBuildLog log;
+    QVERIFY(log.open(logPath()));
+
+    QString errorMessage;
+    QVERIFY(log.compare(QJsonObject(), errorMessage).isEmpty());
+    QCOMPARE(errorMessage, QString("No build found to compare"));
+
+    log.append(record(1, {{"build:make#0", 1000}}));
+    errorMessage.clear();
+    QVERIFY(log.compare(QJsonObject(), errorMessage).isEmpty());
+    QCOMPARE(errorMessage, QString("No earlier build to compare with"));
+
+    errorMessage.clear();
+    QVERIFY(log.compare(QJsonObject{{"head", 7}}, errorMessage).isEmpty());
+    QCOMPARE(errorMessage, QString("No build found to compare"));
+
+    errorMessage.clear();
+    QVERIFY(log.compare(QJsonObject{{"project", "lib"}}, errorMessage).isEmpty());
+    QCOMPARE(errorMessage, QString("No build found to compare"));
+}
+
+QTEST_GUILESS_MAIN(tst_BuildLog)
+
+#include "tst_buildlog.moc"
@@ -0,0 +1,182 @@
+#include "mcpdiagnostics.h"
+
+#include <QTest>
+
+using namespace Qt_MCP_Plugin::Internal;
+
+class tst_DiagnosticsDiff : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void unchanged();
+    void orderDoesNotMatter();
+    void addedAndRemoved();
+    void fixedMessageOnSameLine();
+    void repeatedDiagnostics();
+    void sameLineDifferentColumns();
+    void missingColumn();
+    void keyFields_data();
+    void keyFields();
+    void otherFieldsAreIgnored();
+
+private:
+    static QJsonObject diagnostic(int line, int column, const QString &message,
+                                  const QString &severity = "error", const QString &source = "clangd");
+};
+
+QJsonObject tst_DiagnosticsDiff::diagnostic(int line, int column, const QString &message,
+                                            const QString &severity, const QString &source)
+{
+    QJsonObject result;
+    result["line"] = line;
+    if (column >= 0) {
+        result["column"] = column;
+    }
+    result["severity"] = severity;
+    result["message"] = message;
+    result["source"] = source;
+    return result;
+}
+
+void tst_DiagnosticsDiff::unchanged()
+{
+    const QJsonArray diagnostics{diagnostic(3, 5, "unused variable 'x'", "warning"),
+                                 diagnostic(10, 1, "expected ';'")};
+    QJsonArray added;
+    QJsonArray removed;
+    MCPDiagnostics::diff(diagnostics, diagnostics, added, removed);
+    QVERIFY(added.isEmpty());
+    QVERIFY(removed.isEmpty());
+
+    MCPDiagnostics::diff(QJsonArray(), QJsonArray(), added, removed);
+    QVERIFY(added.isEmpty());
+    QVERIFY(removed.isEmpty());
+}
+
+void tst_DiagnosticsDiff::orderDoesNotMatter()
+{
+    QJsonArray added;
+    QJsonArray removed;
+    MCPDiagnostics::diff(QJsonArray{diagnostic(1, 1, "a"), diagnostic(2, 1, "b")},
+                         QJsonArray{diagnostic(2, 1, "b"), diagnostic(1, 1, "a")}, added, removed);
+    QVERIFY(added.isEmpty());
+    QVERIFY(removed.isEmpty());
+}
+
+void tst_DiagnosticsDiff::addedAndRemoved()
+{
+    QJsonArray added;
+    QJsonArray removed;
+    MCPDiagnostics::diff(QJsonArray{diagnostic(1, 1, "a"), diagnostic(2, 1, "b")},
+                         QJsonArray{diagnostic(2, 1, "b"), diagnostic(3, 1, "c")}, added, removed);
+    QCOMPARE(added, QJsonArray{diagnostic(3, 1, "c")});
+    QCOMPARE(removed, QJsonArray{diagnostic(1, 1, "a")});
+
+    added = QJsonArray();
+    removed = QJsonArray();
+    MCPDiagnostics::diff(QJsonArray(), QJsonArray{diagnostic(1, 1, "a")}, added, removed);
+    QCOMPARE(added, QJsonArray{diagnostic(1, 1, "a")});
+    QVERIFY(removed.isEmpty());
+
+    added = QJsonArray();
+    MCPDiagnostics::diff(QJsonArray{diagnostic(1, 1, "a")}, QJsonArray(), added, removed);
+    QVERIFY(added.isEmpty());
+    QCOMPARE(removed, QJsonArray{diagnostic(1, 1, "a")});
+}
+
+void tst_DiagnosticsDiff::fixedMessageOnSameLine()
+{
+    // A diagnostic whose text changed is one removal and one addition
+    QJsonArray added;
+    QJsonArray removed;
+    MCPDiagnostics::diff(QJsonArray{diagnostic(7, 3, "use of undeclared identifier 'fo'")},
+                         QJsonArray{diagnostic(7, 3, "use of undeclared identifier 'foo'")}, added, removed);
+    QCOMPARE(added, QJsonArray{diagnostic(7, 3, "use of undeclared identifier 'foo'")});
+    QCOMPARE(removed, QJsonArray{diagnostic(7, 3, "use of undeclared identifier 'fo'")});
+}
+
+void tst_DiagnosticsDiff::repeatedDiagnostics()
+{
+    // Equal diagnostics are matched one to one, so a repeat is a change
+    const QJsonObject once = diagnostic(4, -1, "macro redefined", "warning");
+
+    QJsonArray added;
+    QJsonArray removed;
+    MCPDiagnostics::diff(QJsonArray{once}, QJsonArray{once, once}, added, removed);
+    QCOMPARE(added, QJsonArray{once});
+    QVERIFY(removed.isEmpty());
+
+    added = QJsonArray();
+    MCPDiagnostics::diff(QJsonArray{once, once, once}, QJsonArray{once}, added, removed);
+    QVERIFY(added.isEmpty());
+    QCOMPARE(removed, (QJsonArray{once, once}));
+
+    removed = QJsonArray();
+    MCPDiagnostics::diff(QJsonArray{once, once}, QJsonArray{once, once}, added, removed);
+    QVERIFY(added.isEmpty());
+    QVERIFY(removed.isEmpty());
+}
+
+void tst_DiagnosticsDiff::sameLineDifferentColumns()
+{
+    QJsonArray added;
+    QJsonArray removed;
+    MCPDiagnostics::diff(QJsonArray{diagnostic(9, 5, "expected ')'")},
+                         QJsonArray{diagnostic(9, 5, "expected ')'"), diagnostic(9, 17, "expected ')'")},
+                         added, removed);
+    QCOMPARE(added, QJsonArray{diagnostic(9, 17, "expected ')'")});
+    QVERIFY(removed.isEmpty());
+}
+
+void tst_DiagnosticsDiff::missingColumn()
+{
+    // Text marks have no column; that is not the same as column 0 or 1
+    QJsonArray added;
+    QJsonArray removed;
+    MCPDiagnostics::diff(QJsonArray{diagnostic(2, -1, "a")}, QJsonArray{diagnostic(2, -1, "a")}, added, removed);
+    QVERIFY(added.isEmpty());
+    QVERIFY(removed.isEmpty());
+
+    MCPDiagnostics::diff(QJsonArray{diagnostic(2, -1, "a")}, QJsonArray{diagnostic(2, 0, "a")}, added, removed);
+    QCOMPARE(added, QJsonArray{diagnostic(2, 0, "a")});
+    QCOMPARE(removed, QJsonArray{diagnostic(2, -1, "a")});
+}
+
+void tst_DiagnosticsDiff::keyFields_data()
+{
+    QTest::addColumn<QJsonObject>("changed");
+
+    QTest::newRow("line") << diagnostic(2, 1, "a");
+    QTest::newRow("column") << diagnostic(1, 2, "a");
+    QTest::newRow("message") << diagnostic(1, 1, "b");
+    QTest::newRow("severity") << diagnostic(1, 1, "a", "warning");
+    QTest::newRow("source") << diagnostic(1, 1, "a", "error", "C++ code model");
+}
+
+void tst_DiagnosticsDiff::keyFields()
+{
+    QFETCH(QJsonObject, changed);
+
+    QJsonArray added;
+    QJsonArray removed;
+    MCPDiagnostics::diff(QJsonArray{diagnostic(1, 1, "a")}, QJsonArray{changed}, added, removed);
+    QCOMPARE(added, QJsonArray{changed});
+    QCOMPARE(removed, QJsonArray{diagnostic(1, 1, "a")});
+}
+
+void tst_DiagnosticsDiff::otherFieldsAreIgnored()
+{
+    QJsonObject withEndLine = diagnostic(1, 1, "a");
+    withEndLine["endLine"] = 4;
+
+    QJsonArray added;
+    QJsonArray removed;
+    MCPDiagnostics::diff(QJsonArray{diagnostic(1, 1, "a")}, QJsonArray{withEndLine}, added, removed);
+    QVERIFY(added.isEmpty());
+    QVERIFY(removed.isEmpty());
+}
+
+QTEST_GUILESS_MAIN(tst_DiagnosticsDiff)
+
+#include "tst_diagnosticsdiff.moc"
@@ -0,0 +1,151 @@
+#include "mcpdocumenttext.h"
+
+#include <QTest>
+
+#include <climits>
+
+using namespace Qt_MCP_Plugin::Internal;
+
+class tst_DocumentText : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void canonicalHash();
+    void sequenceStart();
+    void byteRange_data();
+    void byteRange();
+    void lineRange_data();
+    void lineRange();
+    void lineRangeSkipsByteOrderMark();
+    void limitRange();
+};
+
+void tst_DocumentText::canonicalHash()
+{
+    // A file with a byte order mark and CRLF hashes like the LF buffer the editor shows
+    const QByteArray lf = "one\ntwo\n";
+    QCOMPARE(MCPDocumentText::canonicalText(QByteArray("\xEF\xBB\xBFone\r\ntwo\r\n")), lf);
+    QCOMPARE(MCPDocumentText::canonicalText(lf), lf);
+    QCOMPARE(MCPDocumentText::hashOf(MCPDocumentText::canonicalText(QByteArray("one\r\ntwo\r\n"))),
+             MCPDocumentText::hashOf(lf));
+    QVERIFY(MCPDocumentText::hashOf(lf) != MCPDocumentText::hashOf("one\ntwo"));
+    QCOMPARE(MCPDocumentText::hashOf(QByteArray()), QString("da39a3ee5e6b4b0d3255bfef95601890afd80709"));
+
+    // A lone CR is not a line ending
+    QCOMPARE(MCPDocumentText::canonicalText(QByteArray("a\rb")), QByteArray("a\rb"));
+}
+
+void tst_DocumentText::sequenceStart()
+{
+    const QByteArray data = "a\xC3\xA9z";   // "aéz"
+    QCOMPARE(MCPDocumentText::sequenceStart(data, 0), qint64(0));
+    QCOMPARE(MCPDocumentText::sequenceStart(data, 1), qint64(1));
+    QCOMPARE(MCPDocumentText::sequenceStart(data, 2), qint64(1));
+    QCOMPARE(MCPDocumentText::sequenceStart(data, 3), qint64(3));
+    QCOMPARE(MCPDocumentText::sequenceStart(data, 4), qint64(4));
+}
+
+void tst_DocumentText::byteRange_data()
+{
+    QTest::addColumn<QJsonObject>("range");
+    QTest::addColumn<qint64>("begin");
+    QTest::addColumn<qint64>("end");
+
+    // "aébc": the é takes bytes 1 and 2
+    QTest::newRow("whole") << QJsonObject() << qint64(0) << qint64(5);
+    QTest::newRow("offset") << QJsonObject{{"offset", 3}} << qint64(3) << qint64(5);
+    QTest::newRow("offsetInSequence") << QJsonObject{{"offset", 2}} << qint64(1) << qint64(5);
+    QTest::newRow("length") << QJsonObject{{"offset", 1}, {"length", 2}} << qint64(1) << qint64(3);
+    QTest::newRow("offsetPastEnd") << QJsonObject{{"offset", 10}} << qint64(5) << qint64(5);
+    QTest::newRow("negativeOffset") << QJsonObject{{"offset", -4}} << qint64(0) << qint64(5);
+    QTest::newRow("lengthPastEnd") << QJsonObject{{"length", 100}} << qint64(0) << qint64(5);
+    QTest::newRow("negativeLength") << QJsonObject{{"length", -1}} << qint64(0) << qint64(0);
+}
+
+void tst_DocumentText::byteRange()
+{
+    QFETCH(QJsonObject, range);
+    QFETCH(qint64, begin);
+    QFETCH(qint64, end);
+
+    const MCPDocumentText::Range result = MCPDocumentText::byteRange(QByteArray("a\xC3\xA9" "bc"), range);
+    QCOMPARE(result.begin, begin);
+    QCOMPARE(result.end, end);
+}
+
+void tst_DocumentText::lineRange_data()
+{
+    QTest::addColumn<QByteArray>("text");
+    QTest::addColumn<int>("startLine");
+    QTest::addColumn<int>("endLine");
+    QTest::addColumn<qint64>("begin");
+    QTest::addColumn<qint64>("end");
+    QTest::addColumn<int>("lastLine");
+
+    const QByteArray text = "one\ntwo\nthree";
+    QTest::newRow("all") << text << 1 << INT_MAX << qint64(0) << qint64(13) << 3;
+    QTest::newRow("first") << text << 1 << 1 << qint64(0) << qint64(4) << 1;
+    QTest::newRow("middle") << text << 2 << 2 << qint64(4) << qint64(8) << 2;
+    QTest::newRow("last") << text << 3 << 3 << qint64(8) << qint64(13) << 3;
+    QTest::newRow("startBelowOne") << text << 0 << 1 << qint64(0) << qint64(4) << 1;
+    QTest::newRow("endPastText") << text << 2 << 10 << qint64(4) << qint64(13) << 3;
+    QTest::newRow("startPastText") << text << 5 << 6 << qint64(13) << qint64(13) << 3;
+    QTest::newRow("trailingNewline") << QByteArray("a\nb\n") << 1 << INT_MAX << qint64(0) << qint64(4) << 2;
+    QTest::newRow("empty") << QByteArray() << 1 << INT_MAX << qint64(0) << qint64(0) << 0;
+}
+
+void tst_DocumentText::lineRange()
+{
+    QFETCH(QByteArray, text);
+    QFETCH(int, startLine);
+    QFETCH(int, endLine);
+    QFETCH(qint64, begin);
+    QFETCH(qint64, end);
+    QFETCH(int, lastLine);
+
+    const MCPDocumentText::Range range = MCPDocumentText::lineRange(text, startLine, endLine);
+    QCOMPARE(range.startLine, qMax(1, startLine));
+    QCOMPARE(range.begin, begin);
+    QCOMPARE(range.end, end);
+    QCOMPARE(range.endLine, lastLine);
+}
+
+void tst_DocumentText::lineRangeSkipsByteOrderMark()
+{
+    const QByteArray text = "\xEF\xBB\xBFone\ntwo\n";
+
+    MCPDocumentText::Range range = MCPDocumentText::lineRange(text, 1, 1);
+    QCOMPARE(range.begin, qint64(3));
+    QCOMPARE(range.end, qint64(7));
+
+    range = MCPDocumentText::lineRange(text, 2, 2);
+    QCOMPARE(range.begin, qint64(7));
+    QCOMPARE(range.end, qint64(11));
+
+    range = MCPDocumentText::lineRange(text, 1, 0);
+    QCOMPARE(range.begin, qint64(0));
+    QCOMPARE(range.end, qint64(0));
+}
+
+void tst_DocumentText::limitRange()
+{
+    const QByteArray data = "a\xC3\xA9\xC3\xA9";   // "aéé"
+
+    MCPDocumentText::Range range{0, 5};
+    QVERIFY(!MCPDocumentText::limitRange(data, range, 5));
+    QCOMPARE(range.end, qint64(5));
+
+    // The cut never splits a UTF-8 sequence
+    range = {0, 5};
+    QVERIFY(MCPDocumentText::limitRange(data, range, 4));
+    QCOMPARE(range.end, qint64(3));
+
+    range = {1, 5};
+    QVERIFY(MCPDocumentText::limitRange(data, range, 1));
+    QCOMPARE(range.end, qint64(1));
+}
+
+QTEST_GUILESS_MAIN(tst_DocumentText)
+
+#include "tst_documenttext.moc"
@@ -0,0 +1,263 @@
+#include "mcpdurations.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTest>
+
+using namespace Qt_MCP_Plugin::Internal;
+
+class tst_Durations : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void unknownOperation();
+    void firstSampleIsTheAverage();
+    void movingAverage();
+    void p90OverRecentSamples_data();
+    void p90OverRecentSamples();
+    void negativeDurationsAreIgnored();
+    void entriesAreKeyedByProjectAndConfig();
+    void suggestedTimeout_data();
+    void suggestedTimeout();
+    void oldestEntryIsEvicted();
+    void saveHandlerGetsEveryRecord();
+    void jsonRoundTrip();
+    void malformedJsonIsSkipped();
+};
+
+void tst_Durations::unknownOperation()
+{
+    MCPDurationHistory history;
+    MCPDurationHistory::Prediction prediction;
+    QVERIFY(!history.predict("build", "app", "Debug", prediction));
+    QCOMPARE(prediction.samples, 0);
+}
+
+void tst_Durations::firstSampleIsTheAverage()
+{
+    MCPDurationHistory history;
+    history.record("build", "app", "Debug", 1234);
+
+    MCPDurationHistory::Prediction prediction;
+    QVERIFY(history.predict("build", "app", "Debug", prediction));
+    QCOMPARE(prediction.samples, 1);
+    QCOMPARE(prediction.ewmaMs, qint64(1234));
+    QCOMPARE(prediction.p90Ms, qint64(1234));
+    QCOMPARE(prediction.lastMs, qint64(1234));
+}
+
+void tst_Durations::movingAverage()
+{
+    MCPDurationHistory history;
+    history.record("build", "app", "Debug", 1000);
+    history.record("build", "app", "Debug", 2000);
+
+    // 0.3 * 2000 + 0.7 * 1000; the average is truncated to whole milliseconds
+    MCPDurationHistory::Prediction prediction;
+    QVERIFY(history.predict("build", "app", "Debug", prediction));
+    QVERIFY(qAbs(prediction.ewmaMs - 1300) <= 1);
+    QCOMPARE(prediction.lastMs, qint64(2000));
+
+    // 0.3 * 100 + 0.7 * 1300
+    history.record("build", "app", "Debug", 100);
+    QVERIFY(history.predict("build", "app", "Debug", prediction));
+    QCOMPARE(prediction.samples, 3);
+    QVERIFY(qAbs(prediction.ewmaMs - 940) <= 1);
+    QCOMPARE(prediction.lastMs, qint64(100));
+}
+
+void tst_Durations::p90OverRecentSamples_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<qint64>("p90Ms");
+
+    // Samples are 100, 200, ... recorded in that order; nearest rank ceil(0.9 * n)
+    QTest::newRow("one") << 1 << qint64(100);
+    QTest::newRow("two") << 2 << qint64(200);
+    QTest::newRow("ten") << 10 << qint64(900);
+    QTest::newRow("eleven") << 11 << qint64(1000);
+    QTest::newRow("twenty") << 20 << qint64(1800);
+
+    // Only the last RecentSamples count: 600 ... 2500
+    QTest::newRow("twenty-five") << 25 << qint64(2300);
+}
+
+void tst_Durations::p90OverRecentSamples()
+{
+    QFETCH(int, count);
+    QFETCH(qint64, p90Ms);
+
+    // The estimate must not depend on the order the samples came in
+    MCPDurationHistory ascending;
+    MCPDurationHistory descending;
+    for (int i = 1; i <= count; ++i) {
+        ascending.record("findFiles", "app", "", i * 100);
+    }
+    for (int i = 1; i <= count; ++i) {
+        descending.record("findFiles", "app", "", (count - i + 1) * 100);
+    }
+
+    MCPDurationHistory::Prediction prediction;
+    QVERIFY(ascending.predict("findFiles", "app", "", prediction));
+    QCOMPARE(prediction.samples, count);
+    QCOMPARE(prediction.p90Ms, p90Ms);
+    QCOMPARE(prediction.lastMs, qint64(count * 100));
+
+    if (count <= MCPDurationHistory::RecentSamples) {
+        QVERIFY(descending.predict("findFiles", "app", "", prediction));
+        QCOMPARE(prediction.p90Ms, p90Ms);
+        QCOMPARE(prediction.lastMs, qint64(100));
+    }
+}
+
+void tst_Durations::negativeDurationsAreIgnored()
+{
+    MCPDurationHistory history;
+    history.record("build", "app", "Debug", -1);
+
+    MCPDurationHistory::Prediction prediction;
+    QVERIFY(!history.predict("build", "app", "Debug", prediction));
+
+    history.record("build", "app", "Debug", 0);
+    QVERIFY(history.predict("build", "app", "Debug", prediction));
+    QCOMPARE(prediction.samples, 1);
+}
+
+void tst_Durations::entriesAreKeyedByProjectAndConfig()
+{
+    MCPDurationHistory history;
+    history.record("build", "app", "Debug", 1000);
+    history.record("build", "app", "Release", 5000);
+    history.record("build", "lib", "Debug", 9000);
+
+    MCPDurationHistory::Prediction prediction;
+    QVERIFY(history.predict("build", "app", "Debug", prediction));
+    QCOMPARE(prediction.ewmaMs, qint64(1000));
+    QVERIFY(history.predict("build", "app", "Release", prediction));
+    QCOMPARE(prediction.ewmaMs, qint64(5000));
+    QVERIFY(history.predict("build", "lib", "Debug", prediction));
+    QCOMPARE(prediction.ewmaMs, qint64(9000));
+
+    QVERIFY(!history.predict("build", "lib", "Release", prediction));
+    QVERIFY(!history.predict("rebuild", "app", "Debug", prediction));
+}
+
+void tst_Durations::suggestedTimeout_data()
+{
+    QTest::addColumn<qint64>("ewmaMs");
+    QTest::addColumn<qint64>("p90Ms");
+    QTest::addColumn<int>("seconds");
+
+    QTest::newRow("floor") << qint64(0) << qint64(0) << 5;
+    QTest::newRow("short") << qint64(2000) << qint64(3000) << 5;
+    QTest::newRow("p90") << qint64(8000) << qint64(10000) << 15;
+    QTest::newRow("rounds up") << qint64(8000) << qint64(10001) << 16;
+    QTest::newRow("average above p90") << qint64(9001) << qint64(1000) << 14;
+    QTest::newRow("long") << qint64(100000) << qint64(600000) << 900;
+}
+
+void tst_Durations::suggestedTimeout()
+{
+    QFETCH(qint64, ewmaMs);
+    QFETCH(qint64, p90Ms);
+    QFETCH(int, seconds);
+
+    MCPDurationHistory::Prediction prediction;
+    prediction.ewmaMs = ewmaMs;
+    prediction.p90Ms = p90Ms;
+    QCOMPARE(prediction.suggestedTimeoutSeconds(), seconds);
+    QCOMPARE(prediction.toJson().value("suggestedTimeoutSeconds").toInt(), seconds);
+}
+
+void tst_Durations::oldestEntryIsEvicted()
+{
+    MCPDurationHistory history;
+    history.record("build", "oldest", "", 1000);
+
+    // Entries are aged by wall-clock time
+    QTest::qSleep(5);
+    for (int i = 0; i < MCPDurationHistory::MaxEntries; ++i) {
+        history.record("build", QString("project%1").arg(i), "", 1000);
+    }
+
+    MCPDurationHistory::Prediction prediction;
+    QVERIFY(!history.predict("build", "oldest", "", prediction));
+    QVERIFY(history.predict("build", "project0", "", prediction));
+    QVERIFY(history.predict("build", QString("project%1").arg(MCPDurationHistory::MaxEntries - 1), "",
+                            prediction));
+    QCOMPARE(QJsonDocument::fromJson(history.toJson()).array().size(), qsizetype(MCPDurationHistory::MaxEntries));
+}
+
+void tst_Durations::saveHandlerGetsEveryRecord()
+{
+    MCPDurationHistory history;
+    QList<QByteArray> saved;
+    history.setSaveHandler([&saved](const QByteArray &json) {
+        saved.append(json);
+    });
+
+    history.record("build", "app", "Debug", 1000);
+    history.record("build", "app", "Debug", -5);
+    history.record("parse", "app", "Debug", 200);
+
+    QCOMPARE(saved.size(), qsizetype(2));
+    QCOMPARE(QJsonDocument::fromJson(saved.at(0)).array().size(), qsizetype(1));
+    QCOMPARE(saved.at(1), history.toJson());
+}
+
+void tst_Durations::jsonRoundTrip()
+{
+    MCPDurationHistory history;
+    history.record("build", "app", "Debug", 1000);
+    history.record("build", "app", "Debug", 2001);
+    history.record("loadSession", "work", "", 700);
+
+    MCPDurationHistory restored;
+    restored.fromJson(history.toJson());
+
+    MCPDurationHistory::Prediction before;
+    MCPDurationHistory::Prediction after;
+    QVERIFY(history.predict("build", "app", "Debug", before));
+    QVERIFY(restored.predict("build", "app", "Debug", after));
+    QCOMPARE(after.samples, before.samples);
+    QCOMPARE(after.ewmaMs, before.ewmaMs);
+    QCOMPARE(after.p90Ms, before.p90Ms);
+    QCOMPARE(after.lastMs, before.lastMs);
+
+    QVERIFY(restored.predict("loadSession", "work", "", after));
+    QCOMPARE(after.lastMs, qint64(700));
+
+    // The average continues from the restored value
+    history.record("build", "app", "Debug", 3000);
+    restored.record("build", "app", "Debug", 3000);
+    QVERIFY(history.predict("build", "app", "Debug", before));
+    QVERIFY(restored.predict("build", "app", "Debug", after));
+    QVERIFY(qAbs(after.ewmaMs - before.ewmaMs) <= 1);
+}
+
+void tst_Durations::malformedJsonIsSkipped()
+{
+    MCPDurationHistory history;
+    history.fromJson("not json");
+    history.fromJson(R"({"m":"build"})");
+    history.fromJson(R"([
+        {"m":"","p":"app","c":"","n":1,"e":100,"t":1,"s":[100]},
+        {"m":"build","p":"noCount","c":"","n":0,"e":100,"t":1,"s":[100]},
+        {"m":"build","p":"noSamples","c":"","n":3,"e":100,"t":1,"s":[]},
+        {"m":"build","p":"app","c":"","n":3,"e":100,"t":1,"s":[90,100,110]},
+        7
+    ])");
+
+    MCPDurationHistory::Prediction prediction;
+    QVERIFY(!history.predict("build", "noCount", "", prediction));
+    QVERIFY(!history.predict("build", "noSamples", "", prediction));
+    QVERIFY(history.predict("build", "app", "", prediction));
+    QCOMPARE(prediction.samples, 3);
+    QCOMPARE(prediction.p90Ms, qint64(110));
+    QCOMPARE(QJsonDocument::fromJson(history.toJson()).array().size(), qsizetype(1));
+}
+
+QTEST_GUILESS_MAIN(tst_Durations)
+
+#include "tst_durations.moc"
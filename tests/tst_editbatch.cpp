@@ -0,0 +1,194 @@
+#include "mcpeditbatch.h"
+
+#include <QJsonArray>
+#include <QTest>
+
+using namespace Qt_MCP_Plugin::Internal;
+
+class tst_EditBatch : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void groupsEditsPerFile();
+    void topLevelHash();
+    void invalidParams_data();
+    void invalidParams();
+    void resolveSortsByStart();
+    void resolveRejectsRanges_data();
+    void resolveRejectsRanges();
+    void resolveAllowsTouchingEdits();
+
+private:
+    static QJsonObject edit(const QString &path, int startLine, int startColumn, int endLine, int endColumn,
+                            const QString &newText = QString());
+    static MCPEditBatch::PositionFunction positions(const QStringList &lines);
+};
+
+QJsonObject tst_EditBatch::edit(const QString &path, int startLine, int startColumn, int endLine, int endColumn,
+                                const QString &newText)
+{
+    QJsonObject range;
+    range["startLine"] = startLine;
+    range["startColumn"] = startColumn;
+    range["endLine"] = endLine;
+    range["endColumn"] = endColumn;
+
+    QJsonObject item;
+    item["path"] = path;
+    item["range"] = range;
+    item["newText"] = newText;
+    return item;
+}
+
+// Positions in a document of these lines, the way QTextDocument blocks give
+// them: the column after the last character is still on the line
+MCPEditBatch::PositionFunction tst_EditBatch::positions(const QStringList &lines)
+{
+    return [lines](int line, int column, int &pos) {
+        if (line < 1 || line > lines.size() || column < 0 || column > lines.at(line - 1).size()) {
+            return false;
+        }
+        pos = column;
+        for (int i = 0; i < line - 1; ++i) {
+            pos += lines.at(i).size() + 1;
+        }
+        return true;
+    };
+}
+
+void tst_EditBatch::groupsEditsPerFile()
+{
+    QJsonObject hashed = edit("/b.cpp", 1, 0, 1, 0, "x");
+    hashed["expectedHash"] = "bhash";
+    const QJsonObject params{{"edits", QJsonArray{edit("/a.cpp", 1, 0, 1, 1), hashed, edit("/a.cpp", 2, 0, 2, 0)}}};
+
+    MCPEditBatch batch;
+    QString errorMessage;
+    QVERIFY(batch.parse(params, errorMessage));
+    QVERIFY(errorMessage.isEmpty());
+    QCOMPARE(batch.size(), 3);
+    QCOMPARE(batch.paths(), QStringList({"/a.cpp", "/b.cpp"}));
+
+    const QList<MCPEditBatch::Edit> edits = batch.edits("/a.cpp");
+    QCOMPARE(edits.size(), qsizetype(2));
+    QCOMPARE(edits.at(0).index, 0);
+    QCOMPARE(edits.at(1).index, 2);
+    QCOMPARE(batch.edits("/b.cpp").at(0).newText, QString("x"));
+
+    QCOMPARE(batch.expectedHashes().size(), qsizetype(1));
+    QCOMPARE(batch.expectedHashes().value("/b.cpp"), QString("bhash"));
+}
+
+void tst_EditBatch::topLevelHash()
+{
+    const QJsonObject params{{"edits", QJsonArray{edit("/a.cpp", 1, 0, 1, 1), edit("/a.cpp", 2, 0, 2, 0)}},
+                             {"expectedHash", "ahash"}};
+
+    MCPEditBatch batch;
+    QString errorMessage;
+    QVERIFY(batch.parse(params, errorMessage));
+    QCOMPARE(batch.expectedHashes().value("/a.cpp"), QString("ahash"));
+}
+
+void tst_EditBatch::invalidParams_data()
+{
+    QTest::addColumn<QJsonObject>("params");
+    QTest::addColumn<QString>("error");
+
+    QJsonObject noRange = edit("/a.cpp", 1, 0, 1, 0);
+    noRange.remove("range");
+
+    QTest::newRow("noEdits") << QJsonObject() << QString("No edits given");
+    QTest::newRow("emptyEdits") << QJsonObject{{"edits", QJsonArray()}} << QString("No edits given");
+    QTest::newRow("noPath") << QJsonObject{{"edits", QJsonArray{edit("/a.cpp", 1, 0, 1, 0), edit(QString(), 1, 0, 1, 0)}}}
+                            << QString("Edit 1 needs path and range");
+    QTest::newRow("noRange") << QJsonObject{{"edits", QJsonArray{noRange}}} << QString("Edit 0 needs path and range");
+    QTest::newRow("topLevelHashTwoFiles")
+        << QJsonObject{{"edits", QJsonArray{edit("/a.cpp", 1, 0, 1, 0), edit("/b.cpp", 1, 0, 1, 0)}},
+                       {"expectedHash", "ahash"}}
+        << QString("A top-level expectedHash needs all edits in one file; give expectedHash per edit instead");
+}
+
+void tst_EditBatch::invalidParams()
+{
+    QFETCH(QJsonObject, params);
+    QFETCH(QString, error);
+
+    MCPEditBatch batch;
+    QString errorMessage;
+    QVERIFY(!batch.parse(params, errorMessage));
+    QCOMPARE(errorMessage, error);
+}
+
+void tst_EditBatch::resolveSortsByStart()
+{
+    const QJsonObject params{{"edits", QJsonArray{edit("/a.cpp", 2, 4, 2, 5, "c"), edit("/a.cpp", 1, 4, 1, 5, "b")}}};
+
+    MCPEditBatch batch;
+    QString errorMessage;
+    QVERIFY(batch.parse(params, errorMessage));
+    QVERIFY(batch.resolve("/a.cpp", positions({"int a;", "int b;"}), errorMessage));
+
+    const QList<MCPEditBatch::Edit> edits = batch.edits("/a.cpp");
+    QCOMPARE(edits.size(), qsizetype(2));
+    QCOMPARE(edits.at(0).index, 1);
+    QCOMPARE(edits.at(0).start, 4);
+    QCOMPARE(edits.at(0).end, 5);
+    QCOMPARE(edits.at(1).index, 0);
+    QCOMPARE(edits.at(1).start, 11);
+    QCOMPARE(edits.at(1).end, 12);
+}
+
+void tst_EditBatch::resolveRejectsRanges_data()
+{
+    QTest::addColumn<QJsonArray>("edits");
+    QTest::addColumn<QString>("error");
+
+    QTest::newRow("lineZero") << QJsonArray{edit("/a.cpp", 0, 0, 1, 0)} << QString("Edit 0: range outside of /a.cpp");
+    QTest::newRow("linePastEnd") << QJsonArray{edit("/a.cpp", 1, 0, 3, 0)} << QString("Edit 0: range outside of /a.cpp");
+    QTest::newRow("columnPastLine") << QJsonArray{edit("/a.cpp", 1, 0, 1, 7)} << QString("Edit 0: range outside of /a.cpp");
+    QTest::newRow("negativeColumn") << QJsonArray{edit("/a.cpp", 1, -1, 1, 2)} << QString("Edit 0: range outside of /a.cpp");
+    QTest::newRow("endBeforeStart") << QJsonArray{edit("/a.cpp", 1, 0, 1, 1), edit("/a.cpp", 2, 3, 1, 2)}
+                                    << QString("Edit 1: range outside of /a.cpp");
+    QTest::newRow("overlap") << QJsonArray{edit("/a.cpp", 1, 2, 2, 1), edit("/a.cpp", 1, 0, 1, 4)}
+                             << QString("Edits 1 and 0 overlap in /a.cpp");
+    QTest::newRow("insertInsideReplace") << QJsonArray{edit("/a.cpp", 1, 0, 1, 6), edit("/a.cpp", 1, 3, 1, 3)}
+                                         << QString("Edits 0 and 1 overlap in /a.cpp");
+}
+
+void tst_EditBatch::resolveRejectsRanges()
+{
+    QFETCH(QJsonArray, edits);
+    QFETCH(QString, error);
+
+    MCPEditBatch batch;
+    QString errorMessage;
+    QVERIFY(batch.parse(QJsonObject{{"edits", edits}}, errorMessage));
+    QVERIFY(!batch.resolve("/a.cpp", positions({"int a;", "int b;"}), errorMessage));
+    QCOMPARE(errorMessage, error);
+}
+
+void tst_EditBatch::resolveAllowsTouchingEdits()
+{
+    // One edit ending where the next starts, and two insertions at one place
+    const QJsonObject params{{"edits", QJsonArray{edit("/a.cpp", 1, 3, 1, 6), edit("/a.cpp", 1, 0, 1, 3),
+                                                  edit("/a.cpp", 2, 0, 2, 0, "x"), edit("/a.cpp", 2, 0, 2, 0, "y")}}};
+
+    MCPEditBatch batch;
+    QString errorMessage;
+    QVERIFY(batch.parse(params, errorMessage));
+    QVERIFY(batch.resolve("/a.cpp", positions({"int a;", "int b;"}), errorMessage));
+
+    // Insertions at one position keep their request order
+    const QList<MCPEditBatch::Edit> edits = batch.edits("/a.cpp");
+    QCOMPARE(edits.size(), qsizetype(4));
+    QCOMPARE(edits.at(0).index, 1);
+    QCOMPARE(edits.at(1).index, 0);
+    QCOMPARE(edits.at(2).newText, QString("x"));
+    QCOMPARE(edits.at(3).newText, QString("y"));
+}
+
+QTEST_GUILESS_MAIN(tst_EditBatch)
+
+#include "tst_editbatch.moc"
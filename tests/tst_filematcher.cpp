@@ -0,0 +1,139 @@
+#include "mcpfilematcher.h"
+
+#include <QTest>
+
+using namespace Qt_MCP_Plugin::Internal;
+
+class tst_FileMatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void glob_data();
+    void glob();
+    void fuzzyMatches_data();
+    void fuzzyMatches();
+    void fuzzyRanking_data();
+    void fuzzyRanking();
+    void fuzzyPathPattern();
+    void longPathsStillMatch();
+
+private:
+    static int match(const QString &pattern, bool fuzzy, const QString &relativePath);
+};
+
+int tst_FileMatcher::match(const QString &pattern, bool fuzzy, const QString &relativePath)
+{
+    const QStringView path(relativePath);
+    const QStringView name = path.mid(relativePath.lastIndexOf('/') + 1);
+    return MCPFileMatcher(pattern, fuzzy).match(name, path);
+}
+
+void tst_FileMatcher::glob_data()
+{
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<QString>("relativePath");
+    QTest::addColumn<bool>("matches");
+
+    QTest::newRow("extension") << "*.cpp" << "src/main.cpp" << true;
+    QTest::newRow("whole name") << "*.cpp" << "src/main.cpp.orig" << false;
+    QTest::newRow("case") << "*.CPP" << "src/Main.cpp" << true;
+    QTest::newRow("question mark") << "main?.cpp" << "main1.cpp" << true;
+    QTest::newRow("question mark needs a character") << "main?.cpp" << "main.cpp" << false;
+    QTest::newRow("character class") << "[ab].h" << "include/b.h" << true;
+    QTest::newRow("exact name") << "CMakeLists.txt" << "src/app/CMakeLists.txt" << true;
+
+    // Without '/' only the file name is matched
+    QTest::newRow("name ignores directories") << "src*" << "src/widget.cpp" << false;
+
+    // With '/' the relative path is matched and '*' crosses directories
+    QTest::newRow("path") << "src/*.cpp" << "src/main.cpp" << true;
+    QTest::newRow("path crosses directories") << "src/*.cpp" << "src/ui/dialogs/main.cpp" << true;
+    QTest::newRow("path in the middle") << "src/*/tests/*.cpp" << "src/core/io/tests/tst_io.cpp" << true;
+    QTest::newRow("path needs every part") << "src/*/tests/*.cpp" << "src/tests/tst_io.cpp" << false;
+    QTest::newRow("path is anchored") << "src/*.cpp" << "lib/src/main.cpp" << false;
+    QTest::newRow("path case") << "SRC/*.cpp" << "src/main.cpp" << true;
+}
+
+void tst_FileMatcher::glob()
+{
+    QFETCH(QString, pattern);
+    QFETCH(QString, relativePath);
+    QFETCH(bool, matches);
+
+    // Globs do not rank, every match scores 0
+    QCOMPARE(match(pattern, false, relativePath), matches ? 0 : -1);
+}
+
+void tst_FileMatcher::fuzzyMatches_data()
+{
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<QString>("relativePath");
+    QTest::addColumn<bool>("matches");
+
+    QTest::newRow("subsequence") << "mwin" << "src/mainwindow.cpp" << true;
+    QTest::newRow("pattern case") << "MWin" << "src/mainwindow.cpp" << true;
+    QTest::newRow("text case") << "mwin" << "src/MainWindow.cpp" << true;
+    QTest::newRow("order matters") << "wm" << "src/mainwindow.cpp" << false;
+    QTest::newRow("missing character") << "mwinx" << "src/mainwindow.cpp" << false;
+    QTest::newRow("name only") << "srcm" << "src/mainwindow.cpp" << false;
+    QTest::newRow("whole name") << "mainwindow.cpp" << "src/mainwindow.cpp" << true;
+}
+
+void tst_FileMatcher::fuzzyMatches()
+{
+    QFETCH(QString, pattern);
+    QFETCH(QString, relativePath);
+    QFETCH(bool, matches);
+
+    QCOMPARE(match(pattern, true, relativePath) >= 0, matches);
+}
+
+void tst_FileMatcher::fuzzyRanking_data()
+{
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<QString>("better");
+    QTest::addColumn<QString>("worse");
+
+    QTest::newRow("consecutive") << "main" << "main.cpp" << "maxin.cpp";
+    QTest::newRow("camel case word start") << "mw" << "MainWindow.cpp" << "mainwindow.cpp";
+    QTest::newRow("separator word start") << "ui" << "foo_ui.h" << "fooui.h";
+    QTest::newRow("first character") << "m" << "main.cpp" << "am.cpp";
+    QTest::newRow("shorter name") << "main" << "main.cpp" << "main.cpp.orig";
+    QTest::newRow("score beats length") << "mw" << "MainWindowWithAVeryLongName.cpp" << "mwx.cpp";
+}
+
+void tst_FileMatcher::fuzzyRanking()
+{
+    QFETCH(QString, pattern);
+    QFETCH(QString, better);
+    QFETCH(QString, worse);
+
+    const int betterScore = match(pattern, true, better);
+    const int worseScore = match(pattern, true, worse);
+    QVERIFY(worseScore >= 0);
+    QVERIFY2(betterScore > worseScore,
+             qPrintable(QString("%1 scored %2, %3 scored %4").arg(better).arg(betterScore)
+                            .arg(worse).arg(worseScore)));
+}
+
+void tst_FileMatcher::fuzzyPathPattern()
+{
+    // A '/' in the pattern matches against the relative path
+    QVERIFY(match("src/mw", true, "src/ui/mainwindow.cpp") >= 0);
+    QVERIFY(match("src/mw", true, "lib/ui/mainwindow.cpp") < 0);
+    QCOMPARE(MCPFileMatcher::fuzzyScore(u"src/mw", u"src/ui/mainwindow.cpp"),
+             match("src/mw", true, "src/ui/mainwindow.cpp"));
+}
+
+void tst_FileMatcher::longPathsStillMatch()
+{
+    // One weak match in a long path must not fall below zero
+    const QString path = QString("a/").repeated(600) + "qux.cpp";
+    QVERIFY(match("a/x", true, path) >= 0);
+    QVERIFY(MCPFileMatcher::fuzzyScore(u"x", u"src/some/deep/directory/qux.cpp") > 0);
+}
+
+QTEST_GUILESS_MAIN(tst_FileMatcher)
+
+#include "tst_filematcher.moc"
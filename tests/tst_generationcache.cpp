@@ -0,0 +1,98 @@
+#include "mcpgenerationcache.h"
+
+#include <QJsonObject>
+#include <QTest>
+
+using namespace Qt_MCP_Plugin::Internal;
+
+class tst_GenerationCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void findAndInsert();
+    void sameGenerationKeepsEntries();
+    void newGenerationClearsEntries();
+    void staleResultIsNotCached();
+    void remove();
+};
+
+void tst_GenerationCache::findAndInsert()
+{
+    MCPGenerationCache<QString, QJsonObject> cache(3);
+    QCOMPARE(cache.generation(), quint64(3));
+    QVERIFY(!cache.find("main.cpp"));
+
+    QJsonObject flags;
+    flags["file"] = "main.cpp";
+    QVERIFY(cache.insert("main.cpp", flags, 3));
+    QVERIFY(cache.find("main.cpp"));
+    QCOMPARE(*cache.find("main.cpp"), flags);
+    QVERIFY(!cache.find("other.cpp"));
+
+    // A second insert replaces the value
+    flags["file"] = "changed";
+    QVERIFY(cache.insert("main.cpp", flags, 3));
+    QCOMPARE(cache.find("main.cpp")->value("file").toString(), QString("changed"));
+    QCOMPARE(cache.size(), 1);
+}
+
+void tst_GenerationCache::sameGenerationKeepsEntries()
+{
+    MCPGenerationCache<QString, int> cache(1);
+    cache.insert("a", 1, 1);
+    cache.update(1);
+    QCOMPARE(cache.size(), 1);
+    QCOMPARE(*cache.find("a"), 1);
+}
+
+void tst_GenerationCache::newGenerationClearsEntries()
+{
+    MCPGenerationCache<QString, int> cache(1);
+    cache.insert("a", 1, 1);
+    cache.insert("b", 2, 1);
+
+    cache.update(2);
+    QCOMPARE(cache.generation(), quint64(2));
+    QCOMPARE(cache.size(), 0);
+    QVERIFY(!cache.find("a"));
+
+    // Any change counts, the generation is compared, not ordered
+    QVERIFY(cache.insert("a", 3, 2));
+    cache.update(0);
+    QCOMPARE(cache.size(), 0);
+}
+
+void tst_GenerationCache::staleResultIsNotCached()
+{
+    // An export takes its input at generation 5, a parse finishes while it runs
+    MCPGenerationCache<int, QString> cache(5);
+    const quint64 builtFrom = cache.generation();
+    cache.update(6);
+
+    QVERIFY(!cache.insert(1, "database", builtFrom));
+    QVERIFY(!cache.find(1));
+    QCOMPARE(cache.size(), 0);
+
+    // A newer value than the cache knows of is not stored either
+    QVERIFY(!cache.insert(1, "database", 7));
+    QVERIFY(cache.insert(1, "database", 6));
+    QCOMPARE(*cache.find(1), QString("database"));
+}
+
+void tst_GenerationCache::remove()
+{
+    MCPGenerationCache<int, int> cache;
+    QCOMPARE(cache.generation(), quint64(0));
+    cache.insert(1, 10, 0);
+    cache.insert(2, 20, 0);
+    cache.remove(1);
+    cache.remove(3);
+    QVERIFY(!cache.find(1));
+    QCOMPARE(*cache.find(2), 20);
+    QCOMPARE(cache.size(), 1);
+}
+
+QTEST_GUILESS_MAIN(tst_GenerationCache)
+
+#include "tst_generationcache.moc"
@@ -0,0 +1,108 @@
+#include "mcpoutputbuffer.h"
+
+#include <QTest>
+
+using namespace Qt_MCP_Plugin::Internal;
+
+class tst_OutputBuffer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void empty();
+    void sequenceNumbers();
+    void dropsOldestChunks();
+    void keepsNewestChunk();
+    void textSkipsSystemMessages();
+};
+
+void tst_OutputBuffer::empty()
+{
+    const MCPOutputBuffer buffer;
+    QCOMPARE(buffer.nextSeq(), qint64(1));
+    QVERIFY(buffer.since(1).isEmpty());
+    QCOMPARE(buffer.dropped(1), qint64(0));
+
+    bool truncated = true;
+    QCOMPARE(buffer.text(truncated), QString());
+    QVERIFY(!truncated);
+}
+
+void tst_OutputBuffer::sequenceNumbers()
+{
+    MCPOutputBuffer buffer;
+    QCOMPARE(buffer.append("stdout", "one\n"), qint64(1));
+    QCOMPARE(buffer.append("stderr", "two\n"), qint64(2));
+    QCOMPARE(buffer.append("stdout", "three\n"), qint64(3));
+    QCOMPARE(buffer.nextSeq(), qint64(4));
+    QCOMPARE(buffer.bytes(), qint64(14));
+
+    QList<MCPOutputBuffer::Chunk> chunks = buffer.since(2);
+    QCOMPARE(chunks.size(), qsizetype(2));
+    QCOMPARE(chunks.at(0).seq, qint64(2));
+    QCOMPARE(chunks.at(0).stream, QString("stderr"));
+    QCOMPARE(chunks.at(0).text, QString("two\n"));
+    QCOMPARE(chunks.at(1).seq, qint64(3));
+
+    QCOMPARE(buffer.since(0).size(), qsizetype(3));
+    QCOMPARE(buffer.since(-5).size(), qsizetype(3));
+    QVERIFY(buffer.since(4).isEmpty());
+    QVERIFY(buffer.since(100).isEmpty());
+    QCOMPARE(buffer.dropped(1), qint64(0));
+}
+
+void tst_OutputBuffer::dropsOldestChunks()
+{
+    MCPOutputBuffer buffer(10);
+    buffer.append("stdout", "abcd");
+    buffer.append("stdout", "efgh");
+    buffer.append("stdout", "ijkl");
+    QCOMPARE(buffer.bytes(), qint64(8));
+    QCOMPARE(buffer.nextSeq(), qint64(4));
+
+    const QList<MCPOutputBuffer::Chunk> chunks = buffer.since(1);
+    QCOMPARE(chunks.size(), qsizetype(2));
+    QCOMPARE(chunks.at(0).seq, qint64(2));
+
+    // A reader that asked from the start missed chunk 1, one that is caught up missed nothing
+    QCOMPARE(buffer.dropped(0), qint64(1));
+    QCOMPARE(buffer.dropped(1), qint64(1));
+    QCOMPARE(buffer.dropped(2), qint64(0));
+    QCOMPARE(buffer.dropped(4), qint64(0));
+
+    bool truncated = false;
+    QCOMPARE(buffer.text(truncated), QString("efghijkl"));
+    QVERIFY(truncated);
+}
+
+void tst_OutputBuffer::keepsNewestChunk()
+{
+    MCPOutputBuffer buffer(4);
+    buffer.append("stdout", "0123456789");
+    QCOMPARE(buffer.since(1).size(), qsizetype(1));
+    QCOMPARE(buffer.bytes(), qint64(10));
+
+    buffer.append("stdout", "x");
+    const QList<MCPOutputBuffer::Chunk> chunks = buffer.since(1);
+    QCOMPARE(chunks.size(), qsizetype(1));
+    QCOMPARE(chunks.at(0).seq, qint64(2));
+    QCOMPARE(buffer.bytes(), qint64(1));
+    QCOMPARE(buffer.dropped(1), qint64(1));
+}
+
+void tst_OutputBuffer::textSkipsSystemMessages()
+{
+    MCPOutputBuffer buffer;
+    buffer.append("stdout", "a");
+    buffer.append("system", "app exited with code 0");
+    buffer.append("stderr", "b");
+
+    bool truncated = true;
+    QCOMPARE(buffer.text(truncated), QString("ab"));
+    QVERIFY(!truncated);
+    QCOMPARE(buffer.since(2).at(0).stream, QString("system"));
+}
+
+QTEST_GUILESS_MAIN(tst_OutputBuffer)
+
+#include "tst_outputbuffer.moc"
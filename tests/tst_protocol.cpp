@@ -0,0 +1,275 @@
+#include "mcpprotocol.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTest>
+
+using namespace Qt_MCP_Plugin::Internal;
+
+class tst_Protocol : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void messageSplitAcrossReads();
+    void severalMessagesInOneRead();
+    void lineTerminatorsAndBlankLines();
+    void partialTailStaysBuffered();
+    void oversizedUnterminatedTail();
+    void oversizedTailAfterCompleteMessage();
+    void oversizedTerminatedMessage();
+    void clear();
+
+    void decodeRequest_data();
+    void decodeRequest();
+    void decodeDeadline_data();
+    void decodeDeadline();
+    void decodeAfterParse();
+
+    void withId_data();
+    void withId();
+    void encodeNotification();
+
+private:
+    static QStringList drain(MCPFrameBuffer &buffer);
+};
+
+QStringList tst_Protocol::drain(MCPFrameBuffer &buffer)
+{
+    QStringList messages;
+    QByteArray message;
+    while (buffer.takeMessage(message)) {
+        messages.append(QString::fromUtf8(message));
+    }
+    return messages;
+}
+
+void tst_Protocol::messageSplitAcrossReads()
+{
+    MCPFrameBuffer buffer;
+    buffer.append("{\"jsonrpc\":");
+    QVERIFY(drain(buffer).isEmpty());
+    buffer.append("\"2.0\",\"method\"");
+    QVERIFY(drain(buffer).isEmpty());
+    buffer.append(":\"getVersion\"}\n");
+    QCOMPARE(drain(buffer), QStringList{"{\"jsonrpc\":\"2.0\",\"method\":\"getVersion\"}"});
+    QCOMPARE(buffer.bufferedSize(), qsizetype(0));
+}
+
+void tst_Protocol::severalMessagesInOneRead()
+{
+    MCPFrameBuffer buffer;
+    buffer.append("one\ntwo\nthree\n");
+    QCOMPARE(drain(buffer), (QStringList{"one", "two", "three"}));
+}
+
+void tst_Protocol::lineTerminatorsAndBlankLines()
+{
+    MCPFrameBuffer buffer;
+    buffer.append("one\r\n\r\n   \n\ttwo \n\n");
+    QCOMPARE(drain(buffer), (QStringList{"one", "two"}));
+}
+
+void tst_Protocol::partialTailStaysBuffered()
+{
+    MCPFrameBuffer buffer;
+    buffer.append("one\ntw");
+    QCOMPARE(drain(buffer), QStringList{"one"});
+    QCOMPARE(buffer.bufferedSize(), qsizetype(2));
+
+    buffer.append("o\n");
+    QCOMPARE(drain(buffer), QStringList{"two"});
+    QCOMPARE(buffer.takeOverflowCount(), 0);
+}
+
+void tst_Protocol::oversizedUnterminatedTail()
+{
+    MCPFrameBuffer buffer;
+    buffer.append(QByteArray(MCPFrameBuffer::MaxMessageSize + 1, 'x'));
+    QCOMPARE(buffer.bufferedSize(), qsizetype(0));
+    QCOMPARE(buffer.takeOverflowCount(), 1);
+    QCOMPARE(buffer.takeOverflowCount(), 0);
+
+    // The rest of the oversized line is skipped up to its terminator
+    buffer.append(QByteArray(1024, 'x'));
+    QCOMPARE(buffer.bufferedSize(), qsizetype(0));
+    buffer.append("xxx\nnext\n");
+    QCOMPARE(drain(buffer), QStringList{"next"});
+    QCOMPARE(buffer.takeOverflowCount(), 0);
+}
+
+void tst_Protocol::oversizedTailAfterCompleteMessage()
+{
+    MCPFrameBuffer buffer;
+    buffer.append("first\n" + QByteArray(MCPFrameBuffer::MaxMessageSize + 1, 'x'));
+    QCOMPARE(buffer.takeOverflowCount(), 1);
+
+    buffer.append("x\nsecond\n");
+    QCOMPARE(drain(buffer), (QStringList{"first", "second"}));
+}
+
+void tst_Protocol::oversizedTerminatedMessage()
+{
+    MCPFrameBuffer buffer;
+    buffer.append(QByteArray(MCPFrameBuffer::MaxMessageSize + 1, 'x') + "\nnext\n");
+    QCOMPARE(drain(buffer), QStringList{"next"});
+    QCOMPARE(buffer.takeOverflowCount(), 1);
+}
+
+void tst_Protocol::clear()
+{
+    MCPFrameBuffer buffer;
+    buffer.append(QByteArray(MCPFrameBuffer::MaxMessageSize + 1, 'x'));
+    buffer.clear();
+    QCOMPARE(buffer.takeOverflowCount(), 0);
+
+    // clear() also ends discarding, so the next line is delivered whole
+    buffer.append("next\n");
+    QCOMPARE(drain(buffer), QStringList{"next"});
+}
+
+void tst_Protocol::decodeRequest_data()
+{
+    QTest::addColumn<QByteArray>("message");
+    QTest::addColumn<bool>("valid");
+    QTest::addColumn<int>("errorCode");
+    QTest::addColumn<QJsonValue>("id");
+
+    QTest::newRow("valid") << QByteArray(R"({"jsonrpc":"2.0","id":7,"method":"getVersion"})")
+                           << true << 0 << QJsonValue(7);
+    QTest::newRow("notification") << QByteArray(R"({"jsonrpc":"2.0","method":"getVersion"})")
+                                  << true << 0 << QJsonValue(QJsonValue::Undefined);
+    QTest::newRow("string id") << QByteArray(R"({"jsonrpc":"2.0","id":"a","method":"x"})")
+                               << true << 0 << QJsonValue("a");
+    QTest::newRow("broken json") << QByteArray(R"({"jsonrpc":"2.0",)")
+                                 << false << MCPProtocol::ParseError << QJsonValue(QJsonValue::Undefined);
+    QTest::newRow("not an object") << QByteArray(R"([1,2])")
+                                   << false << MCPProtocol::InvalidRequest
+                                   << QJsonValue(QJsonValue::Undefined);
+    QTest::newRow("wrong version") << QByteArray(R"({"jsonrpc":"1.0","id":3,"method":"x"})")
+                                   << false << MCPProtocol::InvalidRequest << QJsonValue(3);
+    QTest::newRow("no method") << QByteArray(R"({"jsonrpc":"2.0","id":4})")
+                               << false << MCPProtocol::InvalidRequest << QJsonValue(4);
+    QTest::newRow("empty method") << QByteArray(R"({"jsonrpc":"2.0","id":5,"method":""})")
+                                  << false << MCPProtocol::InvalidRequest << QJsonValue(5);
+}
+
+void tst_Protocol::decodeRequest()
+{
+    QFETCH(QByteArray, message);
+    QFETCH(bool, valid);
+    QFETCH(int, errorCode);
+    QFETCH(QJsonValue, id);
+
+    MCPRequest request;
+    int code = 0;
+    QString errorMessage;
+    QCOMPARE(MCPProtocol::decodeRequest(message, request, code, errorMessage), valid);
+    QCOMPARE(code, errorCode);
+    QCOMPARE(errorMessage.isEmpty(), valid);
+
+    // The id is known even for invalid requests, so the error can be addressed
+    QCOMPARE(request.id, id);
+}
+
+void tst_Protocol::decodeDeadline_data()
+{
+    QTest::addColumn<QByteArray>("message");
+    QTest::addColumn<qint64>("deadlineMs");
+
+    QTest::newRow("none") << QByteArray(R"({"jsonrpc":"2.0","method":"x"})") << qint64(-1);
+    QTest::newRow("envelope") << QByteArray(R"({"jsonrpc":"2.0","method":"x","deadlineMs":250})")
+                              << qint64(250);
+    QTest::newRow("params") << QByteArray(R"({"jsonrpc":"2.0","method":"x","params":{"deadlineMs":100}})")
+                            << qint64(100);
+    QTest::newRow("envelope wins")
+        << QByteArray(R"({"jsonrpc":"2.0","method":"x","deadlineMs":5,"params":{"deadlineMs":100}})")
+        << qint64(5);
+    QTest::newRow("zero") << QByteArray(R"({"jsonrpc":"2.0","method":"x","deadlineMs":0})") << qint64(0);
+    QTest::newRow("negative") << QByteArray(R"({"jsonrpc":"2.0","method":"x","deadlineMs":-1})")
+                              << qint64(-1);
+    QTest::newRow("string") << QByteArray(R"({"jsonrpc":"2.0","method":"x","deadlineMs":"10"})")
+                            << qint64(-1);
+    QTest::newRow("clamped") << QByteArray(R"({"jsonrpc":"2.0","method":"x","deadlineMs":1e300})")
+                             << qint64(1000000000000);
+}
+
+void tst_Protocol::decodeDeadline()
+{
+    QFETCH(QByteArray, message);
+    QFETCH(qint64, deadlineMs);
+
+    MCPRequest request;
+    int code = 0;
+    QString errorMessage;
+    QVERIFY(MCPProtocol::decodeRequest(message, request, code, errorMessage));
+    QCOMPARE(request.deadlineMs, deadlineMs);
+}
+
+void tst_Protocol::decodeAfterParse()
+{
+    MCPRequest request;
+    int code = 0;
+    QString errorMessage;
+
+    QVERIFY(MCPProtocol::decodeRequest(R"({"jsonrpc":"2.0","method":"x"})", request, code, errorMessage));
+    QVERIFY(!request.afterParse);
+
+    QVERIFY(MCPProtocol::decodeRequest(R"({"jsonrpc":"2.0","method":"x","afterParse":true})",
+                                       request, code, errorMessage));
+    QVERIFY(request.afterParse);
+
+    QVERIFY(MCPProtocol::decodeRequest(R"({"jsonrpc":"2.0","method":"x","params":{"afterParse":true}})",
+                                       request, code, errorMessage));
+    QVERIFY(request.afterParse);
+
+    QVERIFY(MCPProtocol::decodeRequest(
+        R"({"jsonrpc":"2.0","method":"x","afterParse":false,"params":{"afterParse":true}})",
+        request, code, errorMessage));
+    QVERIFY(!request.afterParse);
+}
+
+void tst_Protocol::withId_data()
+{
+    QTest::addColumn<QJsonValue>("result");
+    QTest::addColumn<QJsonValue>("id");
+
+    const QJsonObject object{{"files", QJsonArray{"a.cpp", "b \"quoted\".h"}}, {"count", 2}};
+    QTest::newRow("int id") << QJsonValue(object) << QJsonValue(42);
+    QTest::newRow("negative id") << QJsonValue(object) << QJsonValue(-3);
+    QTest::newRow("double id") << QJsonValue(object) << QJsonValue(1.5);
+    QTest::newRow("string id") << QJsonValue(object) << QJsonValue("req-é\"1\"");
+    QTest::newRow("null id") << QJsonValue(object) << QJsonValue(QJsonValue::Null);
+    QTest::newRow("undefined id") << QJsonValue(object) << QJsonValue(QJsonValue::Undefined);
+    QTest::newRow("array result") << QJsonValue(QJsonArray{1, "two", QJsonValue::Null}) << QJsonValue(1);
+    QTest::newRow("string result") << QJsonValue("line\nbreak") << QJsonValue(1);
+    QTest::newRow("null result") << QJsonValue(QJsonValue::Null) << QJsonValue(1);
+}
+
+void tst_Protocol::withId()
+{
+    QFETCH(QJsonValue, result);
+    QFETCH(QJsonValue, id);
+
+    const QByteArray shared = MCPProtocol::encodeSharedResult(result);
+    QCOMPARE(MCPProtocol::withId(shared, id),
+             MCPProtocol::encodeMessage(MCPProtocol::successResponse(result, id)));
+}
+
+void tst_Protocol::encodeNotification()
+{
+    const QByteArray line = MCPProtocol::encodeNotification("diagnosticsChanged",
+                                                            QJsonObject{{"path", "a\nb.cpp"}});
+    QVERIFY(line.endsWith('\n'));
+    QCOMPARE(line.count('\n'), 1);
+
+    const QJsonObject message = QJsonDocument::fromJson(line).object();
+    QCOMPARE(message.value("jsonrpc").toString(), QString("2.0"));
+    QCOMPARE(message.value("method").toString(), QString("diagnosticsChanged"));
+    QCOMPARE(message.value("params").toObject().value("path").toString(), QString("a\nb.cpp"));
+    QVERIFY(!message.contains("id"));
+}
+
+QTEST_GUILESS_MAIN(tst_Protocol)
+
+#include "tst_protocol.moc"
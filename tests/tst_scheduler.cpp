@@ -0,0 +1,295 @@
+#include "mcpscheduler.h"
+
+#include <QJsonArray>
+#include <QTest>
+
+using namespace Qt_MCP_Plugin::Internal;
+
+Q_DECLARE_METATYPE(MCPScheduler::Priority)
+
+class tst_Scheduler : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void priorityFor_data();
+    void priorityFor();
+
+    void classesRunInPriorityOrder();
+    void requestsDoNotOvertakeOwnMutation();
+    void clientsAreServedRoundRobin();
+    void heavyQueriesAreCapped();
+    void blockedJobsWait();
+    void blockedMutationHoldsBackItsClient();
+    void expiredJobsAreNotRun();
+    void cancelRemovesQueuedJob();
+    void removeClientDropsItsJobs();
+    void statisticsCountQueuedJobs();
+
+private:
+    void enqueue(QTcpSocket *client, const QString &method, int id, qint64 deadlineMs = -1);
+    int queued(MCPScheduler::Priority priority) const;
+    void settle();
+
+    MCPScheduler *m_schedulerP = nullptr;
+    QTcpSocket m_clients[3];
+    QList<int> m_ran;
+    QList<int> m_expired;
+    bool m_heavyRunsAsyncB = false;
+};
+
+void tst_Scheduler::enqueue(QTcpSocket *client, const QString &method, int id, qint64 deadlineMs)
+{
+    MCPRequest request;
+    request.method = method;
+    request.id = id;
+    request.deadlineMs = deadlineMs;
+    m_schedulerP->enqueue(client, request, QByteArray());
+}
+
+int tst_Scheduler::queued(MCPScheduler::Priority priority) const
+{
+    const QJsonArray classes = m_schedulerP->statistics().value("classes").toArray();
+    return classes.at(int(priority)).toObject().value("queued").toInt();
+}
+
+void tst_Scheduler::settle()
+{
+    // The scheduler yields to the event loop after every heavy query and mutation
+    for (int pass = 0; pass < 10; ++pass) {
+        QCoreApplication::processEvents();
+    }
+}
+
+void tst_Scheduler::init()
+{
+    m_ran.clear();
+    m_expired.clear();
+    m_heavyRunsAsyncB = false;
+
+    m_schedulerP = new MCPScheduler;
+    m_schedulerP->setRunner([this](MCPScheduler::Job &job) {
+        m_ran.append(job.request.id.toInt());
+        return !(m_heavyRunsAsyncB && job.priority == MCPScheduler::Priority::HeavyQuery);
+    });
+    m_schedulerP->setExpiredHandler([this](MCPScheduler::Job &job) {
+        m_expired.append(job.request.id.toInt());
+    });
+}
+
+void tst_Scheduler::cleanup()
+{
+    delete m_schedulerP;
+    m_schedulerP = nullptr;
+}
+
+void tst_Scheduler::priorityFor_data()
+{
+    QTest::addColumn<QString>("method");
+    QTest::addColumn<MCPScheduler::Priority>("priority");
+    QTest::addColumn<QString>("name");
+
+    QTest::newRow("getVersion") << "getVersion" << MCPScheduler::Priority::Control << "control";
+    QTest::newRow("subscribe") << "subscribe" << MCPScheduler::Priority::Control << "control";
+    QTest::newRow("listProjects") << "listProjects" << MCPScheduler::Priority::CheapQuery << "cheapQuery";
+    QTest::newRow("getDiagnostics") << "getDiagnostics" << MCPScheduler::Priority::CheapQuery << "cheapQuery";
+    QTest::newRow("findFiles") << "findFiles" << MCPScheduler::Priority::HeavyQuery << "heavyQuery";
+    QTest::newRow("searchInFiles") << "searchInFiles" << MCPScheduler::Priority::HeavyQuery << "heavyQuery";
+    QTest::newRow("build") << "build" << MCPScheduler::Priority::Mutation << "mutation";
+    QTest::newRow("applyEdits") << "applyEdits" << MCPScheduler::Priority::Mutation << "mutation";
+    QTest::newRow("unknown") << "someFutureMethod" << MCPScheduler::Priority::Mutation << "mutation";
+}
+
+void tst_Scheduler::priorityFor()
+{
+    QFETCH(QString, method);
+    QFETCH(MCPScheduler::Priority, priority);
+    QFETCH(QString, name);
+
+    QCOMPARE(MCPScheduler::priorityFor(method), priority);
+    QCOMPARE(MCPScheduler::priorityName(priority), name);
+}
+
+void tst_Scheduler::classesRunInPriorityOrder()
+{
+    enqueue(&m_clients[1], "build", 1);
+    enqueue(&m_clients[0], "findFiles", 2);
+    enqueue(&m_clients[0], "listProjects", 3);
+    enqueue(&m_clients[0], "getVersion", 4);
+    settle();
+
+    QCOMPARE(m_ran, (QList<int>{4, 3, 2, 1}));
+}
+
+void tst_Scheduler::requestsDoNotOvertakeOwnMutation()
+{
+    enqueue(&m_clients[0], "listProjects", 1);
+    enqueue(&m_clients[0], "build", 2);
+    enqueue(&m_clients[0], "getVersion", 3);
+    enqueue(&m_clients[1], "getVersion", 4);
+    settle();
+
+    // Client 0's control request waits for its build; client 1 is not affected
+    QCOMPARE(m_ran, (QList<int>{4, 1, 2, 3}));
+}
+
+void tst_Scheduler::clientsAreServedRoundRobin()
+{
+    enqueue(&m_clients[0], "listProjects", 1);
+    enqueue(&m_clients[0], "listProjects", 2);
+    enqueue(&m_clients[0], "listProjects", 3);
+    enqueue(&m_clients[1], "listProjects", 4);
+    enqueue(&m_clients[1], "listProjects", 5);
+    enqueue(&m_clients[2], "listProjects", 6);
+    settle();
+
+    QCOMPARE(m_ran, (QList<int>{1, 4, 6, 2, 5, 3}));
+}
+
+void tst_Scheduler::heavyQueriesAreCapped()
+{
+    m_heavyRunsAsyncB = true;
+    QCOMPARE(MCPScheduler::MaxConcurrentHeavyJobs, 2);
+
+    enqueue(&m_clients[0], "findFiles", 1);
+    enqueue(&m_clients[1], "findFiles", 2);
+    enqueue(&m_clients[2], "findFiles", 3);
+    settle();
+
+    QCOMPARE(m_ran, (QList<int>{1, 2}));
+    QCOMPARE(m_schedulerP->statistics().value("runningHeavyJobs").toInt(), 2);
+    QCOMPARE(queued(MCPScheduler::Priority::HeavyQuery), 1);
+
+    // Other classes keep running while the heavy slots are taken
+    enqueue(&m_clients[0], "listProjects", 4);
+    settle();
+    QCOMPARE(m_ran, (QList<int>{1, 2, 4}));
+
+    m_schedulerP->jobFinished();
+    settle();
+    QCOMPARE(m_ran, (QList<int>{1, 2, 4, 3}));
+    QCOMPARE(m_schedulerP->statistics().value("runningHeavyJobs").toInt(), 2);
+
+    m_schedulerP->jobFinished();
+    m_schedulerP->jobFinished();
+    m_schedulerP->jobFinished();
+    settle();
+    QCOMPARE(m_schedulerP->statistics().value("runningHeavyJobs").toInt(), 0);
+}
+
+void tst_Scheduler::blockedJobsWait()
+{
+    bool blockedB = true;
+    m_schedulerP->setBlocker([&blockedB](const MCPScheduler::Job &job) {
+        return blockedB && job.request.method == "findFiles";
+    });
+
+    enqueue(&m_clients[0], "findFiles", 1);
+    enqueue(&m_clients[0], "listProjects", 2);
+    settle();
+    QCOMPARE(m_ran, QList<int>{2});
+
+    // Nothing is reconsidered until the blocker reports a change
+    blockedB = false;
+    settle();
+    QCOMPARE(m_ran, QList<int>{2});
+
+    m_schedulerP->unblocked();
+    settle();
+    QCOMPARE(m_ran, (QList<int>{2, 1}));
+}
+
+void tst_Scheduler::blockedMutationHoldsBackItsClient()
+{
+    bool blockedB = true;
+    m_schedulerP->setBlocker([&blockedB](const MCPScheduler::Job &job) {
+        return blockedB && job.request.method == "build";
+    });
+
+    enqueue(&m_clients[0], "build", 1);
+    enqueue(&m_clients[0], "listProjects", 2);
+    enqueue(&m_clients[1], "listProjects", 3);
+    settle();
+    QCOMPARE(m_ran, QList<int>{3});
+
+    blockedB = false;
+    m_schedulerP->unblocked();
+    settle();
+    QCOMPARE(m_ran, (QList<int>{3, 1, 2}));
+}
+
+void tst_Scheduler::expiredJobsAreNotRun()
+{
+    enqueue(&m_clients[0], "listProjects", 1, 0);
+    enqueue(&m_clients[0], "listProjects", 2, 60000);
+    enqueue(&m_clients[0], "listProjects", 3);
+    settle();
+
+    QCOMPARE(m_ran, (QList<int>{2, 3}));
+    QCOMPARE(m_expired, QList<int>{1});
+    QCOMPARE(m_schedulerP->statistics().value("expiredBeforeRun").toInteger(), qint64(1));
+}
+
+void tst_Scheduler::cancelRemovesQueuedJob()
+{
+    enqueue(&m_clients[0], "findFiles", 1);
+    enqueue(&m_clients[0], "listProjects", 2);
+    enqueue(&m_clients[1], "findFiles", 3);
+
+    // Request ids are only unique per client
+    MCPScheduler::Job job;
+    QVERIFY(!m_schedulerP->cancel(&m_clients[1], 1, job));
+    QVERIFY(m_schedulerP->cancel(&m_clients[0], 1, job));
+    QCOMPARE(job.request.method, QString("findFiles"));
+    QCOMPARE(job.owner, &m_clients[0]);
+    QVERIFY(!m_schedulerP->cancel(&m_clients[0], 1, job));
+
+    settle();
+    QCOMPARE(m_ran, (QList<int>{2, 3}));
+    QVERIFY(!m_schedulerP->cancel(&m_clients[0], 2, job));
+}
+
+void tst_Scheduler::removeClientDropsItsJobs()
+{
+    enqueue(&m_clients[0], "getVersion", 1);
+    enqueue(&m_clients[0], "build", 2);
+    enqueue(&m_clients[1], "listProjects", 3);
+    enqueue(&m_clients[0], "listProjects", 4);
+    enqueue(&m_clients[2], "listProjects", 5);
+
+    m_schedulerP->removeClient(&m_clients[0]);
+    settle();
+
+    QCOMPARE(m_ran, (QList<int>{3, 5}));
+    QVERIFY(m_expired.isEmpty());
+}
+
+void tst_Scheduler::statisticsCountQueuedJobs()
+{
+    enqueue(&m_clients[0], "getVersion", 1);
+    enqueue(&m_clients[0], "listProjects", 2);
+    enqueue(&m_clients[1], "listProjects", 3);
+    enqueue(&m_clients[0], "findFiles", 4);
+
+    QCOMPARE(queued(MCPScheduler::Priority::Control), 1);
+    QCOMPARE(queued(MCPScheduler::Priority::CheapQuery), 2);
+    QCOMPARE(queued(MCPScheduler::Priority::HeavyQuery), 1);
+    QCOMPARE(queued(MCPScheduler::Priority::Mutation), 0);
+
+    settle();
+
+    const QJsonArray classes = m_schedulerP->statistics().value("classes").toArray();
+    QCOMPARE(classes.size(), qsizetype(MCPScheduler::PriorityCount));
+    QCOMPARE(classes.at(int(MCPScheduler::Priority::CheapQuery)).toObject().value("class").toString(),
+             QString("cheapQuery"));
+    QCOMPARE(classes.at(int(MCPScheduler::Priority::CheapQuery)).toObject().value("completed").toInteger(),
+             qint64(2));
+    QCOMPARE(queued(MCPScheduler::Priority::CheapQuery), 0);
+}
+
+QTEST_GUILESS_MAIN(tst_Scheduler)
+
+#include "tst_scheduler.moc"
@@ -0,0 +1,203 @@
+#include "mcpprotocol.h"
+#include "mcpscheduler.h"
+
+#include <QJsonArray>
+#include <QTest>
+
+#include <algorithm>
+
+using namespace Qt_MCP_Plugin::Internal;
+
+class tst_SingleFlight : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void keyIgnoresMemberOrder();
+    void keyCoversMethodAndParams();
+
+    void identicalRequestsShareOneRun();
+    void emptyKeyIsNeverShared();
+    void requestBehindMutationIsNotShared();
+    void blockedRequestIsNotShared();
+
+private:
+    struct Run
+    {
+        QTcpSocket *client = nullptr;
+        QJsonValue id;
+        QList<int> sharedWith;   // ids of the requests answered from this run, sorted
+    };
+
+    static MCPRequest request(const QString &method, int id, const QJsonObject &params = {});
+    void enqueue(QTcpSocket *client, const MCPRequest &request, bool shareableB = true);
+    void settle();
+
+    MCPScheduler *m_schedulerP = nullptr;
+    QTcpSocket m_clients[3];
+    QList<Run> m_runs;
+};
+
+MCPRequest tst_SingleFlight::request(const QString &method, int id, const QJsonObject &params)
+{
+    MCPRequest request;
+    request.method = method;
+    request.id = id;
+    request.params = params;
+    return request;
+}
+
+void tst_SingleFlight::enqueue(QTcpSocket *client, const MCPRequest &request, bool shareableB)
+{
+    m_schedulerP->enqueue(client, request, shareableB ? MCPProtocol::singleFlightKey(request) : QByteArray());
+}
+
+void tst_SingleFlight::settle()
+{
+    // The scheduler yields to the event loop after every heavy query and mutation
+    for (int pass = 0; pass < 10; ++pass) {
+        QCoreApplication::processEvents();
+    }
+}
+
+void tst_SingleFlight::init()
+{
+    m_runs.clear();
+    m_schedulerP = new MCPScheduler;
+
+    // Like MCPServer::runJob(): after running a job, hand its result to the
+    // identical requests that are still queued
+    m_schedulerP->setRunner([this](MCPScheduler::Job &job) {
+        Run run;
+        run.client = job.owner;
+        run.id = job.request.id;
+        for (const MCPScheduler::Job &waiter : m_schedulerP->takeIdentical(job)) {
+            run.sharedWith.append(waiter.request.id.toInt());
+        }
+        std::sort(run.sharedWith.begin(), run.sharedWith.end());
+        m_runs.append(run);
+        return true;
+    });
+}
+
+void tst_SingleFlight::cleanup()
+{
+    delete m_schedulerP;
+    m_schedulerP = nullptr;
+}
+
+void tst_SingleFlight::keyIgnoresMemberOrder()
+{
+    MCPRequest first = request("findFiles", 1);
+    first.params = QJsonObject{{"pattern", "*.cpp"}, {"limit", 20}};
+    MCPRequest second = request("findFiles", 2);
+    second.params = QJsonObject{{"limit", 20}, {"pattern", "*.cpp"}};
+
+    // The id is not part of the key
+    QCOMPARE(MCPProtocol::singleFlightKey(first), MCPProtocol::singleFlightKey(second));
+
+    MCPRequest decoded;
+    int code = 0;
+    QString errorMessage;
+    QVERIFY(MCPProtocol::decodeRequest(
+        R"({"jsonrpc":"2.0","id":3,"method":"findFiles","params":{"limit":20,"pattern":"*.cpp"}})",
+        decoded, code, errorMessage));
+    QCOMPARE(MCPProtocol::singleFlightKey(decoded), MCPProtocol::singleFlightKey(first));
+}
+
+void tst_SingleFlight::keyCoversMethodAndParams()
+{
+    const QByteArray key = MCPProtocol::singleFlightKey(request("findFiles", 1, {{"pattern", "*.cpp"}}));
+    QVERIFY(!key.isEmpty());
+    QVERIFY(key != MCPProtocol::singleFlightKey(request("findFiles", 1, {{"pattern", "*.h"}})));
+    QVERIFY(key != MCPProtocol::singleFlightKey(request("findFiles", 1, {{"pattern", "*.cpp"}, {"limit", 5}})));
+    QVERIFY(key != MCPProtocol::singleFlightKey(request("readDocument", 1, {{"pattern", "*.cpp"}})));
+    QVERIFY(MCPProtocol::singleFlightKey(request("listProjects", 1))
+            != MCPProtocol::singleFlightKey(request("listProjects", 1, {{"limit", QJsonValue::Null}})));
+
+    // Request controls sent inside params do not change the result
+    QCOMPARE(MCPProtocol::singleFlightKey(request("listIssues", 1, {{"deadlineMs", 5000}})),
+             MCPProtocol::singleFlightKey(request("listIssues", 2, {{"deadlineMs", 30000}})));
+    QCOMPARE(MCPProtocol::singleFlightKey(request("listIssues", 1, {{"afterParse", true}})),
+             MCPProtocol::singleFlightKey(request("listIssues", 2)));
+    QCOMPARE(MCPProtocol::singleFlightKey(request("findFiles", 1, {{"pattern", "*.cpp"}, {"deadlineMs", 100},
+                                                                   {"afterParse", false}})),
+             key);
+}
+
+void tst_SingleFlight::identicalRequestsShareOneRun()
+{
+    enqueue(&m_clients[0], request("findFiles", 1, {{"pattern", "*.cpp"}}));
+    enqueue(&m_clients[1], request("findFiles", 2, {{"pattern", "*.cpp"}}));
+    enqueue(&m_clients[1], request("findFiles", 3, {{"pattern", "*.h"}}));
+    enqueue(&m_clients[2], request("findFiles", 4, {{"pattern", "*.cpp"}}));
+    enqueue(&m_clients[0], request("findFiles", 5, {{"pattern", "*.cpp"}}));
+    settle();
+
+    QCOMPARE(m_runs.size(), 2);
+    QCOMPARE(m_runs.at(0).id, QJsonValue(1));
+    QCOMPARE(m_runs.at(0).sharedWith, (QList<int>{2, 4, 5}));
+    QCOMPARE(m_runs.at(1).id, QJsonValue(3));
+    QVERIFY(m_runs.at(1).sharedWith.isEmpty());
+
+    // Shared requests are accounted as served by the scheduler
+    const QJsonArray classes = m_schedulerP->statistics().value("classes").toArray();
+    const QJsonObject heavy = classes.at(int(MCPScheduler::Priority::HeavyQuery)).toObject();
+    QCOMPARE(heavy.value("completed").toInteger(), qint64(5));
+    QCOMPARE(heavy.value("queued").toInt(), 0);
+}
+
+void tst_SingleFlight::emptyKeyIsNeverShared()
+{
+    enqueue(&m_clients[0], request("listProjects", 1), false);
+    enqueue(&m_clients[1], request("listProjects", 2), false);
+    settle();
+
+    QCOMPARE(m_runs.size(), 2);
+    QVERIFY(m_runs.at(0).sharedWith.isEmpty());
+    QVERIFY(m_runs.at(1).sharedWith.isEmpty());
+}
+
+void tst_SingleFlight::requestBehindMutationIsNotShared()
+{
+    // Client 0's query was sent after its own mutation, so it must see the
+    // mutation's effect and cannot take a result computed before it
+    enqueue(&m_clients[0], request("build", 1), false);
+    enqueue(&m_clients[0], request("listProjects", 2));
+    enqueue(&m_clients[1], request("listProjects", 3));
+    settle();
+
+    QCOMPARE(m_runs.size(), 3);
+    QCOMPARE(m_runs.at(0).id, QJsonValue(3));
+    QVERIFY(m_runs.at(0).sharedWith.isEmpty());
+    QCOMPARE(m_runs.at(1).id, QJsonValue(1));
+    QCOMPARE(m_runs.at(2).id, QJsonValue(2));
+}
+
+void tst_SingleFlight::blockedRequestIsNotShared()
+{
+    m_schedulerP->setBlocker([](const MCPScheduler::Job &job) {
+        return job.request.id == QJsonValue(2);
+    });
+
+    enqueue(&m_clients[0], request("listProjects", 1));
+    enqueue(&m_clients[1], request("listProjects", 2));
+    settle();
+
+    QCOMPARE(m_runs.size(), 1);
+    QVERIFY(m_runs.at(0).sharedWith.isEmpty());
+
+    m_schedulerP->setBlocker({});
+    m_schedulerP->unblocked();
+    settle();
+
+    QCOMPARE(m_runs.size(), 2);
+    QCOMPARE(m_runs.at(1).id, QJsonValue(2));
+}
+
+QTEST_GUILESS_MAIN(tst_SingleFlight)
+
+#include "tst_singleflight.moc"
@@ -0,0 +1,150 @@
+#include "mcptextmatcher.h"
+
+#include <QTest>
+
+using namespace Qt_MCP_Plugin::Internal;
+
+class tst_TextMatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void literal();
+    void caseSensitivity();
+    void regex();
+    void emptyPatternMatchesNothing();
+    void lines_data();
+    void lines();
+    void longLinesAreCut();
+    void fileNames_data();
+    void fileNames();
+
+private:
+    static MCPTextMatcher::Matches search(const MCPTextMatcher &matcher, const QString &text);
+};
+
+MCPTextMatcher::Matches tst_TextMatcher::search(const MCPTextMatcher &matcher, const QString &text)
+{
+    MCPTextMatcher::Matches matches;
+    matcher.searchText(text, "/src/main.cpp", matches);
+    return matches;
+}
+
+void tst_TextMatcher::literal()
+{
+    const MCPTextMatcher matcher("foo", false, true);
+    const MCPTextMatcher::Matches matches = search(matcher, "foo(foo);\nbar();\n  foofoo\n");
+
+    QCOMPARE(matches.size(), qsizetype(4));
+    QCOMPARE(matches.at(0).file, QString("/src/main.cpp"));
+    QCOMPARE(matches.at(0).line, 1);
+    QCOMPARE(matches.at(0).column, 0);
+    QCOMPARE(matches.at(0).length, 3);
+    QCOMPARE(matches.at(0).text, QString("foo(foo);"));
+    QCOMPARE(matches.at(1).column, 4);
+
+    // Occurrences do not overlap and line numbers count every line
+    QCOMPARE(matches.at(2).line, 3);
+    QCOMPARE(matches.at(2).column, 2);
+    QCOMPARE(matches.at(3).column, 5);
+    QCOMPARE(search(MCPTextMatcher("aa", false, true), "aaaa").size(), qsizetype(2));
+
+    // Regex characters in a literal pattern are plain text
+    QCOMPARE(search(MCPTextMatcher("a.b", false, true), "axb a.b").size(), qsizetype(1));
+}
+
+void tst_TextMatcher::caseSensitivity()
+{
+    const QString text = "Widget widget WIDGET";
+    QCOMPARE(search(MCPTextMatcher("widget", false, false), text).size(), qsizetype(3));
+    QCOMPARE(search(MCPTextMatcher("widget", false, true), text).size(), qsizetype(1));
+    QCOMPARE(search(MCPTextMatcher("w[a-z]+", true, false), text).size(), qsizetype(3));
+    QCOMPARE(search(MCPTextMatcher("w[a-z]+", true, true), text).size(), qsizetype(1));
+}
+
+void tst_TextMatcher::regex()
+{
+    const MCPTextMatcher matcher("\\bint (\\w+)", true, true);
+    const MCPTextMatcher::Matches matches = search(matcher, "int a; int bc;\nprint x;\n");
+    QCOMPARE(matches.size(), qsizetype(2));
+    QCOMPARE(matches.at(0).column, 0);
+    QCOMPARE(matches.at(0).length, 5);
+    QCOMPARE(matches.at(1).column, 7);
+    QCOMPARE(matches.at(1).length, 6);
+
+    // Regular expressions see one line at a time
+    QVERIFY(search(MCPTextMatcher("a\\nb", true, true), "a\nb\n").isEmpty());
+    QCOMPARE(search(MCPTextMatcher("b$", true, true), "ab\r\nb\n").size(), qsizetype(2));
+}
+
+void tst_TextMatcher::emptyPatternMatchesNothing()
+{
+    QVERIFY(search(MCPTextMatcher(QString(), false, false), "text\n").isEmpty());
+}
+
+void tst_TextMatcher::lines_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<QList<int>>("lines");
+    QTest::addColumn<int>("emptyLines");
+
+    QTest::newRow("empty") << "" << QList<int>{} << 0;
+    QTest::newRow("one line") << "a" << QList<int>{1} << 0;
+    QTest::newRow("trailing newline") << "a\n" << QList<int>{1} << 0;
+    QTest::newRow("no trailing newline") << "a\nb" << QList<int>{1, 2} << 0;
+    QTest::newRow("empty lines") << "\n\n" << QList<int>{1, 2} << 2;
+    QTest::newRow("crlf") << "a\r\nb\r\n" << QList<int>{1, 2} << 0;
+    QTest::newRow("empty last line") << "a\n\n" << QList<int>{1, 2} << 1;
+}
+
+void tst_TextMatcher::lines()
+{
+    QFETCH(QString, text);
+    QFETCH(QList<int>, lines);
+    QFETCH(int, emptyLines);
+
+    // "^" matches once on every line there is, and none past the end of the text
+    QList<int> found;
+    for (const MCPTextMatcher::Match &match : search(MCPTextMatcher("^", true, false), text)) {
+        found.append(match.line);
+    }
+    QCOMPARE(found, lines);
+    QCOMPARE(search(MCPTextMatcher("^$", true, false), text).size(), qsizetype(emptyLines));
+}
+
+void tst_TextMatcher::longLinesAreCut()
+{
+    const QString line = QString(1000, 'x') + "needle";
+    const MCPTextMatcher::Matches matches = search(MCPTextMatcher("needle", false, false), line);
+    QCOMPARE(matches.size(), qsizetype(1));
+    QCOMPARE(matches.at(0).column, 1000);
+    QCOMPARE(matches.at(0).text, QString(MCPTextMatcher::MaxLineLength, 'x'));
+}
+
+void tst_TextMatcher::fileNames_data()
+{
+    QTest::addColumn<QStringList>("filePatterns");
+    QTest::addColumn<QString>("path");
+    QTest::addColumn<bool>("matches");
+
+    QTest::newRow("no patterns") << QStringList() << "/src/main.cpp" << true;
+    QTest::newRow("extension") << QStringList{"*.cpp"} << "/src/main.cpp" << true;
+    QTest::newRow("other extension") << QStringList{"*.cpp"} << "/src/main.h" << false;
+    QTest::newRow("any pattern") << QStringList{"*.h", "*.cpp"} << "/src/main.cpp" << true;
+    QTest::newRow("case") << QStringList{"*.CPP"} << "/src/main.cpp" << true;
+    QTest::newRow("name only") << QStringList{"src*"} << "/src/main.cpp" << false;
+    QTest::newRow("relative path") << QStringList{"main.*"} << "main.cpp" << true;
+}
+
+void tst_TextMatcher::fileNames()
+{
+    QFETCH(QStringList, filePatterns);
+    QFETCH(QString, path);
+    QFETCH(bool, matches);
+
+    QCOMPARE(MCPTextMatcher("x", false, false, filePatterns).matchesFileName(path), matches);
+}
+
+QTEST_GUILESS_MAIN(tst_TextMatcher)
+
+#include "tst_textmatcher.moc"